@@ -0,0 +1,45 @@
+# Find the Graphviz libraries used to render graphs in-process
+#
+#  GRAPHVIZ_FOUND - system has the Graphviz libraries
+#  GRAPHVIZ_INCLUDE_DIR - the Graphviz include directory
+#  GRAPHVIZ_LIBRARIES - the libraries needed to use Graphviz (gvc and cgraph)
+
+if(GRAPHVIZ_INCLUDE_DIR AND GRAPHVIZ_LIBRARIES)
+    # Already in cache, be silent
+    set(Graphviz_FIND_QUIETLY TRUE)
+endif(GRAPHVIZ_INCLUDE_DIR AND GRAPHVIZ_LIBRARIES)
+
+find_package(PkgConfig)
+if (PKG_CONFIG_FOUND)
+  pkg_check_modules(_GRAPHVIZ libgvc)
+endif (PKG_CONFIG_FOUND)
+
+FIND_PATH(GRAPHVIZ_INCLUDE_DIR gvc.h
+  PATHS ${_GRAPHVIZ_INCLUDE_DIRS}
+  PATH_SUFFIXES graphviz)
+
+FIND_LIBRARY(GRAPHVIZ_GVC_LIBRARY NAMES gvc PATHS ${_GRAPHVIZ_LIBRARY_DIRS})
+FIND_LIBRARY(GRAPHVIZ_CGRAPH_LIBRARY NAMES cgraph PATHS ${_GRAPHVIZ_LIBRARY_DIRS})
+
+IF(GRAPHVIZ_INCLUDE_DIR AND GRAPHVIZ_GVC_LIBRARY AND GRAPHVIZ_CGRAPH_LIBRARY)
+   SET(GRAPHVIZ_FOUND TRUE)
+   SET(GRAPHVIZ_LIBRARIES ${GRAPHVIZ_GVC_LIBRARY} ${GRAPHVIZ_CGRAPH_LIBRARY})
+ELSE()
+   SET(GRAPHVIZ_FOUND FALSE)
+ENDIF()
+
+IF(GRAPHVIZ_FOUND)
+   IF(NOT Graphviz_FIND_QUIETLY)
+      MESSAGE(STATUS "Found Graphviz: ${GRAPHVIZ_LIBRARIES}")
+   ENDIF(NOT Graphviz_FIND_QUIETLY)
+ELSE(GRAPHVIZ_FOUND)
+   IF(Graphviz_FIND_REQUIRED)
+      MESSAGE(FATAL_ERROR "Could not find the Graphviz libraries (gvc and cgraph)")
+   ENDIF(Graphviz_FIND_REQUIRED)
+   IF(NOT Graphviz_FIND_QUIETLY)
+      MESSAGE(STATUS "Could not find the Graphviz libraries")
+   ENDIF(NOT Graphviz_FIND_QUIETLY)
+ENDIF(GRAPHVIZ_FOUND)
+
+# show the GRAPHVIZ_INCLUDE_DIR and GRAPHVIZ_LIBRARIES variables only in the advanced view
+MARK_AS_ADVANCED(GRAPHVIZ_INCLUDE_DIR GRAPHVIZ_GVC_LIBRARY GRAPHVIZ_CGRAPH_LIBRARY GRAPHVIZ_LIBRARIES)
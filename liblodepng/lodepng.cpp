@@ -2027,7 +2027,7 @@ static void filterScanline(unsigned char* out, const unsigned char* scanline, co
   }
 }
 
-static unsigned filter(unsigned char* out, const unsigned char* in, unsigned w, unsigned h, const LodePNG_InfoColor* info)
+static unsigned filter(unsigned char* out, const unsigned char* in, unsigned w, unsigned h, const LodePNG_InfoColor* info, unsigned paletteFilter)
 {
   /*
   For PNG filter method 0
@@ -2038,6 +2038,8 @@ static unsigned filter(unsigned char* out, const unsigned char* in, unsigned w,
    * (The other case) If the image type is Grayscale or RGB (with or without Alpha), and the bit depth is not smaller than 8, then use adaptive filtering heuristic as follows: independently for each row, apply all five filters and select the filter that produces the smallest sum of absolute values per row.
 
   Here the above method is used mostly. Note though that it appears to be better to use the adaptive filtering on the plasma 8-bit palette example, but that image isn't the best reference for palette images in general.
+
+  If paletteFilter is set, palette images with 8 bit indices choose per scanline between the None, Sub and Up filters instead, whichever result changes value between neighbouring bytes the least often. The averaging of the Average and Paeth filters means nothing for palette indices, while Sub and Up turn pixels that repeat the one to their left or above them into runs of zeros, which LZ77 compresses well for images with large areas of the same color.
   */
 
   unsigned bpp = LodePNG_InfoColor_getBpp(info);
@@ -2051,7 +2053,8 @@ static unsigned filter(unsigned char* out, const unsigned char* in, unsigned w,
   if(bpp == 0) return 31; /*invalid color type*/
 
   /*choose heuristic as described above*/
-  if(info->colorType == 3 || info->bitDepth < 8) heuristic = 0;
+  if(paletteFilter && info->colorType == 3 && info->bitDepth == 8) heuristic = 2;
+  else if(info->colorType == 3 || info->bitDepth < 8) heuristic = 0;
   else heuristic = 1;
 
   if(heuristic == 0) /*None filtertype for everything*/
@@ -2110,6 +2113,39 @@ static unsigned filter(unsigned char* out, const unsigned char* in, unsigned w,
 
     for(type = 0; type < 5; type++) ucvector_cleanup(&attempt[type]);
   }
+  else if(heuristic == 2) /*palette filtering: None, Sub or Up, fewest changes between neighbouring bytes wins*/
+  {
+    size_t changes[3];
+    ucvector attempt[3];
+    unsigned type, bestType = 0;
+
+    for(type = 0; type < 3; type++) ucvector_init(&attempt[type]);
+    for(type = 0; type < 3; type++)
+    {
+      if(!ucvector_resize(&attempt[type], linebytes)) { error = 9949; break; }
+    }
+
+    if(!error)
+    {
+      for(y = 0; y < h; y++)
+      {
+        for(type = 0; type < 3; type++)
+        {
+          filterScanline(attempt[type].data, &in[y * linebytes], prevline, linebytes, bytewidth, type);
+          changes[type] = 0;
+          for(x = 1; x < linebytes; x++) changes[type] += (attempt[type].data[x] != attempt[type].data[x - 1]);
+          if(type == 0 || changes[type] < changes[bestType]) bestType = type;
+        }
+
+        prevline = &in[y * linebytes];
+
+        out[y * (linebytes + 1)] = bestType;
+        for(x = 0; x < linebytes; x++) out[y * (linebytes + 1) + 1 + x] = attempt[bestType].data[x];
+      }
+    }
+
+    for(type = 0; type < 3; type++) ucvector_cleanup(&attempt[type]);
+  }
 
   return error;
 }
@@ -2184,7 +2220,7 @@ static void Adam7_interlace(unsigned char* out, const unsigned char* in, unsigne
 }
 
 /*out must be buffer big enough to contain uncompressed IDAT chunk data, and in must contain the full image*/
-static unsigned preProcessScanlines(unsigned char** out, size_t* outsize, const unsigned char* in, const LodePNG_InfoPng* infoPng) /*return value is error*/
+static unsigned preProcessScanlines(unsigned char** out, size_t* outsize, const unsigned char* in, const LodePNG_InfoPng* infoPng, unsigned paletteFilter) /*return value is error*/
 {
   /*
   This function converts the pure 2D image with the PNG's colortype, into filtered-padded-interlaced data. Steps:
@@ -2212,11 +2248,11 @@ static unsigned preProcessScanlines(unsigned char** out, size_t* outsize, const
         if(!error)
         {
           addPaddingBits(padded.data, in, ((w * bpp + 7) / 8) * 8, w * bpp, h);
-          error = filter(*out, padded.data, w, h, &infoPng->color);
+          error = filter(*out, padded.data, w, h, &infoPng->color, paletteFilter);
         }
         ucvector_cleanup(&padded);
       }
-      else error = filter(*out, in, w, h, &infoPng->color); /*we can immediately filter into the out buffer, no other steps needed*/
+      else error = filter(*out, in, w, h, &infoPng->color, paletteFilter); /*we can immediately filter into the out buffer, no other steps needed*/
     }
   }
   else /*interlaceMethod is 1 (Adam7)*/
@@ -2247,14 +2283,14 @@ static unsigned preProcessScanlines(unsigned char** out, size_t* outsize, const
           if(!error)
           {
             addPaddingBits(&padded.data[padded_passstart[i]], &adam7[passstart[i]], ((passw[i] * bpp + 7) / 8) * 8, passw[i] * bpp, passh[i]);
-            error = filter(&(*out)[filter_passstart[i]], &padded.data[padded_passstart[i]], passw[i], passh[i], &infoPng->color);
+            error = filter(&(*out)[filter_passstart[i]], &padded.data[padded_passstart[i]], passw[i], passh[i], &infoPng->color, paletteFilter);
           }
 
           ucvector_cleanup(&padded);
         }
         else
         {
-          error = filter(&(*out)[filter_passstart[i]], &adam7[padded_passstart[i]], passw[i], passh[i], &infoPng->color);
+          error = filter(&(*out)[filter_passstart[i]], &adam7[padded_passstart[i]], passw[i], passh[i], &infoPng->color, paletteFilter);
         }
       }
 
@@ -2355,10 +2391,10 @@ void LodePNG_encode(LodePNG_Encoder* encoder, unsigned char** out, size_t* outsi
     converted = (unsigned char*)malloc(size);
     if(!converted && size) encoder->error = 9955; /*error: malloc failed*/
     if(!encoder->error) encoder->error = LodePNG_convert(converted, image, &info.color, &encoder->infoRaw.color, w, h);
-    if(!encoder->error) preProcessScanlines(&data, &datasize, converted, &info);/*filter(data.data, converted.data, w, h, LodePNG_InfoColor_getBpp(&info.color));*/
+    if(!encoder->error) preProcessScanlines(&data, &datasize, converted, &info, encoder->settings.paletteFilter);/*filter(data.data, converted.data, w, h, LodePNG_InfoColor_getBpp(&info.color));*/
     free(converted);
   }
-  else preProcessScanlines(&data, &datasize, image, &info);/*filter(data.data, image, w, h, LodePNG_InfoColor_getBpp(&info.color));*/
+  else preProcessScanlines(&data, &datasize, image, &info, encoder->settings.paletteFilter);/*filter(data.data, image, w, h, LodePNG_InfoColor_getBpp(&info.color));*/
 
   ucvector_init(&outv);
   while(!encoder->error) /*not really a while loop, this is only used to break out if an error happens to avoid goto's to do the ucvector cleanup*/
@@ -2401,6 +2437,7 @@ void LodePNG_EncodeSettings_init(LodePNG_EncodeSettings* settings)
   LodeZlib_DeflateSettings_init(&settings->zlibsettings);
   settings->autoLeaveOutAlphaChannel = 1;
   settings->force_palette = 0;
+  settings->paletteFilter = 0;
 }
 
 void LodePNG_Encoder_init(LodePNG_Encoder* encoder)
@@ -95,6 +95,7 @@ typedef struct LodePNG_EncodeSettings
 
   unsigned autoLeaveOutAlphaChannel; /*automatically use color type without alpha instead of given one, if given image is opaque*/
   unsigned force_palette; /*force creating a PLTE chunk if colortype is 2 or 6 (= a suggested palette). If colortype is 3, PLTE is _always_ created.*/
+  unsigned paletteFilter; /*filter each scanline of an 8 bit palette image with None, Sub or Up, whichever gives the longest runs of equal bytes, instead of always None*/
 } LodePNG_EncodeSettings;
 
 void LodePNG_EncodeSettings_init(LodePNG_EncodeSettings* settings);
@@ -54,6 +54,11 @@ class BufStr
       makeRoomFor(s);
       m_writeOffset+=s;
     }
+    /** Empties the buffer but keeps its memory, so it can be reused */
+    void clear()
+    {
+      m_writeOffset=0;
+    }
     void shrink( uint newlen )
     {
       m_writeOffset=newlen;
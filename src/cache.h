@@ -16,97 +16,126 @@
 #ifndef CACHE_H
 #define CACHE_H
 
-#include <list>
+#include <algorithm>
+#include <vector>
 #include <unordered_map>
+#include <functional>
 #include <mutex>
+#include <memory>
 #include <ctype.h>
 
 /*! Fixed size cache for value type V using keys of type K.
  *
- *  When the maximum capacity has reached, the least recently used value is removed from the cache
- *  (LRU strategy).
+ *  The cache can be used from multiple threads at the same time. The keys are
+ *  distributed over a number of shards, each protected by its own mutex, so
+ *  threads looking up different keys rarely have to wait for each other.
+ *
+ *  When the maximum capacity of a shard has been reached, a value is evicted
+ *  using the CLOCK strategy (an approximation of least recently used): each
+ *  value has a reference bit that is set when it is found, and the clock hand
+ *  skips (and clears) referenced values until it finds one that was not used
+ *  since the last time the hand passed it.
  */
 template<typename K,typename V>
 class Cache
 {
   public:
-    using kv_pair        = std::pair<K,V>;
-    using iterator       = typename std::list<kv_pair>::iterator;
-    using const_iterator = typename std::list<kv_pair>::const_iterator;
-
     //! creates a cache that can hold \a capacity elements
     Cache(size_t capacity) : m_capacity(capacity)
     {
+      size_t shardCapacity = std::max<size_t>(1,(capacity+NumShards-1)/NumShards);
+      for (size_t i=0;i<NumShards;i++)
+      {
+        m_shards.push_back(std::make_unique<Shard>(shardCapacity));
+      }
     }
 
-    //! Inserts \a value under \a key in the cache
-    V *insert(const K &key,V &&value)
-    {
-      // remove item if it already exists
-      remove(key);
-      // store new item
-      m_cacheItemList.push_front(kv_pair(key,std::move(value)));
-      V *result = &m_cacheItemList.front().second;
-      m_cacheItemMap[key] = m_cacheItemList.begin();
-      // remove least recently used item if cache is full
-      resize();
-      return result;
-    }
-
-    //! Inserts \a value under \a key in the cache
-    V *insert(const K &key,const V &value)
-    {
-      // remove item if it already exists
-      remove(key);
-      // store new item
-      m_cacheItemList.push_front(kv_pair(key,value));
-      V *result = &m_cacheItemList.front().second;
-      m_cacheItemMap[key] = m_cacheItemList.begin();
-      // remove least recently used item if cache is full
-      resize();
-      return result;
+    //! Inserts \a value under \a key in the cache, replacing any existing value.
+    void insert(const K &key,V value)
+    {
+      Shard &s = shard(key);
+      std::unique_lock<std::mutex> lock = s.lock();
+      s.insert(key,std::move(value));
     }
 
     //! Removes entry \a key from the cache.
-    //! \note this invalidates any iterators
     void remove(const K &key)
     {
-      // remove item if it already exists
-      auto it = m_cacheItemMap.find(key);
-      if (it != m_cacheItemMap.end())
+      Shard &s = shard(key);
+      std::unique_lock<std::mutex> lock = s.lock();
+      auto it = s.map.find(key);
+      if (it!=s.map.end())
+      {
+        s.release(it->second);
+        s.map.erase(it);
+      }
+    }
+
+    //! Removes all entries for which \a pred returns TRUE.
+    void removeIf(const std::function<bool(const K &,const V &)> &pred)
+    {
+      for (auto &sp : m_shards)
       {
-        m_cacheItemList.erase(it->second);
-        m_cacheItemMap.erase(it);
+        Shard &s = *sp;
+        std::unique_lock<std::mutex> lock = s.lock();
+        for (size_t i=0;i<s.slots.size();i++)
+        {
+          Slot &slot = s.slots[i];
+          if (slot.used && pred(slot.key,slot.value))
+          {
+            s.map.erase(slot.key);
+            s.release(i);
+          }
+        }
       }
     }
 
     //! Finds a value in the cache given the corresponding \a key.
-    //! @returns a pointer to the value or nullptr if the key is not found in the cache
+    //! @returns TRUE if the key was found, in which case its value is copied into \a value.
     //! @note The hit and miss counters are updated, see hits() and misses().
-    V *find(const K &key)
+    bool find(const K &key,V &value)
     {
-      auto it = m_cacheItemMap.find(key);
-      if (it != m_cacheItemMap.end())
+      Shard &s = shard(key);
+      std::unique_lock<std::mutex> lock = s.lock();
+      auto it = s.map.find(key);
+      if (it!=s.map.end())
       {
-        // move the item to the front of the list
-        m_cacheItemList.splice(m_cacheItemList.begin(),
-                               m_cacheItemList,
-                               it->second);
-        m_hits++;
-        // return the value
-        return &it->second->second;
+        Slot &slot = s.slots[it->second];
+        slot.referenced = true;
+        value = slot.value;
+        s.hits++;
+        return true;
       }
-      else
+      s.misses++;
+      return false;
+    }
+
+    //! Finds a value in the cache given the corresponding \a key. If the key
+    //! is not found, \a value is inserted under \a key instead.
+    //! @returns TRUE if the key was found, in which case its value is copied into \a value.
+    //! @note The hit and miss counters are updated, see hits() and misses().
+    bool findOrInsert(const K &key,V &value)
+    {
+      Shard &s = shard(key);
+      std::unique_lock<std::mutex> lock = s.lock();
+      auto it = s.map.find(key);
+      if (it!=s.map.end())
       {
-        m_misses++;
+        Slot &slot = s.slots[it->second];
+        slot.referenced = true;
+        value = slot.value;
+        s.hits++;
+        return true;
       }
-      return nullptr;
+      s.misses++;
+      s.insert(key,value);
+      return false;
     }
 
     //! Returns the number of values stored in the cache.
     size_t size() const
     {
-      return m_cacheItemMap.size();
+      return sum([](const Shard &s) { return s.map.size(); });
     }
 
     //! Returns the maximum number of values that can be stored in the cache.
@@ -118,45 +147,153 @@ class Cache
     //! Returns how many of the find() calls did find a value in the cache.
     uint64_t hits() const
     {
-      return m_hits;
+      return sum([](const Shard &s) { return s.hits; });
     }
 
     //! Returns how many of the find() calls did not found a value in the cache.
     uint64_t misses() const
     {
-      return m_misses;
+      return sum([](const Shard &s) { return s.misses; });
+    }
+
+    //! Returns how many times a thread had to wait for another thread to access the cache.
+    uint64_t contention() const
+    {
+      return sum([](const Shard &s) { return s.contention; });
     }
 
     //! Clears all values in the cache.
     void clear()
     {
-      m_cacheItemMap.clear();
-      m_cacheItemList.clear();
+      for (auto &sp : m_shards)
+      {
+        Shard &s = *sp;
+        std::unique_lock<std::mutex> lock = s.lock();
+        s.map.clear();
+        s.slots.clear();
+        s.freeSlots.clear();
+        s.hand = 0;
+      }
     }
 
-    iterator begin()             { return m_cacheItemList.begin();  }
-    iterator end()               { return m_cacheItemList.end();    }
-    const_iterator begin() const { return m_cacheItemList.cbegin(); }
-    const_iterator end() const   { return m_cacheItemList.cend();   }
-
   private:
-    void resize()
+    static const size_t NumShards = 64;
+
+    struct Slot
+    {
+      K    key;
+      V    value;
+      bool used       = false;
+      bool referenced = false;
+    };
+
+    struct Shard
     {
-      if (m_cacheItemMap.size() > m_capacity)
+      Shard(size_t cap) : capacity(cap) {}
+
+      std::unique_lock<std::mutex> lock()
+      {
+        std::unique_lock<std::mutex> l(mutex,std::try_to_lock);
+        if (!l.owns_lock())
+        {
+          l.lock();
+          contention++;
+        }
+        return l;
+      }
+
+      void insert(const K &key,V value)
+      {
+        auto it = map.find(key);
+        if (it!=map.end()) // update existing item
+        {
+          Slot &slot = slots[it->second];
+          slot.value = std::move(value);
+          slot.referenced = true;
+          return;
+        }
+        size_t index;
+        if (!freeSlots.empty()) // reuse a slot of a removed item
+        {
+          index = freeSlots.back();
+          freeSlots.pop_back();
+        }
+        else if (slots.size()<capacity) // shard not yet full
+        {
+          index = slots.size();
+          slots.emplace_back();
+        }
+        else // evict an item that was not recently used
+        {
+          index = evict();
+        }
+        Slot &slot = slots[index];
+        slot.key        = key;
+        slot.value      = std::move(value);
+        slot.used       = true;
+        slot.referenced = false;
+        map.insert(std::make_pair(key,index));
+      }
+
+      // advances the clock hand to a slot that can be reused and returns its index
+      size_t evict()
       {
-        auto last_it = m_cacheItemList.end();
-        --last_it;
-        m_cacheItemMap.erase(last_it->first);
-        m_cacheItemList.pop_back();
+        while (true)
+        {
+          Slot &slot = slots[hand];
+          size_t index = hand;
+          hand = (hand+1)%slots.size();
+          if (slot.used && !slot.referenced)
+          {
+            map.erase(slot.key);
+            return index;
+          }
+          slot.referenced = false;
+        }
       }
+
+      void release(size_t index)
+      {
+        Slot &slot = slots[index];
+        slot.used       = false;
+        slot.referenced = false;
+        slot.key        = K();
+        slot.value      = V();
+        freeSlots.push_back(index);
+      }
+
+      std::mutex mutex;
+      size_t capacity;
+      std::vector<Slot> slots;
+      std::vector<size_t> freeSlots;
+      std::unordered_map<K,size_t> map;
+      size_t hand = 0;
+      uint64_t hits = 0;
+      uint64_t misses = 0;
+      uint64_t contention = 0;
+    };
+
+    Shard &shard(const K &key)
+    {
+      // mix in the high bits, since the low bits also select the bucket inside the shard
+      size_t h = std::hash<K>()(key);
+      return *m_shards[(h ^ (h>>17) ^ (h>>31)) % NumShards];
     }
+
+    template<class F>
+    uint64_t sum(F value) const
+    {
+      uint64_t result = 0;
+      for (const auto &sp : m_shards)
+      {
+        std::lock_guard<std::mutex> lock(sp->mutex);
+        result += value(*sp);
+      }
+      return result;
+    }
+
     size_t m_capacity;
-    // list of items in the cache, sorted by most to least recently used.
-    std::list<kv_pair> m_cacheItemList;
-    // mapping for each key to a place in the list where item is found
-    std::unordered_map<K,iterator> m_cacheItemMap;
-    uint64_t m_hits=0;
-    uint64_t m_misses=0;
+    std::vector< std::unique_ptr<Shard> > m_shards;
 };
 
 #endif
@@ -37,6 +37,7 @@
 #include "defargs.h"
 #include "debug.h"
 #include "docparser.h"
+#include "docrootcache.h"
 #include "searchindex.h"
 #include "vhdldocgen.h"
 #include "layout.h"
@@ -2433,20 +2434,19 @@ void ClassDefImpl::writeDeclarationLink(OutputList &ol,bool &found,const char *h
     // add the brief description if available
     if (!briefDescription().isEmpty() && Config_getBool(BRIEF_MEMBER_DESC))
     {
-      DocRoot *rootNode = validatingParseDoc(briefFile(),briefLine(),this,0,
+      std::shared_ptr<DocRoot> rootNode = DocRootCache::instance().parse(briefFile(),briefLine(),this,0,
                                 briefDescription(),FALSE,FALSE,
                                 0,TRUE,FALSE,Config_getBool(MARKDOWN_SUPPORT));
       if (rootNode && !rootNode->isEmpty())
       {
         ol.startMemberDescription(anchor());
-        ol.writeDoc(rootNode,this,0);
+        ol.writeDoc(rootNode.get(),this,0);
         if (isLinkableInProject())
         {
           writeMoreLink(ol,anchor());
         }
         ol.endMemberDescription();
       }
-      delete rootNode;
     }
     ol.endMemberDeclaration(anchor(),0);
   }
@@ -0,0 +1,482 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+
+#include "md5.h"
+
+#include "coderecorder.h"
+#include "config.h"
+#include "message.h"
+#include "trace.h"
+
+//---------------------------------------------------------------------------
+
+enum CodeOp
+{
+  Op_Codify = 1,
+  Op_CodeLink,
+  Op_LineNumber,
+  Op_Tooltip,
+  Op_StartCodeLine,
+  Op_EndCodeLine,
+  Op_StartFontClass,
+  Op_EndFontClass,
+  Op_CodeAnchor,
+  Op_SetCurrentDoc,
+  Op_AddWord,
+  Op_StartCodeFragment,
+  Op_EndCodeFragment
+};
+
+void CodeRecorder::putOp(int op)
+{
+  m_data+=static_cast<char>(op);
+}
+
+void CodeRecorder::putInt(int value)
+{
+  // zig-zag encoding keeps small negative numbers (like -1) small
+  uint32_t v = (static_cast<uint32_t>(value)<<1) ^ static_cast<uint32_t>(value>>31);
+  while (v>=0x80)
+  {
+    m_data+=static_cast<char>((v&0x7f)|0x80);
+    v>>=7;
+  }
+  m_data+=static_cast<char>(v);
+}
+
+void CodeRecorder::putText(const char *s)
+{
+  if (s==0)
+  {
+    putInt(0);
+    return;
+  }
+  size_t len = strlen(s);
+  putInt(static_cast<int>(len)+1);
+  m_data.append(s,len);
+}
+
+void CodeRecorder::putString(const char *s)
+{
+  if (s==0)
+  {
+    putInt(0);
+    return;
+  }
+  auto it = m_stringIndex.find(s);
+  if (it==m_stringIndex.end())
+  {
+    it = m_stringIndex.insert(std::make_pair(std::string(s),static_cast<int>(m_strings.size()))).first;
+    m_strings.push_back(s);
+  }
+  putInt(it->second+1);
+}
+
+//---------------------------------------------------------------------------
+
+void CodeRecorder::codify(const char *s)
+{
+  putOp(Op_Codify);
+  putText(s);
+}
+
+void CodeRecorder::writeCodeLink(const char *ref,const char *file,
+                                 const char *anchor,const char *name,
+                                 const char *tooltip)
+{
+  putOp(Op_CodeLink);
+  putString(ref);
+  putString(file);
+  putString(anchor);
+  putText(name);
+  putString(tooltip);
+}
+
+void CodeRecorder::writeLineNumber(const char *ref,const char *file,
+                                   const char *anchor,int lineNumber)
+{
+  putOp(Op_LineNumber);
+  putString(ref);
+  putString(file);
+  putString(anchor);
+  putInt(lineNumber);
+}
+
+void CodeRecorder::writeTooltip(const char *id,
+                                const DocLinkInfo &docInfo,
+                                const char *decl,
+                                const char *desc,
+                                const SourceLinkInfo &defInfo,
+                                const SourceLinkInfo &declInfo)
+{
+  putOp(Op_Tooltip);
+  putString(id);
+  putString(docInfo.name);
+  putString(docInfo.ref);
+  putString(docInfo.url.data());
+  putString(docInfo.anchor);
+  putString(decl);
+  putString(desc);
+  for (const SourceLinkInfo *info : { &defInfo, &declInfo })
+  {
+    putString(info->file);
+    putInt(info->line);
+    putString(info->ref);
+    putString(info->url.data());
+    putString(info->anchor);
+  }
+}
+
+void CodeRecorder::startCodeLine(bool hasLineNumbers)
+{
+  putOp(Op_StartCodeLine);
+  putInt(hasLineNumbers ? 1 : 0);
+}
+
+void CodeRecorder::endCodeLine()
+{
+  putOp(Op_EndCodeLine);
+}
+
+void CodeRecorder::startFontClass(const char *clsName)
+{
+  putOp(Op_StartFontClass);
+  putString(clsName);
+}
+
+void CodeRecorder::endFontClass()
+{
+  putOp(Op_EndFontClass);
+}
+
+void CodeRecorder::writeCodeAnchor(const char *name)
+{
+  putOp(Op_CodeAnchor);
+  putString(name);
+}
+
+void CodeRecorder::setCurrentDoc(const Definition *context,const char *anchor,bool isSourceFile)
+{
+  putOp(Op_SetCurrentDoc);
+  m_data.append(reinterpret_cast<const char *>(&context),sizeof(context));
+  putString(anchor);
+  putInt(isSourceFile ? 1 : 0);
+}
+
+void CodeRecorder::addWord(const char *word,bool hiPriority)
+{
+  putOp(Op_AddWord);
+  putString(word);
+  putInt(hiPriority ? 1 : 0);
+}
+
+void CodeRecorder::startCodeFragment(const char *style)
+{
+  putOp(Op_StartCodeFragment);
+  putString(style);
+}
+
+void CodeRecorder::endCodeFragment(const char *style)
+{
+  putOp(Op_EndCodeFragment);
+  putString(style);
+}
+
+//---------------------------------------------------------------------------
+
+/** Helper to read back the data written by the CodeRecorder */
+class CodeReader
+{
+  public:
+    CodeReader(const std::string &data,const std::vector<std::string> &strings)
+      : m_p(data.data()), m_end(data.data()+data.size()), m_strings(strings) {}
+    bool atEnd() const { return m_p>=m_end; }
+    int getOp() { return static_cast<unsigned char>(*m_p++); }
+    int getInt()
+    {
+      uint32_t v = 0;
+      int shift = 0;
+      unsigned char c;
+      do
+      {
+        c = static_cast<unsigned char>(*m_p++);
+        v |= static_cast<uint32_t>(c&0x7f)<<shift;
+        shift+=7;
+      } while (c&0x80);
+      return static_cast<int>((v>>1) ^ (~(v&1)+1));
+    }
+    bool getBool() { return getInt()!=0; }
+    // returns text stored inline, or null
+    const char *getText(std::string &buf)
+    {
+      int len = getInt();
+      if (len==0) return 0;
+      buf.assign(m_p,len-1);
+      m_p+=len-1;
+      return buf.c_str();
+    }
+    // returns a string stored in the string table, or null
+    const char *getString()
+    {
+      int index = getInt();
+      return index==0 ? 0 : m_strings[index-1].c_str();
+    }
+    const Definition *getPointer()
+    {
+      const Definition *d;
+      memcpy(&d,m_p,sizeof(d));
+      m_p+=sizeof(d);
+      return d;
+    }
+
+  private:
+    const char *m_p;
+    const char *m_end;
+    const std::vector<std::string> &m_strings;
+};
+
+void CodeRecorder::replay(CodeOutputInterface &out) const
+{
+  CodeReader r(m_data,m_strings);
+  std::string text;
+  while (!r.atEnd())
+  {
+    switch (r.getOp())
+    {
+      case Op_Codify:
+        out.codify(r.getText(text));
+        break;
+      case Op_CodeLink:
+        {
+          const char *ref     = r.getString();
+          const char *file    = r.getString();
+          const char *anchor  = r.getString();
+          const char *name    = r.getText(text);
+          const char *tooltip = r.getString();
+          out.writeCodeLink(ref,file,anchor,name,tooltip);
+        }
+        break;
+      case Op_LineNumber:
+        {
+          const char *ref     = r.getString();
+          const char *file    = r.getString();
+          const char *anchor  = r.getString();
+          int lineNumber      = r.getInt();
+          out.writeLineNumber(ref,file,anchor,lineNumber);
+        }
+        break;
+      case Op_Tooltip:
+        {
+          const char *id = r.getString();
+          DocLinkInfo docInfo;
+          docInfo.name   = r.getString();
+          docInfo.ref    = r.getString();
+          docInfo.url    = QCString(r.getString());
+          docInfo.anchor = r.getString();
+          const char *decl = r.getString();
+          const char *desc = r.getString();
+          SourceLinkInfo defInfo,declInfo;
+          for (SourceLinkInfo *info : { &defInfo, &declInfo })
+          {
+            info->file   = r.getString();
+            info->line   = r.getInt();
+            info->ref    = r.getString();
+            info->url    = QCString(r.getString());
+            info->anchor = r.getString();
+          }
+          out.writeTooltip(id,docInfo,decl,desc,defInfo,declInfo);
+        }
+        break;
+      case Op_StartCodeLine:
+        out.startCodeLine(r.getBool());
+        break;
+      case Op_EndCodeLine:
+        out.endCodeLine();
+        break;
+      case Op_StartFontClass:
+        out.startFontClass(r.getString());
+        break;
+      case Op_EndFontClass:
+        out.endFontClass();
+        break;
+      case Op_CodeAnchor:
+        out.writeCodeAnchor(r.getString());
+        break;
+      case Op_SetCurrentDoc:
+        {
+          const Definition *context = r.getPointer();
+          const char *anchor        = r.getString();
+          bool isSourceFile         = r.getBool();
+          out.setCurrentDoc(context,anchor,isSourceFile);
+        }
+        break;
+      case Op_AddWord:
+        {
+          const char *word = r.getString();
+          bool hiPriority  = r.getBool();
+          out.addWord(word,hiPriority);
+        }
+        break;
+      case Op_StartCodeFragment:
+        out.startCodeFragment(r.getString());
+        break;
+      case Op_EndCodeFragment:
+        out.endCodeFragment(r.getString());
+        break;
+      default:
+        err("invalid code recording\n");
+        return;
+    }
+  }
+}
+
+void CodeRecorder::finish()
+{
+  m_stringIndex.clear();
+  m_data.shrink_to_fit();
+}
+
+size_t CodeRecorder::size() const
+{
+  size_t result = m_data.capacity();
+  for (const auto &s : m_strings) result+=sizeof(s)+s.capacity();
+  return result;
+}
+
+//---------------------------------------------------------------------------
+
+static std::string sourceHash(const QCString &text)
+{
+  uchar md5_sig[16];
+  char sigStr[33];
+  MD5Buffer((const unsigned char *)text.data(),text.length(),md5_sig);
+  MD5SigToString(md5_sig,sigStr,33);
+  return sigStr;
+}
+
+struct CodeRecordingCache::Private
+{
+  struct CacheEntry
+  {
+    std::string hash;
+    std::unique_ptr<CodeRecorder> recording;
+  };
+  bool enabled = false;
+  size_t maxSize = 0;
+  size_t totalSize = 0;
+  std::unordered_map<const FileDef *,CacheEntry> entries;
+  mutable std::mutex mutex;
+  std::atomic_int numStored   { 0 };
+  std::atomic_int numDropped  { 0 };
+  std::atomic_int numReplayed { 0 };
+  std::atomic_int numMissed   { 0 };
+};
+
+CodeRecordingCache::CodeRecordingCache() : p(std::make_unique<Private>())
+{
+  p->maxSize = static_cast<size_t>(Config_getInt(CODE_CACHE_SIZE))*1024*1024;
+  // the XML program listings are currently the only user of the recordings
+  p->enabled = p->maxSize>0 && Config_getBool(GENERATE_XML) && Config_getBool(XML_PROGRAMLISTING);
+}
+
+CodeRecordingCache::~CodeRecordingCache()
+{
+}
+
+CodeRecordingCache &CodeRecordingCache::instance()
+{
+  static CodeRecordingCache cache;
+  return cache;
+}
+
+bool CodeRecordingCache::isEnabled() const
+{
+  return p->enabled;
+}
+
+void CodeRecordingCache::store(const FileDef *fd,const QCString &text,std::unique_ptr<CodeRecorder> recording)
+{
+  if (!p->enabled) return;
+  recording->finish();
+  size_t size = recording->size();
+  std::string hash = sourceHash(text);
+  std::lock_guard<std::mutex> lock(p->mutex);
+  if (p->totalSize+size>p->maxSize)
+  {
+    p->numDropped++;
+    return;
+  }
+  auto it = p->entries.find(fd);
+  if (it!=p->entries.end())
+  {
+    p->totalSize-=it->second.recording->size();
+    p->entries.erase(it);
+  }
+  p->entries.insert(std::make_pair(fd,Private::CacheEntry{hash,std::move(recording)}));
+  p->totalSize+=size;
+  p->numStored++;
+}
+
+bool CodeRecordingCache::replay(const FileDef *fd,const QCString &text,CodeOutputInterface &out)
+{
+  if (!p->enabled) return false;
+  std::unique_ptr<CodeRecorder> recording;
+  std::string hash = sourceHash(text);
+  {
+    std::lock_guard<std::mutex> lock(p->mutex);
+    auto it = p->entries.find(fd);
+    if (it!=p->entries.end())
+    {
+      if (it->second.hash==hash)
+      {
+        recording = std::move(it->second.recording);
+      }
+      // a recording is used only once, so release it in any case
+      p->totalSize-=(recording ? recording->size() : it->second.recording->size());
+      p->entries.erase(it);
+    }
+  }
+  if (!recording)
+  {
+    p->numMissed++;
+    return false;
+  }
+  recording->replay(out);
+  p->numReplayed++;
+  return true;
+}
+
+void CodeRecordingCache::printStatistics() const
+{
+  if (p->enabled)
+  {
+    msg("code cache: %d files recorded, %d files replayed, %d files parsed again, %d recordings did not fit\n",
+        p->numStored.load(),p->numReplayed.load(),p->numMissed.load(),p->numDropped.load());
+  }
+}
+
+void CodeRecordingCache::traceStatistics() const
+{
+  if (p->enabled)
+  {
+    Trace::counter("code cache","replayed",p->numReplayed.load());
+    Trace::counter("code cache","parsed again",p->numMissed.load());
+  }
+}
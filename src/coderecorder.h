@@ -0,0 +1,128 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef CODERECORDER_H
+#define CODERECORDER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "outputgen.h"
+
+class FileDef;
+
+/** @brief Code output interface that records the output of a code parser.
+ *
+ *  The calls are stored in a compact byte stream: an operation code
+ *  followed by its arguments. Strings that repeat often, like font classes
+ *  and link targets, are stored once. The recorded calls can be replayed
+ *  into any other CodeOutputInterface, which then produces the same output
+ *  as if the code parser had written to it directly.
+ */
+class CodeRecorder : public CodeOutputInterface
+{
+  public:
+    /** Creates a recorder that reports \a outputId as its identifier,
+     *  so tooltips are collected for the output it will be replayed into.
+     */
+    CodeRecorder(int outputId=0) : m_outputId(outputId) {}
+
+    int id() const { return m_outputId; }
+    void codify(const char *s);
+    void writeCodeLink(const char *ref,const char *file,
+                       const char *anchor,const char *name,
+                       const char *tooltip);
+    void writeLineNumber(const char *ref,const char *file,
+                         const char *anchor,int lineNumber);
+    void writeTooltip(const char *id,
+                      const DocLinkInfo &docInfo,
+                      const char *decl,
+                      const char *desc,
+                      const SourceLinkInfo &defInfo,
+                      const SourceLinkInfo &declInfo);
+    void startCodeLine(bool hasLineNumbers);
+    void endCodeLine();
+    void startFontClass(const char *clsName);
+    void endFontClass();
+    void writeCodeAnchor(const char *name);
+    void setCurrentDoc(const Definition *context,const char *anchor,bool isSourceFile);
+    void addWord(const char *word,bool hiPriority);
+    void startCodeFragment(const char *style);
+    void endCodeFragment(const char *style);
+
+    /** Replays the recorded calls into \a out */
+    void replay(CodeOutputInterface &out) const;
+
+    /** Releases the memory only needed while recording */
+    void finish();
+
+    /** Returns the number of bytes used by the recording */
+    size_t size() const;
+
+  private:
+    void putOp(int op);
+    void putInt(int value);
+    void putText(const char *s);
+    void putString(const char *s);
+    std::string m_data;
+    std::vector<std::string> m_strings;
+    std::unordered_map<std::string,int> m_stringIndex;
+    int m_outputId;
+};
+
+/** @brief Keeps the recorded source code of files until it is used.
+ *
+ *  While writing the source pages the output of the code parser is recorded
+ *  and stored here, so the XML program listing of a file can replay it
+ *  instead of parsing the file again. A recording is only replayed if the
+ *  source text is the same and is released once it has been replayed.
+ *  The memory used is bounded by \c CODE_CACHE_SIZE; recordings that do not
+ *  fit are not stored, and the files are parsed again instead.
+ *
+ *  The methods can be called from multiple threads at the same time.
+ */
+class CodeRecordingCache
+{
+  public:
+    static CodeRecordingCache &instance();
+
+    /** Returns TRUE if recordings are needed later on in this run */
+    bool isEnabled() const;
+
+    /** Stores the \a recording for the source text \a text of file \a fd */
+    void store(const FileDef *fd,const QCString &text,std::unique_ptr<CodeRecorder> recording);
+
+    /** Replays the recording for file \a fd into \a out if the source text
+     *  that was recorded matches \a text. Returns FALSE if there is no such
+     *  recording.
+     */
+    bool replay(const FileDef *fd,const QCString &text,CodeOutputInterface &out);
+
+    /** Reports the number of files replayed and parsed again */
+    void printStatistics() const;
+
+    /** Adds the current counters to the trace, see Trace::counter() */
+    void traceStatistics() const;
+
+  private:
+    CodeRecordingCache();
+   ~CodeRecordingCache();
+    struct Private;
+    std::unique_ptr<Private> p;
+};
+
+#endif
@@ -23,6 +23,7 @@
 #include "searchindex.h"
 #include "message.h"
 #include "parserintf.h"
+#include "docrootcache.h"
 
 //------------------------------------------------------------------------------------
 
@@ -281,7 +282,7 @@ void ConceptDefImpl::writeBriefDescription(OutputList &ol) const
 {
   if (hasBriefDescription())
   {
-    DocRoot *rootNode = validatingParseDoc(briefFile(),briefLine(),this,0,
+    std::shared_ptr<DocRoot> rootNode = DocRootCache::instance().parse(briefFile(),briefLine(),this,0,
                         briefDescription(),TRUE,FALSE,
                         0,TRUE,FALSE,Config_getBool(MARKDOWN_SUPPORT));
     if (rootNode && !rootNode->isEmpty())
@@ -291,7 +292,7 @@ void ConceptDefImpl::writeBriefDescription(OutputList &ol) const
       ol.disableAllBut(OutputGenerator::Man);
       ol.writeString(" - ");
       ol.popGeneratorState();
-      ol.writeDoc(rootNode,this,0);
+      ol.writeDoc(rootNode.get(),this,0);
       ol.pushGeneratorState();
       ol.disable(OutputGenerator::RTF);
       ol.writeString(" \n");
@@ -307,7 +308,6 @@ void ConceptDefImpl::writeBriefDescription(OutputList &ol) const
       ol.popGeneratorState();
       ol.endParagraph();
     }
-    delete rootNode;
   }
   ol.writeSynopsis();
 }
@@ -617,16 +617,15 @@ void ConceptDefImpl::writeDeclarationLink(OutputList &ol,bool &found,const char
     // add the brief description if available
     if (!briefDescription().isEmpty() && Config_getBool(BRIEF_MEMBER_DESC))
     {
-      DocRoot *rootNode = validatingParseDoc(briefFile(),briefLine(),this,0,
+      std::shared_ptr<DocRoot> rootNode = DocRootCache::instance().parse(briefFile(),briefLine(),this,0,
                                 briefDescription(),FALSE,FALSE,
                                 0,TRUE,FALSE,Config_getBool(MARKDOWN_SUPPORT));
       if (rootNode && !rootNode->isEmpty())
       {
         ol.startMemberDescription(anchor());
-        ol.writeDoc(rootNode,this,0);
+        ol.writeDoc(rootNode.get(),this,0);
         ol.endMemberDescription();
       }
-      delete rootNode;
     }
     ol.endMemberDeclaration(anchor(),0);
   }
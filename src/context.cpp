@@ -33,6 +33,8 @@
 #include "filename.h"
 #include "dirdef.h"
 #include "docparser.h"
+#include "docrootcache.h"
+#include "stringpool.h"
 #include "htmlgen.h"
 #include "htmldocvisitor.h"
 #include "htmlhelp.h"
@@ -254,33 +256,35 @@ class PropertyMapper
      */
     void addProperty(const char *name,typename PropertyFunc::Handler handle)
     {
-      auto it = m_map.find(name);
+      const char *id = StringPool::intern(name)->c_str();
+      auto it = m_map.find(id);
       if (it!=m_map.end())
       {
         err("adding property '%s' more than once\n",name);
       }
       else
       {
-        m_map.insert(std::make_pair(name,std::make_unique<PropertyFunc>(handle)));
+        m_map.insert(std::make_pair(id,std::make_unique<PropertyFunc>(handle)));
       }
     }
 
     /** Gets the value of a property.
      *  @param[in] obj  The object handling access to the property.
-     *  @param[in] name The name of the property.
+     *  @param[in] name The name of the property as a pooled string (see StringPool).
      *  @returns A variant representing the properties value or an
      *  invalid variant if it was not found.
      */
     TemplateVariant get(const T *obj,const char *name) const
     {
       //printf("PropertyMapper::get(%s)\n",name);
-      TemplateVariant result;
+      // the template engine pools the names when it parses a template,
+      // so a property is found by address without comparing characters
       auto it = m_map.find(name);
       return it!=m_map.end() ? (*it->second)(obj) : TemplateVariant();
     }
 
   private:
-    std::unordered_map<std::string,std::unique_ptr<PropertyFuncIntf>> m_map;
+    std::unordered_map<const char *,std::unique_ptr<PropertyFuncIntf>> m_map; // keyed by the pooled name
 };
 
 
@@ -1257,7 +1261,7 @@ static TemplateVariant parseDoc(const Definition *def,const QCString &file,int l
                                 const QCString &relPath,const QCString &docStr,bool isBrief)
 {
   TemplateVariant result;
-  DocRoot *root = validatingParseDoc(file,line,def,0,docStr,TRUE,FALSE,
+  std::shared_ptr<DocRoot> root = DocRootCache::instance().parse(file,line,def,0,docStr,TRUE,FALSE,
                                      0,isBrief,FALSE,Config_getBool(MARKDOWN_SUPPORT));
   TextStream ts;
   switch (g_globals.outputFormat)
@@ -1286,7 +1290,6 @@ static TemplateVariant parseDoc(const Definition *def,const QCString &file,int l
     result = "";
   else
     result = TemplateVariant(ts.str().c_str(),TRUE);
-  delete root;
   return result;
 }
 
@@ -5842,6 +5845,13 @@ TemplateVariant ClassIndexContext::get(const char *n) const
 
 //------------------------------------------------------------------------
 
+// returns the pooled name of the children property, as expected by TemplateStructIntf::get()
+static const char *childrenId()
+{
+  static const char *id = StringPool::intern("children")->c_str();
+  return id;
+}
+
 static int computeMaxDepth(const TemplateListIntf *list)
 {
   int maxDepth=0;
@@ -5852,7 +5862,7 @@ static int computeMaxDepth(const TemplateListIntf *list)
     for (it->toFirst();it->current(v);it->toNext())
     {
       const TemplateStructIntf *s = v.toStruct();
-      TemplateVariant child = s->get("children");
+      TemplateVariant child = s->get(childrenId());
       int d = computeMaxDepth(child.toList())+1;
       if (d>maxDepth) maxDepth=d;
     }
@@ -5867,7 +5877,7 @@ static int computeNumNodesAtLevel(const TemplateStructIntf *s,int level,int maxL
   if (level<maxLevel)
   {
     num++;
-    TemplateVariant child = s->get("children");
+    TemplateVariant child = s->get(childrenId());
     if (child.toList())
     {
       TemplateListIntf::ConstIterator *it = child.toList()->createIterator();
@@ -48,6 +48,7 @@
 #include "bufstr.h"
 #include "reflist.h"
 #include "utf8.h"
+#include "stringpool.h"
 
 //-----------------------------------------------------------------------------------------
 
@@ -78,7 +79,7 @@ class DefinitionImpl::IMPL
     QCString localName;      // local (unqualified) name of the definition
                              // in the future m_name should become m_localName
     QCString qualifiedName;
-    QCString ref;   // reference to external documentation
+    InternedString ref;   // reference to external documentation
 
     bool hidden = FALSE;
     bool isArtificial = FALSE;
@@ -87,8 +88,8 @@ class DefinitionImpl::IMPL
     Definition *outerScope = 0;  // not owner
 
     // where the item was defined
-    QCString defFileName;
-    QCString defFileExt;
+    InternedString defFileName;
+    InternedString defFileExt;
 
     SrcLangExt lang = SrcLangExt_Unknown;
 
@@ -114,10 +115,10 @@ DefinitionImpl::IMPL::~IMPL()
 void DefinitionImpl::IMPL::setDefFileName(const QCString &df)
 {
   defFileName = df;
-  int lastDot = defFileName.findRev('.');
+  int lastDot = df.findRev('.');
   if (lastDot!=-1)
   {
-    defFileExt = defFileName.mid(lastDot);
+    defFileExt = df.mid(lastDot);
   }
 }
 
@@ -1129,7 +1130,7 @@ void DefinitionImpl::writeInlineCode(OutputList &ol,const char *scopeName) const
     {
       //printf("Adding code fragment '%s' ext='%s'\n",
       //    codeFragment.data(),m_impl->defFileExt.data());
-      auto intf = Doxygen::parserManager->getCodeParser(m_impl->defFileExt);
+      auto intf = Doxygen::parserManager->getCodeParser(m_impl->defFileExt.data());
       intf->resetCodeParserState();
       //printf("Read:\n'%s'\n\n",codeFragment.data());
       const MemberDef *thisMd = 0;
@@ -1368,7 +1368,7 @@ void ClassDiagram::writeImage(TextStream &t,const char *path,
   p->super.drawConnectors(t,&image,FALSE,TRUE,baseRows,superRows,cellWidth,cellHeight);
 
 #define IMAGE_EXT ".png"
-  image.save((QCString)path+"/"+fileName+IMAGE_EXT);
+  image.saveAsync((QCString)path+"/"+fileName+IMAGE_EXT);
   Doxygen::indexList->addImageFile(QCString(fileName)+IMAGE_EXT);
 }
 
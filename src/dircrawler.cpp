@@ -0,0 +1,137 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#include <future>
+#include <mutex>
+#include <unordered_map>
+
+#include "dircrawler.h"
+#include "threadpool.h"
+#include "fileinfo.h"
+#include "dir.h"
+
+//---------------------------------------------------------------------------
+
+struct DirCrawler::Private
+{
+  struct DirState
+  {
+    std::vector<CrawledEntry> entries;
+    std::promise<void> promise;
+    std::shared_future<void> ready;
+  };
+
+  // returns the state of directory dirName, isNew is set to TRUE if the
+  // caller is the first to ask for it and should read the directory.
+  DirState *lookup(const std::string &dirName,bool &isNew)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = dirs.find(dirName);
+    if (it!=dirs.end())
+    {
+      isNew = false;
+      return it->second.get();
+    }
+    auto state = std::make_unique<DirState>();
+    state->ready = state->promise.get_future().share();
+    isNew = true;
+    return dirs.insert(std::make_pair(dirName,std::move(state))).first->second.get();
+  }
+
+  // reads the entries of dirName and marks the state as ready, an error
+  // while reading is passed on to the thread that asks for the entries.
+  static bool read(const std::string &dirName,DirState *state)
+  {
+    try
+    {
+      readEntries(dirName,state->entries);
+      state->promise.set_value();
+      return true;
+    }
+    catch (...)
+    {
+      state->promise.set_exception(std::current_exception());
+      return false;
+    }
+  }
+
+  static void readEntries(const std::string &dirName,std::vector<CrawledEntry> &entries)
+  {
+    Dir dir(dirName);
+    for (const auto &dirEntry : dir.iterator())
+    {
+      FileInfo fi(dirEntry.path());
+      CrawledEntry e;
+      e.fileName    = fi.fileName();
+      e.filePath    = fi.filePath();
+      e.absFilePath = fi.absFilePath();
+      e.dirPath     = fi.dirPath();
+      e.exists      = fi.exists();
+      e.isReadable  = fi.isReadable();
+      e.isFile      = fi.isFile();
+      e.isDir       = fi.isDir();
+      e.isSymLink   = fi.isSymLink();
+      entries.push_back(std::move(e));
+    }
+  }
+
+  std::mutex mutex;
+  std::unordered_map< std::string,std::unique_ptr<DirState> > dirs;
+  std::unique_ptr<ThreadPool> threadPool; // declared last, so it is finished first
+};
+
+DirCrawler::DirCrawler(std::size_t numThreads) : p(std::make_unique<Private>())
+{
+  if (numThreads>1)
+  {
+    p->threadPool = std::make_unique<ThreadPool>(numThreads);
+  }
+}
+
+DirCrawler::~DirCrawler()
+{
+  if (p->threadPool) p->threadPool->finish();
+}
+
+const std::vector<CrawledEntry> &DirCrawler::entries(const std::string &dirName)
+{
+  bool isNew;
+  Private::DirState *state = p->lookup(dirName,isNew);
+  if (isNew)
+  {
+    Private::read(dirName,state);
+  }
+  state->ready.get();
+  return state->entries;
+}
+
+void DirCrawler::prefetch(const std::string &dirName,const DescendFilter &descend)
+{
+  if (!p->threadPool) return;
+  bool isNew;
+  Private::DirState *state = p->lookup(dirName,isNew);
+  if (!isNew) return;
+  p->threadPool->queue([this,dirName,state,descend]()
+  {
+    if (!Private::read(dirName,state)) return;
+    for (const auto &e : state->entries)
+    {
+      if (e.isDir && descend(e))
+      {
+        prefetch(e.absFilePath,descend);
+      }
+    }
+  });
+}
@@ -0,0 +1,80 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef DIRCRAWLER_H
+#define DIRCRAWLER_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/** @brief Information about a file or directory found in a directory.
+ *
+ *  The fields hold the results of the FileInfo methods with the same name.
+ */
+struct CrawledEntry
+{
+  std::string fileName;
+  std::string filePath;
+  std::string absFilePath;
+  std::string dirPath;
+  bool exists     = false;
+  bool isReadable = false;
+  bool isFile     = false;
+  bool isDir      = false;
+  bool isSymLink  = false;
+};
+
+/** @brief Reads directories once and keeps their contents.
+ *
+ *  The input files, include files, examples, images, etc. are searched for
+ *  in directory trees that often overlap. Via this class each directory is
+ *  read only once, and the properties of its entries are determined only
+ *  once. Directories that will be needed next can be read in the background
+ *  by a number of threads, so the time spent waiting for the file system
+ *  overlaps. The entries of a directory are always returned in the order
+ *  of the file system, independent of the thread that read them.
+ */
+class DirCrawler
+{
+  public:
+    /** Function that returns TRUE if the subdirectory \a entry should be read as well */
+    using DescendFilter = std::function<bool(const CrawledEntry &entry)>;
+
+    /** Creates a crawler that reads directories in the background with
+     *  \a numThreads threads. If \a numThreads is 1 or less, directories are
+     *  only read when they are requested.
+     */
+    DirCrawler(std::size_t numThreads);
+   ~DirCrawler();
+
+    /** Returns the entries of directory \a dirName, reading the directory
+     *  if this was not done before. Waits for a background read of the
+     *  directory to finish if needed.
+     */
+    const std::vector<CrawledEntry> &entries(const std::string &dirName);
+
+    /** Starts reading directory \a dirName in the background, followed by
+     *  its subdirectories for which \a descend returns TRUE.
+     */
+    void prefetch(const std::string &dirName,const DescendFilter &descend);
+
+  private:
+    struct Private;
+    std::unique_ptr<Private> p;
+};
+
+#endif
@@ -28,6 +28,7 @@
 #include "layout.h"
 #include "config.h"
 #include "docparser.h"
+#include "docrootcache.h"
 #include "definitionimpl.h"
 #include "filedef.h"
 
@@ -264,7 +265,7 @@ void DirDefImpl::writeBriefDescription(OutputList &ol)
 {
   if (hasBriefDescription())
   {
-    DocRoot *rootNode = validatingParseDoc(
+    std::shared_ptr<DocRoot> rootNode = DocRootCache::instance().parse(
          briefFile(),briefLine(),this,0,briefDescription(),TRUE,FALSE,
          0,FALSE,FALSE,Config_getBool(MARKDOWN_SUPPORT));
     if (rootNode && !rootNode->isEmpty())
@@ -274,7 +275,7 @@ void DirDefImpl::writeBriefDescription(OutputList &ol)
       ol.disableAllBut(OutputGenerator::Man);
       ol.writeString(" - ");
       ol.popGeneratorState();
-      ol.writeDoc(rootNode,this,0);
+      ol.writeDoc(rootNode.get(),this,0);
       ol.pushGeneratorState();
       ol.disable(OutputGenerator::RTF);
       ol.writeString(" \n");
@@ -293,7 +294,6 @@ void DirDefImpl::writeBriefDescription(OutputList &ol)
 
       ol.endParagraph();
     }
-    delete rootNode;
   }
   ol.writeSynopsis();
 }
@@ -50,7 +50,7 @@
 
 static QCString filterId(const char *s)
 {
-  static GrowBuf growBuf;
+  static thread_local GrowBuf growBuf;
   growBuf.clear();
   if (s==0) return "";
   const char *p=s;
@@ -341,16 +341,10 @@ DB_VIS_C
       break;
     case DocVerbatim::Dot:
       {
-        static int dotindex = 1;
-        QCString baseName(4096);
-        QCString name;
+        QCString baseName = Config_getString(DOCBOOK_OUTPUT)+"/"+
+                            OutputGenerator::inlineImageName(OutputGenerator::Docbook,"inline_dotgraph_");
         QCString stext = s->text();
         m_t << "<para>\n";
-        name.sprintf("%s%d", "dot_inline_dotgraph_", dotindex);
-        baseName.sprintf("%s%d",
-            (Config_getString(DOCBOOK_OUTPUT)+"/inline_dotgraph_").data(),
-            dotindex++
-            );
         std::string fileName = baseName.str()+".dot";
         std::ofstream file(fileName,std::ofstream::out | std::ofstream::binary);
         if (!file.is_open())
@@ -366,16 +360,10 @@ DB_VIS_C
       break;
     case DocVerbatim::Msc:
       {
-        static int mscindex = 1;
-        QCString baseName(4096);
-        QCString name;
+        QCString baseName = Config_getString(DOCBOOK_OUTPUT)+"/"+
+                            OutputGenerator::inlineImageName(OutputGenerator::Docbook,"inline_mscgraph_");
         QCString stext = s->text();
         m_t << "<para>\n";
-        name.sprintf("%s%d", "msc_inline_mscgraph_", mscindex);
-        baseName.sprintf("%s%d",
-            (Config_getString(DOCBOOK_OUTPUT)+"/inline_mscgraph_").data(),
-            mscindex++
-            );
         std::string fileName = baseName.str()+".msc";
         std::ofstream file(fileName,std::ofstream::out | std::ofstream::binary);
         if (!file.is_open())
@@ -395,7 +383,9 @@ DB_VIS_C
     case DocVerbatim::PlantUML:
       {
         static QCString docbookOutput = Config_getString(DOCBOOK_OUTPUT);
-        QCString baseName = PlantumlManager::instance().writePlantUMLSource(docbookOutput,s->exampleFile(),s->text(),PlantumlManager::PUML_BITMAP);
+        QCString baseName = PlantumlManager::instance().writePlantUMLSource(docbookOutput,
+            s->exampleFile().isEmpty() ? OutputGenerator::inlineImageName(OutputGenerator::Docbook,"inline_umlgraph_") : s->exampleFile(),
+            s->text(),PlantumlManager::PUML_BITMAP);
         QCString shortName = baseName;
         int i;
         if ((i=shortName.findRev('/'))!=-1)
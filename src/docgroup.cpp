@@ -19,6 +19,7 @@
 #include "entry.h"
 #include "message.h"
 #include "docgroup.h"
+#include "parsecache.h"
 
 static std::atomic_int g_groupId;
 
@@ -121,6 +122,7 @@ void DocGroup::open(Entry *e,const char *,int, bool implicit)
       info->header = m_memberGroupHeader.stripWhiteSpace();
       info->compoundName = m_compoundName;
       m_memberGroupId = findExistingGroup(info.get());
+      ParseCache::markUncacheable(); // member group ids are assigned globally
       auto it = Doxygen::memberGroupInfoMap.find(m_memberGroupId);
       if (it==Doxygen::memberGroupInfoMap.end())
       {
@@ -16,6 +16,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <cassert>
+#include <mutex>
 
 #include <ctype.h>
 
@@ -34,6 +35,7 @@
 #include "searchindex.h"
 #include "language.h"
 #include "portable.h"
+#include "trace.h"
 #include "cite.h"
 #include "arguments.h"
 #include "vhdldocgen.h"
@@ -88,35 +90,36 @@ using DefinitionStack = std::vector<const Definition *>;
 using DocNodeStack = std::stack<const DocNode *>;
 using DocStyleChangeStack = std::stack<const DocStyleChange *>;
 
-// Parser state: global variables during a call to validatingParseDoc
-static const Definition *     g_scope;
-static QCString               g_context;
-static bool                   g_inSeeBlock;
-static bool                   g_xmlComment;
-static bool                   g_insideHtmlLink;
-static DocNodeStack           g_nodeStack;
-static DocStyleChangeStack    g_styleStack;
-static DocStyleChangeStack    g_initialStyleStack;
-static DefinitionStack        g_copyStack;
-static QCString               g_fileName;
-static QCString               g_relPath;
-
-static bool                   g_hasParamCommand;
-static bool                   g_hasReturnCommand;
-static StringSet              g_retvalsFound;
-static StringSet              g_paramsFound;
-static const MemberDef *      g_memberDef;
-static bool                   g_isExample;
-static QCString               g_exampleName;
-static URLString               g_searchUrl;
-
-static QCString               g_includeFileName;
-static QCString               g_includeFileText;
-static uint                   g_includeFileOffset;
-static uint                   g_includeFileLength;
-static int                    g_includeFileLine;
-static bool                   g_includeFileShowLineNo;
-static bool                   g_markdownSupport;
+// Parser state: global variables during a call to validatingParseDoc.
+// The state is kept per thread, so documentation can be parsed concurrently.
+static thread_local const Definition *     g_scope;
+static thread_local QCString               g_context;
+static thread_local bool                   g_inSeeBlock;
+static thread_local bool                   g_xmlComment;
+static thread_local bool                   g_insideHtmlLink;
+static thread_local DocNodeStack           g_nodeStack;
+static thread_local DocStyleChangeStack    g_styleStack;
+static thread_local DocStyleChangeStack    g_initialStyleStack;
+static thread_local DefinitionStack        g_copyStack;
+static thread_local QCString               g_fileName;
+static thread_local QCString               g_relPath;
+
+static thread_local bool                   g_hasParamCommand;
+static thread_local bool                   g_hasReturnCommand;
+static thread_local StringSet              g_retvalsFound;
+static thread_local StringSet              g_paramsFound;
+static thread_local const MemberDef *      g_memberDef;
+static thread_local bool                   g_isExample;
+static thread_local QCString               g_exampleName;
+static thread_local URLString               g_searchUrl;
+
+static thread_local QCString               g_includeFileName;
+static thread_local QCString               g_includeFileText;
+static thread_local uint                   g_includeFileOffset;
+static thread_local uint                   g_includeFileLength;
+static thread_local int                    g_includeFileLine;
+static thread_local bool                   g_includeFileShowLineNo;
+static thread_local bool                   g_markdownSupport;
 
 
 /** Parser's context to store all global variables.
@@ -154,7 +157,10 @@ struct DocParserContext
   TokenInfo *token;
 };
 
-static std::stack< std::unique_ptr<DocParserContext> > g_parserStack;
+static thread_local std::stack< std::unique_ptr<DocParserContext> > g_parserStack;
+
+// words added to the search index are also stored here if set, see docParserRecordIndexWords()
+static thread_local StringVector *g_recordedIndexWords = 0;
 
 //---------------------------------------------------------------------------
 
@@ -299,6 +305,10 @@ static void unescapeCRef(QCString &s)
  * copies the image to the output directory (which depends on the \a type
  * parameter).
  */
+// serializes copying images to the output directories, the same image can be
+// referenced by comment blocks that are parsed on different threads
+static std::mutex g_copyImageMutex;
+
 static QCString findAndCopyImage(const char *fileName,DocImage::Type type, bool dowarn = true)
 {
   QCString result;
@@ -316,6 +326,7 @@ static QCString findAndCopyImage(const char *fileName,DocImage::Type type, bool
       warn_doc_error(g_fileName,getDoctokinizerLineNr(),"%s", text.data());
     }
 
+    std::lock_guard<std::mutex> lock(g_copyImageMutex);
     QCString inputFile = fd->absFilePath();
     FileInfo infi(inputFile.str());
     if (infi.exists())
@@ -1870,6 +1881,7 @@ DocWord::DocWord(DocNode *parent,const QCString &word) :
   if (Doxygen::searchIndex && !g_searchUrl.isEmpty())
   {
     Doxygen::searchIndex->addWord(word,FALSE);
+    if (g_recordedIndexWords) g_recordedIndexWords->push_back(word.str());
   }
 }
 
@@ -1888,6 +1900,7 @@ DocLinkedWord::DocLinkedWord(DocNode *parent,const QCString &word,
   if (Doxygen::searchIndex && !g_searchUrl.isEmpty())
   {
     Doxygen::searchIndex->addWord(word,FALSE);
+    if (g_recordedIndexWords) g_recordedIndexWords->push_back(word.str());
   }
 }
 
@@ -7326,6 +7339,8 @@ DocRoot *validatingParseDoc(const char *fileName,int startLine,
                             bool singleLine, bool linkFromIndex,
                             bool markdownSupport)
 {
+  TraceSpan traceSpan("doc",Trace::isEnabled() && ctx ? ctx->name() : QCString("doc block"),
+                      Trace::isEnabled() ? QCString(fileName)+":"+QCString().setNum(startLine) : QCString());
   //printf("validatingParseDoc(%s,%s)=[%s]\n",ctx?ctx->name().data():"<none>",
   //                                     md?md->name().data():"<none>",
   //                                     input);
@@ -7575,6 +7590,15 @@ DocText *validatingParseText(const char *input)
   return txt;
 }
 
+//--------------------------------------------------------------------------
+
+void docParserRecordIndexWords(StringVector *words)
+{
+  g_recordedIndexWords = words;
+}
+
+//--------------------------------------------------------------------------
+
 void docFindSections(const char *input,
                      const Definition *d,
                      const char *fileName)
@@ -27,6 +27,7 @@
 #include "docvisitor.h"
 #include "htmlattrib.h"
 #include "urlstring.h"
+#include "containers.h"
 
 class DocNode;
 class MemberDef;
@@ -69,6 +70,12 @@ DocRoot *validatingParseDoc(const char *fileName,int startLine,
  */
 DocText *validatingParseText(const char *input);
 
+/*! Makes the parser append the words it adds to the search index on the
+ *  calling thread to \a words, so they can be added again without parsing.
+ *  Passing 0 stops the recording.
+ */
+void docParserRecordIndexWords(StringVector *words);
+
 /*! Searches for section and anchor commands in the input */
 void docFindSections(const char *input,
                      const Definition *d,
@@ -0,0 +1,252 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#include <cinttypes>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "md5.h"
+
+#include "docrootcache.h"
+#include "docparser.h"
+#include "config.h"
+#include "doxygen.h"
+#include "searchindex.h"
+#include "memberdef.h"
+#include "message.h"
+#include "trace.h"
+
+//---------------------------------------------------------------------------
+
+// The size of a tree is estimated from the length of its input, as each word,
+// white space and symbol becomes a node of its own.
+static const size_t g_bytesPerInputChar = 24;
+static const size_t g_bytesPerEntry     = 256;
+static const size_t g_bytesPerIndexWord = 48;
+
+static std::string makeKey(const char *fileName,int startLine,
+                           const Definition *ctx,const MemberDef *md,
+                           const char *input,uint inputLen,
+                           bool isExample,const char *exampleName,
+                           bool singleLine,bool linkFromIndex,
+                           bool markdownSupport)
+{
+  uchar md5_sig[16];
+  char sigStr[33];
+  MD5Buffer((const unsigned char *)input,inputLen,md5_sig);
+  MD5SigToString(md5_sig,sigStr,33);
+  std::string key = sigStr;
+  key+=':'+std::to_string(reinterpret_cast<uintptr_t>(ctx));
+  key+=':'+std::to_string(reinterpret_cast<uintptr_t>(md));
+  key+=':'+std::to_string(startLine);
+  // the section levels in the tree depend on the nesting level of the subpage being written
+  key+=':'+std::to_string(Doxygen::subpageNestingLevel);
+  key+=':';
+  key+=isExample       ? '1' : '0';
+  key+=singleLine      ? '1' : '0';
+  key+=linkFromIndex   ? '1' : '0';
+  key+=markdownSupport ? '1' : '0';
+  key+=':';
+  if (fileName)    key+=fileName;
+  key+=':';
+  if (exampleName) key+=exampleName;
+  return key;
+}
+
+// adds the words of a block to the search index as validatingParseDoc() did
+// when the block was parsed
+static void addIndexWords(const Definition *ctx,const MemberDef *md,const StringVector &words)
+{
+  if (md)
+  {
+    Doxygen::searchIndex->setCurrentDoc(md,md->anchor(),FALSE);
+  }
+  else if (ctx)
+  {
+    Doxygen::searchIndex->setCurrentDoc(ctx,ctx->anchor(),FALSE);
+  }
+  for (const auto &word : words)
+  {
+    Doxygen::searchIndex->addWord(word.c_str(),FALSE);
+  }
+}
+
+//---------------------------------------------------------------------------
+
+struct DocRootCache::Private
+{
+  struct CacheEntry
+  {
+    std::string key;
+    std::shared_ptr<DocRoot> root;
+    size_t size;
+    bool indexed;
+    std::shared_ptr<const StringVector> indexWords; // words added to the search index when parsing
+  };
+  using EntryList = std::list<CacheEntry>;
+
+  // removes the least recently used entries until the cache fits
+  void trim()
+  {
+    while (totalSize>maxSize && entries.size()>1)
+    {
+      const CacheEntry &e = entries.back();
+      totalSize-=e.size;
+      map.erase(e.key);
+      entries.pop_back();
+      numEvicted++;
+    }
+  }
+
+  size_t maxSize = 0;
+  size_t totalSize = 0;
+  EntryList entries; // most recently used first
+  std::unordered_map<std::string,EntryList::iterator> map;
+  mutable std::mutex mutex;
+  uint64_t numHits = 0;
+  uint64_t numMisses = 0;
+  uint64_t numEvicted = 0;
+};
+
+DocRootCache::DocRootCache() : p(std::make_unique<Private>())
+{
+  p->maxSize = static_cast<size_t>(Config_getInt(DOC_CACHE_SIZE))*1024*1024;
+}
+
+DocRootCache::~DocRootCache()
+{
+}
+
+DocRootCache &DocRootCache::instance()
+{
+  static DocRootCache cache;
+  return cache;
+}
+
+std::shared_ptr<DocRoot> DocRootCache::parse(const char *fileName,int startLine,
+                                             const Definition *ctx,const MemberDef *md,
+                                             const char *input,bool indexWords,
+                                             bool isExample,const char *exampleName,
+                                             bool singleLine,bool linkFromIndex,
+                                             bool markdownSupport)
+{
+  if (p->maxSize==0)
+  {
+    return std::shared_ptr<DocRoot>(
+        validatingParseDoc(fileName,startLine,ctx,md,input,indexWords,
+                           isExample,exampleName,singleLine,linkFromIndex,markdownSupport));
+  }
+
+  uint inputLen = qstrlen(input);
+  bool needsIndexing = indexWords && Doxygen::searchIndex;
+  std::string key = makeKey(fileName,startLine,ctx,md,input ? input : "",inputLen,
+                            isExample,exampleName,singleLine,linkFromIndex,markdownSupport);
+  {
+    std::shared_ptr<DocRoot> root;
+    std::shared_ptr<const StringVector> words;
+    {
+      std::lock_guard<std::mutex> lock(p->mutex);
+      auto it = p->map.find(key);
+      // a tree parsed without indexing is parsed again when the words are
+      // needed for the search index, as indexing happens while parsing.
+      if (it!=p->map.end() && (!needsIndexing || it->second->indexed))
+      {
+        p->entries.splice(p->entries.begin(),p->entries,it->second);
+        p->numHits++;
+        root  = it->second->root;
+        words = it->second->indexWords;
+      }
+      else
+      {
+        p->numMisses++;
+      }
+    }
+    if (root)
+    {
+      // the words go to the search index each time the block is written,
+      // just as when it is parsed again
+      if (needsIndexing) addIndexWords(ctx,md,*words);
+      return root;
+    }
+  }
+
+  // parse outside of the lock, so other threads can use the cache meanwhile
+  auto words = std::make_shared<StringVector>();
+  if (needsIndexing) docParserRecordIndexWords(words.get());
+  std::shared_ptr<DocRoot> root(
+      validatingParseDoc(fileName,startLine,ctx,md,input,indexWords,
+                         isExample,exampleName,singleLine,linkFromIndex,markdownSupport));
+  if (needsIndexing) docParserRecordIndexWords(0);
+
+  std::lock_guard<std::mutex> lock(p->mutex);
+  auto it = p->map.find(key);
+  if (it!=p->map.end()) // parsed meanwhile by another thread or replaced by an indexed tree
+  {
+    it->second->root    = root;
+    if (needsIndexing && !it->second->indexed)
+    {
+      size_t wordsSize = words->size()*g_bytesPerIndexWord;
+      it->second->size   += wordsSize;
+      p->totalSize       += wordsSize;
+      it->second->indexed    = true;
+      it->second->indexWords = words;
+    }
+    p->entries.splice(p->entries.begin(),p->entries,it->second);
+    p->trim();
+  }
+  else
+  {
+    size_t size = g_bytesPerEntry+key.size()+inputLen*g_bytesPerInputChar+
+                  words->size()*g_bytesPerIndexWord;
+    p->entries.push_front({key,root,size,needsIndexing,words});
+    p->map.insert(std::make_pair(key,p->entries.begin()));
+    p->totalSize+=size;
+    p->trim();
+  }
+  return root;
+}
+
+void DocRootCache::clear()
+{
+  std::lock_guard<std::mutex> lock(p->mutex);
+  p->map.clear();
+  p->entries.clear();
+  p->totalSize = 0;
+}
+
+void DocRootCache::printStatistics() const
+{
+  std::lock_guard<std::mutex> lock(p->mutex);
+  if (p->maxSize>0)
+  {
+    msg("doc cache used %zu/%zu MB hits=%" PRIu64 " misses=%" PRIu64 " evicted=%" PRIu64 "\n",
+        p->totalSize/(1024*1024),p->maxSize/(1024*1024),
+        p->numHits,p->numMisses,p->numEvicted);
+  }
+}
+
+void DocRootCache::traceStatistics() const
+{
+  std::lock_guard<std::mutex> lock(p->mutex);
+  if (p->maxSize>0)
+  {
+    Trace::counter("doc cache","hits",static_cast<double>(p->numHits));
+    Trace::counter("doc cache","misses",static_cast<double>(p->numMisses));
+    Trace::counter("doc cache","used MB",static_cast<double>(p->totalSize)/(1024.0*1024.0));
+  }
+}
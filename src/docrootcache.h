@@ -0,0 +1,72 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef DOCROOTCACHE_H
+#define DOCROOTCACHE_H
+
+#include <memory>
+
+class DocRoot;
+class Definition;
+class MemberDef;
+
+/** @brief In memory cache of parsed documentation blocks.
+ *
+ *  Next to the generators behind the OutputList, the XML, SQLite3, Perl module
+ *  and template based outputs and the tree view each need the abstract syntax
+ *  tree of a documentation block. Getting the tree via the cache makes sure a
+ *  block is parsed only once, independent of the number of output formats.
+ *
+ *  Entries are keyed by the arguments passed to validatingParseDoc() and the
+ *  MD5 of the text. The memory used is bounded by \c DOC_CACHE_SIZE, removing
+ *  the least recently used trees first.
+ *
+ *  The returned trees are shared between callers and must not be modified.
+ *  The cache can be used from multiple threads at the same time.
+ */
+class DocRootCache
+{
+  public:
+    static DocRootCache &instance();
+
+    /** Returns the tree for documentation block \a input. The arguments have
+     *  the same meaning as for validatingParseDoc().
+     *  If \a indexWords is TRUE the words of the block are added to the search
+     *  index, also when the tree is taken from the cache.
+     */
+    std::shared_ptr<DocRoot> parse(const char *fileName,int startLine,
+                                   const Definition *ctx,const MemberDef *md,
+                                   const char *input,bool indexWords,
+                                   bool isExample,const char *exampleName,
+                                   bool singleLine,bool linkFromIndex,
+                                   bool markdownSupport);
+
+    /** Removes all trees from the cache */
+    void clear();
+
+    /** Reports the number of hits and misses */
+    void printStatistics() const;
+
+    /** Adds the current counters to the trace, see Trace::counter() */
+    void traceStatistics() const;
+
+  private:
+    DocRootCache();
+   ~DocRootCache();
+    struct Private;
+    std::unique_ptr<Private> p;
+};
+
+#endif
@@ -113,9 +113,8 @@ struct TokenInfo
   ParamDir paramDir = Unspecified;
 };
 
-// globals
-extern TokenInfo *g_token;
-extern FILE *doctokenizerYYin;
+// globals, each thread has its own current token
+extern thread_local TokenInfo *g_token;
 
 // helper functions
 const char *tokToString(int token);
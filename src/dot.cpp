@@ -17,10 +17,12 @@
 #include <cassert>
 #include <sstream>
 #include <algorithm>
+#include <mutex>
 
 #include "config.h"
 #include "dot.h"
 #include "dotrunner.h"
+#include "dotcache.h"
 #include "dotfilepatcher.h"
 #include "util.h"
 #include "portable.h"
@@ -75,8 +77,11 @@ static void unsetDotFontPath()
 
 DotManager *DotManager::m_theInstance = 0;
 
+static std::mutex g_dotManagerMutex;
+
 DotManager *DotManager::instance()
 {
+  std::lock_guard<std::mutex> lock(g_dotManagerMutex);
   if (!m_theInstance)
   {
     m_theInstance = new DotManager;
@@ -120,6 +125,7 @@ DotManager::~DotManager()
 
 DotRunner* DotManager::createRunner(const std::string &absDotName, const std::string& md5Hash)
 {
+  std::lock_guard<std::mutex> lock(m_mutex);
   DotRunner* rv = nullptr;
   auto const runit = m_runners.find(absDotName);
   if (runit == m_runners.end())
@@ -143,6 +149,7 @@ DotRunner* DotManager::createRunner(const std::string &absDotName, const std::st
 
 DotFilePatcher *DotManager::createFilePatcher(const std::string &fileName)
 {
+  std::lock_guard<std::mutex> lock(m_mutex);
   auto patcher = m_filePatchers.find(fileName);
 
   if (patcher != m_filePatchers.end()) return &(patcher->second);
@@ -156,6 +163,7 @@ bool DotManager::run() const
 {
   size_t numDotRuns = m_runners.size();
   size_t numFilePatchers = m_filePatchers.size();
+  DotCache::instance().init();
   if (numDotRuns+numFilePatchers>1)
   {
     if (m_workers.size()==0)
@@ -240,6 +248,8 @@ bool DotManager::run() const
   {
     unsetDotFontPath();
   }
+  DotCache::instance().trim();
+  DotCache::instance().printStatistics();
 
   // patch the output file and insert the maps and figures
   i=1;
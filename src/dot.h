@@ -17,6 +17,7 @@
 #define DOT_H
 
 #include <map>
+#include <mutex>
 
 #include "qcstring.h"
 #include "dotgraph.h" // only for GraphOutputFormat
@@ -44,6 +45,7 @@ class DotManager
     std::map<std::string, std::unique_ptr<DotRunner>>       m_runners;
     std::map<std::string, DotFilePatcher>  m_filePatchers;
     static DotManager     *m_theInstance;
+    std::mutex             m_mutex;
     DotRunnerQueue        *m_queue;
     std::vector< std::unique_ptr<DotWorkerThread> > m_workers;
 };
@@ -0,0 +1,230 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "md5.h"
+
+#include "dotcache.h"
+#include "config.h"
+#include "message.h"
+#include "portable.h"
+#include "fileinfo.h"
+#include "dir.h"
+#include "util.h"
+#include "trace.h"
+
+//---------------------------------------------------------------------------
+
+/** Returns the version string reported by the dot executable, or an
+ *  empty string if dot could not be run.
+ */
+static QCString dotVersion()
+{
+  QCString cmd = "\""+Config_getString(DOT_PATH)+"dot\" -V 2>&1";
+  QCString result;
+  FILE *f = Portable::popen(cmd,"r");
+  if (f)
+  {
+    const int bufSize=1024;
+    char buf[bufSize];
+    int numRead;
+    while ((numRead=(int)fread(buf,1,bufSize,f))>0)
+    {
+      result+=QCString(buf,numRead);
+    }
+    Portable::pclose(f);
+  }
+  return result.stripWhiteSpace();
+}
+
+//---------------------------------------------------------------------------
+
+struct DotCache::Private
+{
+  std::string entryPath(const QCString &key) const
+  {
+    // use the first two characters of the key as subdirectory to limit the number of files per directory
+    return cacheDir+"/"+key.left(2).str()+"/"+key.str();
+  }
+
+  bool initialized = false;
+  bool enabled = false;
+  std::string cacheDir;
+  QCString configKey;
+  std::atomic_int numHits    { 0 };
+  std::atomic_int numMisses  { 0 };
+  std::atomic_int numStored  { 0 };
+  int numRemoved = 0;
+};
+
+DotCache::DotCache() : p(std::make_unique<Private>())
+{
+}
+
+DotCache::~DotCache()
+{
+}
+
+DotCache &DotCache::instance()
+{
+  static DotCache cache;
+  return cache;
+}
+
+void DotCache::init()
+{
+  if (p->initialized) return;
+  p->initialized = true;
+
+  QCString cacheDir = Config_getString(DOT_CACHE_DIR);
+  if (cacheDir.isEmpty()) return;
+  Dir d(cacheDir.str());
+  if (!d.exists() && !d.mkdir(cacheDir.str()))
+  {
+    warn_uncond("cannot create dot cache directory '%s', the dot cache is disabled.\n",qPrint(cacheDir));
+    return;
+  }
+  QCString version = dotVersion();
+  if (version.isEmpty())
+  {
+    warn_uncond("could not determine the version of dot, the dot cache is disabled.\n");
+    return;
+  }
+  p->cacheDir  = d.absPath();
+  p->configKey = version+"\n"+Config_getString(DOT_FONTPATH)+"\n";
+  p->enabled   = true;
+}
+
+bool DotCache::isEnabled() const
+{
+  return p->enabled;
+}
+
+QCString DotCache::computeKey(const std::string &md5,const std::string &format) const
+{
+  QCString keyStr = p->configKey+md5.c_str()+"\n"+format.c_str();
+  uchar md5_sig[16];
+  MD5Buffer((const unsigned char*)keyStr.data(),keyStr.length(),md5_sig);
+  QCString result(33);
+  MD5SigToString(md5_sig,result.rawData(),33);
+  return result;
+}
+
+bool DotCache::restore(const QCString &key,const std::string &outputFile)
+{
+  std::string entryName = p->entryPath(key);
+  FileInfo fi(entryName);
+  if (!fi.exists() || fi.size()==0)
+  {
+    p->numMisses++;
+    return false;
+  }
+  Dir d;
+  d.remove(outputFile);
+  // the output files are never modified in place (dot is only run after
+  // removing them and patching replaces them) so a hard link can be used.
+  if (!d.link(entryName,outputFile) && !d.copy(entryName,outputFile))
+  {
+    p->numMisses++;
+    return false;
+  }
+  d.touch(entryName); // mark as recently used
+  p->numHits++;
+  return true;
+}
+
+void DotCache::store(const QCString &key,const std::string &outputFile)
+{
+  FileInfo fi(outputFile);
+  if (!fi.exists() || fi.size()==0) return;
+  std::string entryName = p->entryPath(key);
+  if (FileInfo(entryName).exists()) return;
+  Dir d;
+  std::string subDir = FileInfo(entryName).dirPath();
+  if (!d.exists(subDir)) d.mkdir(subDir);
+  // copy to a temporary file first, so an interrupted run cannot leave a truncated entry behind
+  std::string tmpName = tempFileName(entryName);
+  if (d.copy(outputFile,tmpName) && d.rename(tmpName,entryName))
+  {
+    p->numStored++;
+  }
+  else
+  {
+    d.remove(tmpName);
+  }
+}
+
+void DotCache::trim()
+{
+  if (!p->enabled) return;
+  uint64 maxSize = static_cast<uint64>(Config_getInt(DOT_CACHE_SIZE))*1024*1024;
+  if (maxSize==0) return;
+
+  struct CacheEntry
+  {
+    std::string  path;
+    uint64       size;
+    std::time_t  lastUsed;
+  };
+  std::vector<CacheEntry> entries;
+  uint64 totalSize = 0;
+  Dir cacheDir(p->cacheDir);
+  for (const auto &subDirEntry : cacheDir.iterator())
+  {
+    if (!subDirEntry.is_directory()) continue;
+    Dir subDir(subDirEntry.path());
+    for (const auto &dirEntry : subDir.iterator())
+    {
+      if (!dirEntry.is_regular_file()) continue;
+      FileInfo fi(dirEntry.path());
+      entries.push_back({dirEntry.path(),fi.size(),fi.lastModified()});
+      totalSize+=fi.size();
+    }
+  }
+  if (totalSize<=maxSize) return;
+
+  std::sort(entries.begin(),entries.end(),
+            [](const CacheEntry &e1,const CacheEntry &e2) { return e1.lastUsed<e2.lastUsed; });
+  for (const auto &entry : entries)
+  {
+    if (totalSize<=maxSize) break;
+    if (cacheDir.remove(entry.path))
+    {
+      totalSize-=entry.size;
+      p->numRemoved++;
+    }
+  }
+}
+
+void DotCache::printStatistics() const
+{
+  if (p->enabled)
+  {
+    msg("Dot cache: %d files restored, %d files generated, %d files stored, %d files removed\n",
+        p->numHits.load(),p->numMisses.load(),p->numStored.load(),p->numRemoved);
+  }
+}
+
+void DotCache::traceStatistics() const
+{
+  if (p->enabled)
+  {
+    Trace::counter("dot cache","restored",p->numHits.load());
+    Trace::counter("dot cache","generated",p->numMisses.load());
+  }
+}
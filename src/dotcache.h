@@ -0,0 +1,74 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef DOTCACHE_H
+#define DOTCACHE_H
+
+#include <memory>
+#include <string>
+
+#include "qcstring.h"
+
+/** @brief Content addressed cache of the files generated by dot.
+ *
+ *  The cache is stored in the directory set by \c DOT_CACHE_DIR. Each
+ *  entry is keyed by the MD5 of the graph's dot text, the version of dot,
+ *  the font path and the output format, so it can be shared between output
+ *  directories and runs. The size of the directory is bounded by
+ *  \c DOT_CACHE_SIZE, removing the least recently used entries first.
+ *
+ *  All methods except init() and trim() can be called from multiple threads.
+ */
+class DotCache
+{
+  public:
+    static DotCache &instance();
+
+    /** Prepares the cache for use. Does nothing if \c DOT_CACHE_DIR is empty
+     *  or if the cache is already initialized.
+     */
+    void init();
+
+    /** Returns TRUE if the cache is active for this run. */
+    bool isEnabled() const;
+
+    /** Computes the key for rendering the graph with MD5 \a md5 in \a format */
+    QCString computeKey(const std::string &md5,const std::string &format) const;
+
+    /** Puts the cached file for \a key at \a outputFile. Returns FALSE if
+     *  the cache has no entry for \a key.
+     */
+    bool restore(const QCString &key,const std::string &outputFile);
+
+    /** Stores a copy of \a outputFile under \a key */
+    void store(const QCString &key,const std::string &outputFile);
+
+    /** Removes the least recently used entries until the cache fits in \c DOT_CACHE_SIZE */
+    void trim();
+
+    /** Reports the number of hits and misses */
+    void printStatistics() const;
+
+    /** Adds the current counters to the trace, see Trace::counter() */
+    void traceStatistics() const;
+
+  private:
+    DotCache();
+   ~DotCache();
+    struct Private;
+    std::unique_ptr<Private> p;
+};
+
+#endif
@@ -13,15 +13,24 @@
 *
 */
 
+#include <algorithm>
 #include <cassert>
 
 #include "dotrunner.h"
+#include "dotcache.h"
 #include "util.h"
 #include "portable.h"
 #include "dot.h"
 #include "message.h"
 #include "config.h"
 #include "dir.h"
+#include "settings.h"
+#include "trace.h"
+
+#if USE_LIBGVC
+#include <mutex>
+#include <gvc.h>
+#endif
 
 // the graphicx LaTeX has a limitation of maximum size of 16384
 // To be on the save side we take it a little bit smaller i.e. 150 inch * 72 dpi
@@ -168,14 +177,87 @@ QCString getBaseNameOfOutput(const QCString &output)
   return output.left(index);
 }
 
+#if USE_LIBGVC
+// The Graphviz libraries keep global state in their parser and layout
+// engines, so graphs are rendered one at a time using a shared context.
+static std::mutex g_gvcMutex;
+static GVC_t     *g_gvc = 0;
+#endif
+
+/** Renders all jobs using the Graphviz libraries linked into doxygen, which
+ *  avoids starting the dot executable for each graph. Returns FALSE if
+ *  in-process rendering is not available, busy or failed, in which case the
+ *  dot executable should be used instead.
+ *
+ *  Since the libraries render one graph at a time, a thread does not wait
+ *  for them: while one dot thread renders in-process the other threads start
+ *  dot processes in parallel.
+ */
+bool DotRunner::renderInProcess()
+{
+#if USE_LIBGVC
+  std::unique_lock<std::mutex> lock(g_gvcMutex,std::try_to_lock);
+  if (!lock.owns_lock()) return FALSE;
+  if (g_gvc==0)
+  {
+    g_gvc = gvContext();
+    if (g_gvc==0) return FALSE;
+  }
+  FILE *f = Portable::fopen(m_file.c_str(),"r");
+  if (f==0) return FALSE;
+  Agraph_t *g = agread(f,0);
+  fclose(f);
+  if (g==0) return FALSE;
+  bool ok = gvLayout(g_gvc,g,"dot")==0;
+  if (ok)
+  {
+    for (auto& s : m_jobs)
+    {
+      if (gvRenderFilename(g_gvc,g,s.format.c_str(),s.output.c_str())!=0)
+      {
+        ok = FALSE;
+        break;
+      }
+    }
+    gvFreeLayout(g_gvc,g);
+  }
+  agclose(g);
+  return ok;
+#else
+  return FALSE;
+#endif
+}
+
 bool DotRunner::run()
 {
+  TraceSpan traceSpan("dot",stripPath(m_file.c_str()));
   int exitCode=0;
 
   QCString dotArgs;
 
+  // generated graphs can be taken from the dot cache if all their outputs are there
+  DotCache &dotCache = DotCache::instance();
+  bool useCache = dotCache.isEnabled() && !m_md5Hash.empty();
+  if (useCache && std::all_of(m_jobs.begin(),m_jobs.end(),[&](const DotJob &s)
+        { return dotCache.restore(dotCache.computeKey(m_md5Hash,s.format),s.output); }))
+  {
+    goto done;
+  }
+  if (useCache)
+  {
+    // outputs may be hard links into the cache, so never let dot overwrite them in place
+    for (auto& s : m_jobs)
+    {
+      Portable::unlink(s.output.c_str());
+    }
+  }
+
   // create output
-  if (Config_getBool(DOT_MULTI_TARGETS))
+  if (renderInProcess())
+  {
+    // all outputs were rendered by the Graphviz libraries
+  }
+  else if (Config_getBool(DOT_MULTI_TARGETS))
   {
     dotArgs=QCString("\"")+m_file.data()+"\"";
     for (auto& s: m_jobs)
@@ -214,8 +296,14 @@ bool DotRunner::run()
     {
       checkPngResult(s.output.data());
     }
+
+    if (useCache)
+    {
+      dotCache.store(dotCache.computeKey(m_md5Hash,s.format),s.output);
+    }
   }
 
+done:
   // remove .dot files
   if (m_cleanUp)
   {
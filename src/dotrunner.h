@@ -57,6 +57,8 @@ class DotRunner
     static bool readBoundingBox(const char* fileName, int* width, int* height, bool isEps);
 
   private:
+    bool renderInProcess();
+
     std::string m_file;
     std::string m_md5Hash;
     std::string m_dotExe;
@@ -19,6 +19,8 @@
 #include <errno.h>
 
 #include <algorithm>
+#include <deque>
+#include <functional>
 #include <unordered_map>
 #include <memory>
 #include <cinttypes>
@@ -39,6 +41,8 @@
 #include "dot.h"
 #include "msc.h"
 #include "docparser.h"
+#include "docrootcache.h"
+#include "coderecorder.h"
 #include "dirdef.h"
 #include "outputlist.h"
 #include "declinfo.h"
@@ -105,6 +109,12 @@
 #include "fileinfo.h"
 #include "dir.h"
 #include "conceptdef.h"
+#include "parsecache.h"
+#include "dotcache.h"
+#include "trace.h"
+#include "image.h"
+#include "stringpool.h"
+#include "dircrawler.h"
 
 #if USE_SQLITE3
 #include <sqlite3.h>
@@ -146,7 +156,7 @@ StringMap             Doxygen::tagDestinationMap;            // all tag location
 StringUnorderedSet    Doxygen::expandAsDefinedSet;           // all macros that should be expanded
 MemberGroupInfoMap    Doxygen::memberGroupInfoMap;           // dictionary of the member groups heading
 std::unique_ptr<PageDef> Doxygen::mainPage;
-bool                  Doxygen::insideMainPage = FALSE; // are we generating docs for the main page?
+thread_local bool     Doxygen::insideMainPage = FALSE; // are we generating docs for the main page?
 NamespaceDefMutable  *Doxygen::globalScope = 0;
 bool                  Doxygen::parseSourcesNeeded = FALSE;
 SearchIndexIntf      *Doxygen::searchIndex=0;
@@ -158,10 +168,10 @@ DirLinkedMap         *Doxygen::dirLinkedMap;
 DirRelationLinkedMap  Doxygen::dirRelations;
 ParserManager        *Doxygen::parserManager = 0;
 QCString              Doxygen::htmlFileExtension;
-bool                  Doxygen::suppressDocWarnings = FALSE;
+thread_local bool     Doxygen::suppressDocWarnings = FALSE;
 QCString              Doxygen::filterDBFileName;
 IndexList            *Doxygen::indexList;
-int                   Doxygen::subpageNestingLevel = 0;
+thread_local int      Doxygen::subpageNestingLevel = 0;
 bool                  Doxygen::userComments = FALSE;
 QCString              Doxygen::spaces;
 bool                  Doxygen::generatingXmlOutput = FALSE;
@@ -204,6 +214,23 @@ void clearAll()
   FormulaManager::instance().clear();
 }
 
+/** Adds the counters of the caches to the trace */
+static void traceCacheCounters()
+{
+  if (!Trace::isEnabled()) return;
+  if (Doxygen::lookupCache)
+  {
+    Trace::counter("lookup cache","hits",static_cast<double>(Doxygen::lookupCache->hits()));
+    Trace::counter("lookup cache","misses",static_cast<double>(Doxygen::lookupCache->misses()));
+  }
+  ParseCache::instance().traceStatistics();
+  DocRootCache::instance().traceStatistics();
+  CodeRecordingCache::instance().traceStatistics();
+  DotCache::instance().traceStatistics();
+  Trace::counter("string pool","strings",static_cast<double>(StringPool::count()));
+  Trace::counter("string pool","MB",static_cast<double>(StringPool::size())/(1024.0*1024.0));
+}
+
 class Statistics
 {
   public:
@@ -213,12 +240,20 @@ class Statistics
       msg("%s", name);
       stats.emplace_back(name,0);
       startTime = std::chrono::steady_clock::now();
+      if (Trace::isEnabled())
+      {
+        QCString phase = QCString(name).stripWhiteSpace();
+        if (phase.right(3)=="...") phase.truncate(phase.length()-3);
+        Trace::begin("phase",phase);
+      }
     }
     void end()
     {
       std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
       stats.back().elapsed = std::chrono::duration_cast<
                                 std::chrono::microseconds>(endTime - startTime).count()/1000000.0;
+      traceCacheCounters();
+      Trace::end("phase");
     }
     void print()
     {
@@ -7884,87 +7919,156 @@ static void generateFileSources()
     else
 #endif
     {
-#define MULTITHREADED_SOURCE_GENERATOR 0 // not ready to be enabled yet
-#if MULTITHREADED_SOURCE_GENERATOR
       std::size_t numThreads = static_cast<std::size_t>(Config_getInt(NUM_PROC_THREADS));
       if (numThreads==0)
       {
         numThreads = std::thread::hardware_concurrency();
       }
-      msg("Generating code files using %zu threads.\n",numThreads);
-      struct SourceContext
-      {
-        SourceContext(FileDef *fd_,bool gen_,OutputList ol_)
-          : fd(fd_), generateSourceFile(gen_), ol(ol_) {}
-        FileDef *fd;
-        bool generateSourceFile;
-        OutputList ol;
-      };
-      ThreadPool threadPool(numThreads);
-      std::vector< std::future< std::shared_ptr<SourceContext> > > results;
-      for (const auto &fn : *Doxygen::inputNameLinkedMap)
+      if (numThreads>1) // multi threaded version
       {
-        for (const auto &fd : *fn)
+        msg("Generating code files using %zu threads.\n",numThreads);
+        struct SourceContext
         {
-          bool generateSourceFile = fd->generateSourceFile() && !Htags::useHtags && !g_useOutputTemplate;
-          auto ctx = std::make_shared<SourceContext>(fd.get(),generateSourceFile,*g_outputList);
-          if (generateSourceFile)
-          {
-            msg("Generating code for file %s...\n",fd->docName().data());
-            fd->writeSourceHeader(ctx->ol);
-          }
-          else
+          SourceContext(FileDef *fd_,bool gen_,OutputList ol_)
+            : fd(fd_), generateSourceFile(gen_), ol(ol_) {}
+          FileDef *fd;
+          bool generateSourceFile;
+          OutputList ol;
+        };
+        // each file that is being generated keeps its output files open,
+        // so limit the number of files that are in flight at the same time.
+        const std::size_t maxPending = 4*numThreads;
+        ThreadPool threadPool(numThreads);
+        std::deque< std::future<void> > results;
+        for (const auto &fn : *Doxygen::inputNameLinkedMap)
+        {
+          for (const auto &fd : *fn)
           {
-            msg("Parsing code for file %s...\n",fd->docName().data());
-          }
-          auto processFile = [ctx]() {
-            StringVector filesInSameTu;
-            ctx->fd->getAllIncludeFilesRecursively(filesInSameTu);
-            if (ctx->generateSourceFile) // sources need to be shown in the output
+            bool generateSourceFile = fd->generateSourceFile() && !Htags::useHtags && !g_useOutputTemplate;
+            if (!generateSourceFile && (fd->isReference() || !Doxygen::parseSourcesNeeded))
             {
-              ctx->fd->writeSourceBody(ctx->ol,nullptr);
+              continue;
             }
-            else if (!ctx->fd->isReference() && Doxygen::parseSourcesNeeded)
-              // we needed to parse the sources even if we do not show them
+            auto ctx = std::make_shared<SourceContext>(fd.get(),generateSourceFile,*g_outputList);
+            if (generateSourceFile)
+            {
+              // the header is written here, so the files are added to the index in a fixed order
+              msg("Generating code for file %s...\n",fd->docName().data());
+              fd->writeSourceHeader(ctx->ol);
+            }
+            else
+            {
+              msg("Parsing code for file %s...\n",fd->docName().data());
+            }
+            auto processFile = [ctx]() {
+              TraceSpan traceSpan("source",ctx->fd->docName());
+              StringVector filesInSameTu;
+              ctx->fd->getAllIncludeFilesRecursively(filesInSameTu);
+              if (ctx->generateSourceFile) // sources need to be shown in the output
+              {
+                ctx->fd->writeSourceBody(ctx->ol,nullptr);
+                ctx->fd->writeSourceFooter(ctx->ol);
+              }
+              else // we needed to parse the sources even if we do not show them
+              {
+                ctx->fd->parseSource(nullptr);
+              }
+            };
+            if (fd->getLanguage()==SrcLangExt_VHDL)
             {
-              ctx->fd->parseSource(nullptr);
+              // the VHDL code parser uses global state, so it runs on this thread only
+              processFile();
             }
-            return ctx;
-          };
-          results.emplace_back(threadPool.queue(processFile));
+            else
+            {
+              results.emplace_back(threadPool.queue(processFile));
+              if (results.size()>maxPending)
+              {
+                results.front().get();
+                results.pop_front();
+              }
+            }
+          }
         }
-      }
-      for (auto &f : results)
-      {
-        auto ctx = f.get();
-        if (ctx->generateSourceFile)
+        for (auto &f : results)
         {
-          ctx->fd->writeSourceFooter(ctx->ol);
+          f.get();
         }
       }
-#else // single threaded version
-      for (const auto &fn : *Doxygen::inputNameLinkedMap)
+      else // single threaded version
       {
-        for (const auto &fd : *fn)
+        for (const auto &fn : *Doxygen::inputNameLinkedMap)
         {
-          StringVector filesInSameTu;
-          fd->getAllIncludeFilesRecursively(filesInSameTu);
-          if (fd->generateSourceFile() && !Htags::useHtags && !g_useOutputTemplate) // sources need to be shown in the output
-          {
-            msg("Generating code for file %s...\n",fd->docName().data());
-            fd->writeSourceHeader(*g_outputList);
-            fd->writeSourceBody(*g_outputList,nullptr);
-            fd->writeSourceFooter(*g_outputList);
-          }
-          else if (!fd->isReference() && Doxygen::parseSourcesNeeded)
-            // we needed to parse the sources even if we do not show them
+          for (const auto &fd : *fn)
           {
-            msg("Parsing code for file %s...\n",fd->docName().data());
-            fd->parseSource(nullptr);
+            StringVector filesInSameTu;
+            fd->getAllIncludeFilesRecursively(filesInSameTu);
+            if (fd->generateSourceFile() && !Htags::useHtags && !g_useOutputTemplate) // sources need to be shown in the output
+            {
+              msg("Generating code for file %s...\n",fd->docName().data());
+              fd->writeSourceHeader(*g_outputList);
+              fd->writeSourceBody(*g_outputList,nullptr);
+              fd->writeSourceFooter(*g_outputList);
+            }
+            else if (!fd->isReference() && Doxygen::parseSourcesNeeded)
+              // we needed to parse the sources even if we do not show them
+            {
+              msg("Parsing code for file %s...\n",fd->docName().data());
+              fd->parseSource(nullptr);
+            }
           }
         }
       }
-#endif
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+
+/** A job that writes one or more documentation pages to an output list */
+using DocJob = std::function<void(OutputList &)>;
+
+/** Runs the given documentation jobs. When multiple threads may be used the
+ *  jobs are distributed over a thread pool and each job writes to its own copy
+ *  of the output list, otherwise the jobs are run in order on g_outputList.
+ */
+static void runDocJobs(const std::vector<DocJob> &jobs)
+{
+  std::size_t numThreads = static_cast<std::size_t>(Config_getInt(NUM_PROC_THREADS));
+  if (numThreads==0)
+  {
+    numThreads = std::thread::hardware_concurrency();
+  }
+  if (numThreads>1 && jobs.size()>1) // multi threaded version
+  {
+    ThreadPool threadPool(std::min(numThreads,jobs.size()));
+    std::vector< std::future<void> > results;
+    // the index entries of each job are added in the order of the jobs,
+    // so the indices are the same as with a single thread.
+    std::vector<IndexList::Recording> recordings(jobs.size());
+    for (size_t i=0;i<jobs.size();i++)
+    {
+      auto ol = std::make_shared<OutputList>(*g_outputList);
+      const DocJob &job = jobs[i];
+      IndexList::Recording &recording = recordings[i];
+      results.emplace_back(threadPool.queue([ol,&job,&recording]()
+      {
+        recording.start();
+        job(*ol);
+        recording.stop();
+      }));
+    }
+    for (size_t i=0;i<results.size();i++)
+    {
+      results[i].get();
+      recordings[i].replay();
+    }
+  }
+  else // single threaded version
+  {
+    for (const auto &job : jobs)
+    {
+      job(*g_outputList);
     }
   }
 }
@@ -7975,21 +8079,24 @@ static void generateFileDocs()
 {
   if (documentedHtmlFiles==0) return;
 
-  if (!Doxygen::inputNameLinkedMap->empty())
+  std::vector<DocJob> jobs;
+  for (const auto &fn : *Doxygen::inputNameLinkedMap)
   {
-    for (const auto &fn : *Doxygen::inputNameLinkedMap)
+    for (const auto &fd : *fn)
     {
-      for (const auto &fd : *fn)
+      bool doc = fd->isLinkableInProject();
+      if (doc)
       {
-        bool doc = fd->isLinkableInProject();
-        if (doc)
+        FileDef *fdp = fd.get();
+        jobs.push_back([fdp](OutputList &ol)
         {
-          msg("Generating docs for file %s...\n",fd->docName().data());
-          fd->writeDocumentation(*g_outputList);
-        }
+          msg("Generating docs for file %s...\n",fdp->docName().data());
+          fdp->writeDocumentation(ol);
+        });
       }
     }
   }
+  runDocJobs(jobs);
 }
 
 //----------------------------------------------------------------------------
@@ -8222,7 +8329,7 @@ static void countMembers()
 //----------------------------------------------------------------------------
 // generate the documentation of all classes
 
-static void generateClassList(const ClassLinkedMap &classList)
+static void generateClassList(const ClassLinkedMap &classList,std::vector<DocJob> &jobs)
 {
   for (const auto &cdi : classList)
   {
@@ -8235,31 +8342,37 @@ static void generateClassList(const ClassLinkedMap &classList)
         ) && !cd->isHidden() && !cd->isEmbeddedInOuterScope()
        )
     {
-      // skip external references, anonymous compounds and
-      // template instances
-      if ( cd->isLinkableInProject() && cd->templateMaster()==0)
+      jobs.push_back([cd](OutputList &ol)
       {
-        msg("Generating docs for compound %s...\n",cd->name().data());
+        // skip external references, anonymous compounds and
+        // template instances
+        if ( cd->isLinkableInProject() && cd->templateMaster()==0)
+        {
+          msg("Generating docs for compound %s...\n",cd->name().data());
 
-        cd->writeDocumentation(*g_outputList);
-        cd->writeMemberList(*g_outputList);
-      }
-      // even for undocumented classes, the inner classes can be documented.
-      cd->writeDocumentationForInnerClasses(*g_outputList);
+          cd->writeDocumentation(ol);
+          cd->writeMemberList(ol);
+        }
+        // even for undocumented classes, the inner classes can be documented.
+        cd->writeDocumentationForInnerClasses(ol);
+      });
     }
   }
 }
 
 static void generateClassDocs()
 {
-  generateClassList(*Doxygen::classLinkedMap);
-  generateClassList(*Doxygen::hiddenClassLinkedMap);
+  std::vector<DocJob> jobs;
+  generateClassList(*Doxygen::classLinkedMap,jobs);
+  generateClassList(*Doxygen::hiddenClassLinkedMap,jobs);
+  runDocJobs(jobs);
 }
 
 //----------------------------------------------------------------------------
 
 static void generateConceptDocs()
 {
+  std::vector<DocJob> jobs;
   for (const auto &cdi : *Doxygen::conceptLinkedMap)
   {
     ConceptDefMutable *cd=toConceptDefMutable(cdi.get());
@@ -8271,10 +8384,14 @@ static void generateConceptDocs()
         ) && !cd->isHidden() && cd->isLinkableInProject()
        )
     {
-      msg("Generating docs for concept %s...\n",cd->name().data());
-      cd->writeDocumentation(*g_outputList);
+      jobs.push_back([cd](OutputList &ol)
+      {
+        msg("Generating docs for concept %s...\n",cd->name().data());
+        cd->writeDocumentation(ol);
+      });
     }
   }
+  runDocJobs(jobs);
 }
 
 //----------------------------------------------------------------------------
@@ -8469,19 +8586,8 @@ static void flushCachedTemplateRelations()
   // as there can be new template instances in the inheritance path
   // to this class. Optimization: only remove those classes that
   // have inheritance instances as direct or indirect sub classes.
-  StringVector elementsToRemove;
-  for (const auto &ci : *Doxygen::lookupCache)
-  {
-    const LookupInfo &li = ci.second;
-    if (li.classDef)
-    {
-      elementsToRemove.push_back(ci.first);
-    }
-  }
-  for (const auto &k : elementsToRemove)
-  {
-    Doxygen::lookupCache->remove(k);
-  }
+  Doxygen::lookupCache->removeIf([](const std::string &,const LookupInfo &li)
+                                  { return li.classDef!=0; });
 
   // remove all cached typedef resolutions whose target is a
   // template class as this may now be a template instance
@@ -8529,19 +8635,8 @@ static void flushUnresolvedRelations()
   // class B : public A {};
   // class C : public B::I {};
 
-  StringVector elementsToRemove;
-  for (const auto &ci : *Doxygen::lookupCache)
-  {
-    const LookupInfo &li = ci.second;
-    if (li.classDef==0 && li.typeDef==0)
-    {
-      elementsToRemove.push_back(ci.first);
-    }
-  }
-  for (const auto &k : elementsToRemove)
-  {
-    Doxygen::lookupCache->remove(k);
-  }
+  Doxygen::lookupCache->removeIf([](const std::string &,const LookupInfo &li)
+                                  { return li.classDef==0 && li.typeDef==0; });
 
   // for each global function name
   for (const auto &fn : *Doxygen::functionNameLinkedMap)
@@ -8981,16 +9076,22 @@ static void generatePageDocs()
 {
   //printf("documentedPages=%d real=%d\n",documentedPages,Doxygen::pageLinkedMap->count());
   if (documentedPages==0) return;
+  std::vector<DocJob> jobs;
   for (const auto &pd : *Doxygen::pageLinkedMap)
   {
     if (!pd->getGroupDef() && !pd->isReference())
     {
-      msg("Generating docs for page %s...\n",pd->name().data());
-      Doxygen::insideMainPage=TRUE;
-      pd->writeDocumentation(*g_outputList);
-      Doxygen::insideMainPage=FALSE;
+      PageDef *pdp = pd.get();
+      jobs.push_back([pdp](OutputList &ol)
+      {
+        msg("Generating docs for page %s...\n",pdp->name().data());
+        Doxygen::insideMainPage=TRUE;
+        pdp->writeDocumentation(ol);
+        Doxygen::insideMainPage=FALSE;
+      });
     }
   }
+  runDocJobs(jobs);
 }
 
 //----------------------------------------------------------------------------
@@ -9089,19 +9190,22 @@ static void generateExampleDocs()
 
 static void generateGroupDocs()
 {
+  std::vector<DocJob> jobs;
   for (const auto &gd : *Doxygen::groupLinkedMap)
   {
     if (!gd->isReference())
     {
-      gd->writeDocumentation(*g_outputList);
+      GroupDef *gdp = gd.get();
+      jobs.push_back([gdp](OutputList &ol) { gdp->writeDocumentation(ol); });
     }
   }
+  runDocJobs(jobs);
 }
 
 //----------------------------------------------------------------------------
 // generate module pages
 
-static void generateNamespaceClassDocs(const ClassLinkedRefMap &classList)
+static void generateNamespaceClassDocs(const ClassLinkedRefMap &classList,std::vector<DocJob> &jobs)
 {
   // for each class in the namespace...
   for (const auto &cd : classList)
@@ -9109,24 +9213,27 @@ static void generateNamespaceClassDocs(const ClassLinkedRefMap &classList)
     ClassDefMutable *cdm = toClassDefMutable(cd);
     if (cdm)
     {
-      if ( ( cd->isLinkableInProject() &&
-             cd->templateMaster()==0
-           ) // skip external references, anonymous compounds and
-          // template instances and nested classes
-          && !cd->isHidden() && !cd->isEmbeddedInOuterScope()
-         )
+      jobs.push_back([cdm](OutputList &ol)
       {
-        msg("Generating docs for compound %s...\n",cd->name().data());
+        if ( ( cdm->isLinkableInProject() &&
+               cdm->templateMaster()==0
+             ) // skip external references, anonymous compounds and
+            // template instances and nested classes
+            && !cdm->isHidden() && !cdm->isEmbeddedInOuterScope()
+           )
+        {
+          msg("Generating docs for compound %s...\n",cdm->name().data());
 
-        cdm->writeDocumentation(*g_outputList);
-        cdm->writeMemberList(*g_outputList);
-      }
-      cdm->writeDocumentationForInnerClasses(*g_outputList);
+          cdm->writeDocumentation(ol);
+          cdm->writeMemberList(ol);
+        }
+        cdm->writeDocumentationForInnerClasses(ol);
+      });
     }
   }
 }
 
-static void generateNamespaceConceptDocs(const ConceptLinkedRefMap &conceptList)
+static void generateNamespaceConceptDocs(const ConceptLinkedRefMap &conceptList,std::vector<DocJob> &jobs)
 {
   // for each concept in the namespace...
   for (const auto &cd : conceptList)
@@ -9134,8 +9241,11 @@ static void generateNamespaceConceptDocs(const ConceptLinkedRefMap &conceptList)
     ConceptDefMutable *cdm = toConceptDefMutable(cd);
     if ( cdm && cd->isLinkableInProject() && !cd->isHidden())
     {
-      msg("Generating docs for concept %s...\n",cd->name().data());
-      cdm->writeDocumentation(*g_outputList);
+      jobs.push_back([cdm](OutputList &ol)
+      {
+        msg("Generating docs for concept %s...\n",cdm->name().data());
+        cdm->writeDocumentation(ol);
+      });
     }
   }
 }
@@ -9146,6 +9256,7 @@ static void generateNamespaceDocs()
 
   //writeNamespaceIndex(*g_outputList);
 
+  std::vector<DocJob> jobs;
   // for each namespace...
   for (const auto &nd : *Doxygen::namespaceLinkedMap)
   {
@@ -9154,20 +9265,24 @@ static void generateNamespaceDocs()
       NamespaceDefMutable *ndm = toNamespaceDefMutable(nd.get());
       if (ndm)
       {
-        msg("Generating docs for namespace %s\n",nd->name().data());
-        ndm->writeDocumentation(*g_outputList);
+        jobs.push_back([ndm](OutputList &ol)
+        {
+          msg("Generating docs for namespace %s\n",ndm->name().data());
+          ndm->writeDocumentation(ol);
+        });
       }
     }
 
-    generateNamespaceClassDocs(nd->getClasses());
+    generateNamespaceClassDocs(nd->getClasses(),jobs);
     if (sliceOpt)
     {
-      generateNamespaceClassDocs(nd->getInterfaces());
-      generateNamespaceClassDocs(nd->getStructs());
-      generateNamespaceClassDocs(nd->getExceptions());
+      generateNamespaceClassDocs(nd->getInterfaces(),jobs);
+      generateNamespaceClassDocs(nd->getStructs(),jobs);
+      generateNamespaceClassDocs(nd->getExceptions(),jobs);
     }
-    generateNamespaceConceptDocs(nd->getConcepts());
+    generateNamespaceConceptDocs(nd->getConcepts(),jobs);
   }
+  runDocJobs(jobs);
 }
 
 #if defined(_WIN32)
@@ -9497,10 +9612,44 @@ static std::unique_ptr<OutlineParserInterface> getParserForFile(const char *fn)
   return Doxygen::parserManager->getOutlineParser(extension);
 }
 
+/** @brief Buffer that is reused for all input files parsed by the same thread.
+ *
+ *  This avoids allocating (and page faulting) buffers the size of each input
+ *  file three times per file. After use the memory is only released if a
+ *  large file made the buffer grow beyond maxKeepSize.
+ */
+class ScratchBuffer
+{
+  public:
+    ScratchBuffer(BufStr &buf,uint size) : m_buf(buf)
+    {
+      m_buf.clear();
+      if (m_buf.size()<size) m_buf.resize(size);
+    }
+   ~ScratchBuffer()
+    {
+      if (m_buf.size()>maxKeepSize)
+      {
+        m_buf.shrink(0);
+      }
+      else
+      {
+        m_buf.clear();
+      }
+    }
+    BufStr &get() { return m_buf; }
+  private:
+    static const uint maxKeepSize = 16*1024*1024;
+    BufStr &m_buf;
+};
+
 static std::shared_ptr<Entry> parseFile(OutlineParserInterface &parser,
                       FileDef *fd,const char *fn,
                       ClangTUParser *clangParser,bool newTU)
 {
+  TraceSpan traceSpan("parse",fn);
+  static thread_local BufStr t_inBuf(0), t_preBuf(0), t_convBuf(0);
+
   QCString fileName=fn;
   QCString extension;
   int ei = fileName.findRev('.');
@@ -9514,34 +9663,67 @@ static std::shared_ptr<Entry> parseFile(OutlineParserInterface &parser,
   }
 
   FileInfo fi(fileName.str());
-  BufStr preBuf((uint)fi.size()+4096);
-
+  ScratchBuffer preScratch(t_preBuf,(uint)fi.size()+4096);
+  BufStr &preBuf = preScratch.get();
+
+  ParseCache &parseCache = ParseCache::instance();
+  bool useCache = parseCache.isEnabled() && clangParser==0 &&
+                  getLanguageFromFileName(fileName)!=SrcLangExt_VHDL;
+  QCString cacheKey;
+  std::unique_ptr<Preprocessor> preprocessor;
   if (Config_getBool(ENABLE_PREPROCESSING) &&
       parser.needsPreprocessing(extension))
   {
-    Preprocessor preprocessor;
+    ScratchBuffer inScratch(t_inBuf,(uint)fi.size()+4096);
+    BufStr &inBuf = inScratch.get();
+    readInputFile(fileName,inBuf);
+    if (useCache)
+    {
+      cacheKey = parseCache.computeKey(fn,inBuf.data(),inBuf.curPos());
+      std::shared_ptr<Entry> fileRoot = parseCache.restore(cacheKey,fn,fd);
+      if (fileRoot)
+      {
+        msg("Restoring %s from parse cache...\n",fn);
+        fileRoot->setFileDef(fd);
+        return fileRoot;
+      }
+    }
+    preprocessor = std::make_unique<Preprocessor>();
     const StringVector &includePath = Config_getList(INCLUDE_PATH);
     for (const auto &s : includePath)
     {
       std::string absPath = FileInfo(s).absFilePath();
-      preprocessor.addSearchDir(absPath.c_str());
+      preprocessor->addSearchDir(absPath.c_str());
     }
-    BufStr inBuf((uint)fi.size()+4096);
     msg("Preprocessing %s...\n",fn);
-    readInputFile(fileName,inBuf);
-    preprocessor.processFile(fileName,inBuf,preBuf);
+    ParseCache::startFile();
+    preprocessor->processFile(fileName,inBuf,preBuf);
   }
   else // no preprocessing
   {
-    msg("Reading %s...\n",fn);
     readInputFile(fileName,preBuf);
+    if (useCache)
+    {
+      cacheKey = parseCache.computeKey(fn,preBuf.data(),preBuf.curPos());
+      std::shared_ptr<Entry> fileRoot = parseCache.restore(cacheKey,fn,fd);
+      if (fileRoot)
+      {
+        msg("Restoring %s from parse cache...\n",fn);
+        fileRoot->setFileDef(fd);
+        return fileRoot;
+      }
+    }
+    msg("Reading %s...\n",fn);
+    ParseCache::startFile();
   }
   if (preBuf.data() && preBuf.curPos()>0 && *(preBuf.data()+preBuf.curPos()-1)!='\n')
   {
     preBuf.addChar('\n'); // add extra newline to help parser
   }
+  preBuf.at(preBuf.curPos())='\0'; // the reused buffer may still hold data of a previous file
 
-  BufStr convBuf(preBuf.curPos()+1024);
+  ScratchBuffer convScratch(t_convBuf,preBuf.curPos()+1024);
+  BufStr &convBuf = convScratch.get();
 
   // convert multi-line C++ comments to C style comments
   convertCppComments(&preBuf,&convBuf,fileName);
@@ -9556,6 +9738,10 @@ static std::shared_ptr<Entry> parseFile(OutlineParserInterface &parser,
     clangParser->switchToFile(fd);
   }
   parser.parseInput(fileName,convBuf.data(),fileRoot,clangParser);
+  if (useCache)
+  {
+    parseCache.store(cacheKey,fn,fd,fileRoot,preprocessor.get());
+  }
   fileRoot->setFileDef(fd);
   return fileRoot;
 }
@@ -9676,28 +9862,70 @@ static void parseFilesMultiThreading(const std::shared_ptr<Entry> &root)
   else // normal processing
 #endif
   {
-    std::size_t numThreads = std::thread::hardware_concurrency();
+    std::size_t numThreads = static_cast<std::size_t>(Config_getInt(NUM_PROC_THREADS));
+    if (numThreads==0)
+    {
+      numThreads = std::thread::hardware_concurrency();
+    }
     msg("Processing input using %zu threads.\n",numThreads);
+
+    // start with the largest files, so a big file at the end of the input
+    // does not determine the total processing time
+    std::vector<size_t> order(g_inputFiles.size());
+    std::vector<size_t> fileSizes(g_inputFiles.size());
+    for (size_t i=0;i<g_inputFiles.size();i++)
+    {
+      order[i] = i;
+      fileSizes[i] = FileInfo(g_inputFiles[i]).size();
+    }
+    std::stable_sort(order.begin(),order.end(),
+        [&fileSizes](size_t i1,size_t i2) { return fileSizes[i1]>fileSizes[i2]; });
+
+    struct ParseResult
+    {
+      std::shared_ptr<Entry> root;
+      double elapsed = 0.0;
+    };
     ThreadPool threadPool(numThreads);
-    using FutureType = std::shared_ptr<Entry>;
-    std::vector< std::future< FutureType > > results;
-    for (const auto &s : g_inputFiles)
+    std::vector< std::future< ParseResult > > results(g_inputFiles.size());
+    for (size_t i : order)
     {
+      const std::string &s = g_inputFiles[i];
       // lambda representing the work to executed by a thread
       auto processFile = [s]() {
+        auto startTime = std::chrono::steady_clock::now();
         bool ambig;
         FileDef *fd=findFileDef(Doxygen::inputNameLinkedMap,s.c_str(),ambig);
         auto parser = getParserForFile(s.c_str());
-        auto fileRoot = parseFile(*parser.get(),fd,s.c_str(),nullptr,true);
-        return fileRoot;
+        ParseResult result;
+        result.root = parseFile(*parser.get(),fd,s.c_str(),nullptr,true);
+        result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                              std::chrono::steady_clock::now()-startTime).count()/1000000.0;
+        return result;
       };
       // dispatch the work and collect the future results
-      results.emplace_back(threadPool.queue(processFile));
+      results[i] = threadPool.queue(processFile);
     }
-    // synchronise with the Entry results produced and add them to the root
-    for (auto &f : results)
+    // synchronise with the Entry results produced and add them to the root,
+    // keeping the order of the input files
+    std::vector< std::pair<double,size_t> > parseTimes;
+    for (size_t i=0;i<results.size();i++)
+    {
+      ParseResult result = results[i].get();
+      parseTimes.emplace_back(result.elapsed,i);
+      root->moveToSubEntryAndKeep(result.root);
+    }
+    if (Debug::isFlagSet(Debug::Time))
     {
-      root->moveToSubEntryAndKeep(f.get());
+      std::sort(parseTimes.begin(),parseTimes.end(),
+          [](const std::pair<double,size_t> &p1,const std::pair<double,size_t> &p2)
+          { return p1.first>p2.first; });
+      Debug::print(Debug::Time,0,"Parse time per input file (slowest first):\n");
+      for (const auto &pt : parseTimes)
+      {
+        Debug::print(Debug::Time,0,"  %.6f seconds for %s (%zu bytes)\n",
+            pt.first,g_inputFiles[pt.second].c_str(),fileSizes[pt.second]);
+      }
     }
   }
 }
@@ -9851,17 +10079,37 @@ static QCString resolveSymlink(QCString path)
 static std::mutex g_pathsVisitedMutex;
 static StringUnorderedSet g_pathsVisited(1009);
 
+//----------------------------------------------------------------------------
+// Returns a filter that selects the subdirectories that readDir() descends
+// into, so the crawler can read them in advance.
+
+static DirCrawler::DescendFilter makeDescendFilter(bool recursive,
+            const std::shared_ptr<PatternMatcher> &exclPatMatcher)
+{
+  bool excludeSymLinks = Config_getBool(EXCLUDE_SYMLINKS);
+  return [recursive,excludeSymLinks,exclPatMatcher](const CrawledEntry &e)
+  {
+    return recursive && e.exists && e.isReadable && e.isDir &&
+           (!excludeSymLinks || !e.isSymLink) &&
+           (!exclPatMatcher || !exclPatMatcher->match(e.fileName,e.filePath,e.absFilePath)) &&
+           e.fileName.at(0)!='.';
+  };
+}
+
 //----------------------------------------------------------------------------
 // Read all files matching at least one pattern in 'patList' in the
-// directory represented by 'fi'.
+// directory with absolute path 'absDirName'.
 // The directory is read iff the recursiveFlag is set.
 // The contents of all files is append to the input string
 
-static void readDir(FileInfo *fi,
+static void readDir(const std::string &absDirName,
+            bool isSymLink,
+            DirCrawler &crawler,
+            const DirCrawler::DescendFilter &descend,
             FileNameLinkedMap *fnMap,
             StringUnorderedSet *exclSet,
-            const StringVector *patList,
-            const StringVector *exclPatList,
+            const PatternMatcher *patMatcher,
+            const PatternMatcher *exclPatMatcher,
             StringVector *resultList,
             StringUnorderedSet *resultSet,
             bool errorIfNotExist,
@@ -9870,12 +10118,12 @@ static void readDir(FileInfo *fi,
             StringSet *paths
            )
 {
-  std::string dirName = fi->absFilePath();
+  std::string dirName = absDirName;
   if (paths && !dirName.empty())
   {
     paths->insert(dirName);
   }
-  if (fi->isSymLink())
+  if (isSymLink)
   {
     dirName = resolveSymlink(dirName);
     if (dirName.empty()) return;  // recursive symlink
@@ -9884,54 +10132,55 @@ static void readDir(FileInfo *fi,
     if (g_pathsVisited.find(dirName)!=g_pathsVisited.end()) return; // already visited path
     g_pathsVisited.insert(dirName);
   }
-  Dir dir(dirName);
-  msg("Searching for files in directory %s\n", fi->absFilePath().data());
+  msg("Searching for files in directory %s\n", absDirName.c_str());
   //printf("killSet=%p count=%d\n",killSet,killSet ? (int)killSet->count() : -1);
 
-  for (const auto &dirEntry : dir.iterator())
+  const std::vector<CrawledEntry> &entries = crawler.entries(dirName);
+  // start reading the subdirectories we will visit in the background
+  for (const auto &cfi : entries)
+  {
+    if (descend(cfi)) crawler.prefetch(cfi.absFilePath,descend);
+  }
+
+  for (const auto &cfi : entries)
   {
-    FileInfo cfi(dirEntry.path());
-    if (exclSet==0 || exclSet->find(cfi.absFilePath())==exclSet->end())
+    if (exclSet==0 || exclSet->find(cfi.absFilePath)==exclSet->end())
     { // file should not be excluded
-      //printf("killSet->find(%s)\n",cfi->absFilePath().data());
-      if (!cfi.exists() || !cfi.isReadable())
+      //printf("killSet->find(%s)\n",cfi.absFilePath.c_str());
+      if (!cfi.exists || !cfi.isReadable)
       {
         if (errorIfNotExist)
         {
-          warn_uncond("source '%s' is not a readable file or directory... skipping.\n",cfi.absFilePath().c_str());
+          warn_uncond("source '%s' is not a readable file or directory... skipping.\n",cfi.absFilePath.c_str());
         }
       }
-      else if (cfi.isFile() &&
-          (!Config_getBool(EXCLUDE_SYMLINKS) || !cfi.isSymLink()) &&
-          (patList==0 || patternMatch(cfi,*patList)) &&
-          (exclPatList==0 || !patternMatch(cfi,*exclPatList)) &&
-          (killSet==0 || killSet->find(cfi.absFilePath())==killSet->end())
+      else if (cfi.isFile &&
+          (!Config_getBool(EXCLUDE_SYMLINKS) || !cfi.isSymLink) &&
+          (patMatcher==0 || patMatcher->match(cfi.fileName,cfi.filePath,cfi.absFilePath)) &&
+          (exclPatMatcher==0 || !exclPatMatcher->match(cfi.fileName,cfi.filePath,cfi.absFilePath)) &&
+          (killSet==0 || killSet->find(cfi.absFilePath)==killSet->end())
           )
       {
-        std::string name=cfi.fileName();
+        const std::string &name=cfi.fileName;
         if (fnMap)
         {
-          std::unique_ptr<FileDef> fd { createFileDef(cfi.dirPath()+"/",name) };
+          std::unique_ptr<FileDef> fd { createFileDef(cfi.dirPath+"/",name) };
           FileName *fn=0;
           if (!name.empty())
           {
-            fn = fnMap->add(name.c_str(),cfi.absFilePath().c_str());
+            fn = fnMap->add(name.c_str(),cfi.absFilePath.c_str());
             fn->push_back(std::move(fd));
           }
         }
-        if (resultList) resultList->push_back(cfi.absFilePath());
-        if (resultSet) resultSet->insert(cfi.absFilePath());
-        if (killSet) killSet->insert(cfi.absFilePath());
+        if (resultList) resultList->push_back(cfi.absFilePath);
+        if (resultSet) resultSet->insert(cfi.absFilePath);
+        if (killSet) killSet->insert(cfi.absFilePath);
       }
-      else if (recursive &&
-          (!Config_getBool(EXCLUDE_SYMLINKS) || !cfi.isSymLink()) &&
-          cfi.isDir() &&
-          (exclPatList==0 || !patternMatch(cfi,*exclPatList)) &&
-          cfi.fileName().at(0)!='.') // skip "." ".." and ".dir"
+      else if (descend(cfi)) // skips "." ".." and ".dir"
       {
-        FileInfo acfi(cfi.absFilePath());
-        readDir(&acfi,fnMap,exclSet,
-            patList,exclPatList,resultList,resultSet,errorIfNotExist,
+        // the absolute path is canonical, so it is not a symlink itself
+        readDir(cfi.absFilePath,false,crawler,descend,fnMap,exclSet,
+            patMatcher,exclPatMatcher,resultList,resultSet,errorIfNotExist,
             recursive,killSet,paths);
       }
     }
@@ -9953,7 +10202,8 @@ void readFileOrDirectory(const char *s,
                         bool recursive,
                         bool errorIfNotExist,
                         StringUnorderedSet *killSet,
-                        StringSet *paths
+                        StringSet *paths,
+                        DirCrawler *crawler
                        )
 {
   //printf("killSet count=%d\n",killSet ? (int)killSet->size() : -1);
@@ -10006,8 +10256,21 @@ void readFileOrDirectory(const char *s,
         }
         else if (fi.isDir()) // readable dir
         {
-          readDir(&fi,fnMap,exclSet,patList,
-              exclPatList,resultList,resultSet,errorIfNotExist,
+          // the patterns are analysed once for the whole directory tree
+          std::unique_ptr<PatternMatcher> patMatcher;
+          std::shared_ptr<PatternMatcher> exclPatMatcher;
+          if (patList)     patMatcher     = std::make_unique<PatternMatcher>(*patList);
+          if (exclPatList) exclPatMatcher = std::make_shared<PatternMatcher>(*exclPatList);
+          std::unique_ptr<DirCrawler> localCrawler;
+          if (crawler==0)
+          {
+            localCrawler = std::make_unique<DirCrawler>(1);
+            crawler = localCrawler.get();
+          }
+          readDir(fi.absFilePath(),fi.isSymLink(),*crawler,
+              makeDescendFilter(recursive,exclPatMatcher),
+              fnMap,exclSet,patMatcher.get(),
+              exclPatMatcher.get(),resultList,resultSet,errorIfNotExist,
               recursive,killSet,paths);
         }
       }
@@ -10146,6 +10409,7 @@ static void devUsage()
   msg("  -m          dump symbol map\n");
   msg("  -b          output to wizard\n");
   msg("  -T          activates output generation via Django like template\n");
+  msg("  -t <file>   write a trace of the run to file, which can be viewed with Perfetto\n");
   msg("  -d <level>  enable a debug level, such as (multiple invocations of -d are possible):\n");
   Debug::printFlags();
 }
@@ -10171,9 +10435,9 @@ static void version(const bool extended)
     extVers += "clang support ";
     extVers += CLANG_VERSION_STRING;
 #endif
-#if MULTITHREADED_SOURCE_GENERATOR
+#if USE_LIBGVC
     if (!extVers.isEmpty()) extVers+= ", ";
-    extVers += "multi-threaded support ";
+    extVers += "in-process graphviz rendering";
 #endif
     if (!extVers.isEmpty())
     {
@@ -10391,6 +10655,7 @@ void readConfiguration(int argc, char **argv)
   const char *debugLabel;
   const char *formatName;
   const char *listName;
+  const char *traceName;
   bool genConfig=FALSE;
   bool shortList=FALSE;
   bool diffList=FALSE;
@@ -10683,6 +10948,16 @@ void readConfiguration(int argc, char **argv)
             "Only use if you are a doxygen developer\n");
         g_useOutputTemplate=TRUE;
         break;
+      case 't':
+        traceName=getArg(argc,argv,optind);
+        if (!traceName)
+        {
+          err("option \"-t\" is missing a file name.\n");
+          cleanUpDoxygen();
+          exit(1);
+        }
+        Trace::start(traceName);
+        break;
       case 'h':
       case '?':
         usage(argv[0],versionString);
@@ -10889,7 +11164,7 @@ static void writeTagFile()
   QCString generateTagFile = Config_getString(GENERATE_TAGFILE);
   if (generateTagFile.isEmpty()) return;
 
-  std::ofstream f(generateTagFile.str(),std::ofstream::out | std::ofstream::binary);
+  OutputFileStream f(generateTagFile.str());
   if (!f.is_open())
   {
     err("cannot open tag file %s for writing\n",
@@ -11017,6 +11292,34 @@ void searchInputFiles()
   bool alwaysRecursive = Config_getBool(RECURSIVE);
   StringUnorderedSet excludeNameSet;
 
+  // all directory trees are read in the background from the start, so
+  // reading them overlaps with processing them one by one below.
+  std::size_t numThreads = static_cast<std::size_t>(Config_getInt(NUM_PROC_THREADS));
+  if (numThreads==0)
+  {
+    numThreads = std::thread::hardware_concurrency();
+  }
+  DirCrawler crawler(numThreads);
+  auto prefetch = [&crawler](const StringVector &list,bool recursive,const StringVector *exclPatList)
+  {
+    std::shared_ptr<PatternMatcher> exclPatMatcher;
+    if (exclPatList) exclPatMatcher = std::make_shared<PatternMatcher>(*exclPatList);
+    DirCrawler::DescendFilter descend = makeDescendFilter(recursive,exclPatMatcher);
+    for (const auto &s : list)
+    {
+      FileInfo fi(s);
+      if (fi.isDir()) crawler.prefetch(fi.absFilePath(),descend);
+    }
+  };
+  prefetch(Config_getList(INPUT),        alwaysRecursive,&exclPatterns);
+  prefetch(Config_getList(INCLUDE_PATH), alwaysRecursive,&exclPatterns);
+  prefetch(Config_getList(EXAMPLE_PATH), alwaysRecursive || Config_getBool(EXAMPLE_RECURSIVE),0);
+  prefetch(Config_getList(IMAGE_PATH),   alwaysRecursive,0);
+  prefetch(Config_getList(DOTFILE_DIRS), alwaysRecursive,0);
+  prefetch(Config_getList(MSCFILE_DIRS), alwaysRecursive,0);
+  prefetch(Config_getList(DIAFILE_DIRS), alwaysRecursive,0);
+  prefetch(Config_getList(EXCLUDE),      alwaysRecursive,0);
+
   // gather names of all files in the include path
   g_s.begin("Searching for include files...\n");
   killSet.clear();
@@ -11035,7 +11338,9 @@ void searchInputFiles()
                         0,                             // resultSet
                         alwaysRecursive,               // recursive
                         TRUE,                          // errorIfNotExist
-                        &killSet);                     // killSet
+                        &killSet,                      // killSet
+                        0,                             // paths
+                        &crawler);                     // crawler
   }
   g_s.end();
 
@@ -11053,7 +11358,9 @@ void searchInputFiles()
                         0,                                                      // resultSet
                         (alwaysRecursive || Config_getBool(EXAMPLE_RECURSIVE)), // recursive
                         TRUE,                                                   // errorIfNotExist
-                        &killSet);                                              // killSet
+                        &killSet,                                               // killSet
+                        0,                                                      // paths
+                        &crawler);                                              // crawler
   }
   g_s.end();
 
@@ -11071,7 +11378,9 @@ void searchInputFiles()
                         0,                                // resultSet
                         alwaysRecursive,                  // recursive
                         TRUE,                             // errorIfNotExist
-                        &killSet);                        // killSet
+                        &killSet,                         // killSet
+                        0,                                // paths
+                        &crawler);                        // crawler
   }
   g_s.end();
 
@@ -11089,7 +11398,9 @@ void searchInputFiles()
                         0,                              // resultSet
                         alwaysRecursive,                // recursive
                         TRUE,                           // errorIfNotExist
-                        &killSet);                      // killSet
+                        &killSet,                       // killSet
+                        0,                              // paths
+                        &crawler);                      // crawler
   }
   g_s.end();
 
@@ -11107,7 +11418,9 @@ void searchInputFiles()
                         0,                               // resultSet
                         alwaysRecursive,                 // recursive
                         TRUE,                            // errorIfNotExist
-                        &killSet);                       // killSet
+                        &killSet,                        // killSet
+                        0,                               // paths
+                        &crawler);                       // crawler
   }
   g_s.end();
 
@@ -11125,7 +11438,9 @@ void searchInputFiles()
                         0,                                 // resultSet
                         alwaysRecursive,                   // recursive
                         TRUE,                              // errorIfNotExist
-                        &killSet);                         // killSet
+                        &killSet,                          // killSet
+                        0,                                 // paths
+                        &crawler);                         // crawler
   }
   g_s.end();
 
@@ -11141,7 +11456,10 @@ void searchInputFiles()
                         0,                                  // resultList
                         &excludeNameSet,                    // resultSet
                         alwaysRecursive,                    // recursive
-                        FALSE);                             // errorIfNotExist
+                        FALSE,                              // errorIfNotExist
+                        0,                                  // killSet
+                        0,                                  // paths
+                        &crawler);                          // crawler
   }
   g_s.end();
 
@@ -11173,7 +11491,8 @@ void searchInputFiles()
           alwaysRecursive,                    // recursive
           TRUE,                               // errorIfNotExist
           &killSet,                           // killSet
-          &Doxygen::inputPaths);              // paths
+          &Doxygen::inputPaths,               // paths
+          &crawler);                          // crawler
     }
   }
   std::sort(Doxygen::inputNameLinkedMap->begin(),
@@ -11417,6 +11736,7 @@ void parseInput()
   addSTLSupport(root);
 
   g_s.begin("Parsing files\n");
+  ParseCache::instance().init();
   if (Config_getInt(NUM_PROC_THREADS)==1)
   {
     parseFilesSingleThreading(root);
@@ -11425,6 +11745,8 @@ void parseInput()
   {
     parseFilesMultiThreading(root);
   }
+  ParseCache::instance().printStatistics();
+  Preprocessor::printStatistics();
   g_s.end();
 
   /**************************************************************************
@@ -12033,6 +12355,11 @@ void generateOutput()
 
   if (g_useOutputTemplate) generateOutputViaTemplate();
 
+  // all documentation has been written, release the parsed blocks
+  DocRootCache::instance().printStatistics();
+  DocRootCache::instance().clear();
+  CodeRecordingCache::instance().printStatistics();
+
   warn_flush();
 
   if (generateRtf)
@@ -12047,6 +12374,9 @@ void generateOutput()
 
   warn_flush();
 
+  // wait for the images of the class diagrams that are written in the background
+  Image::finishSaves();
+
   g_s.begin("Running plantuml with JAVA...\n");
   PlantumlManager::instance().run();
   g_s.end();
@@ -12124,17 +12454,22 @@ void generateOutput()
     g_s.end();
   }
 
+  OutputGenerator::printFileStatistics();
+
   int cacheParam;
-  msg("lookup cache used %zu/%zu hits=%" PRIu64 " misses=%" PRIu64 "\n",
+  msg("lookup cache used %zu/%zu hits=%" PRIu64 " misses=%" PRIu64 " contention=%" PRIu64 "\n",
       Doxygen::lookupCache->size(),
       Doxygen::lookupCache->capacity(),
       Doxygen::lookupCache->hits(),
-      Doxygen::lookupCache->misses());
+      Doxygen::lookupCache->misses(),
+      Doxygen::lookupCache->contention());
   cacheParam = computeIdealCacheParam(static_cast<size_t>(Doxygen::lookupCache->misses()*2/3)); // part of the cache is flushed, hence the 2/3 correction factor
   if (cacheParam>Config_getInt(LOOKUP_CACHE_SIZE))
   {
     msg("Note: based on cache misses the ideal setting for LOOKUP_CACHE_SIZE is %d at the cost of higher memory usage.\n",cacheParam);
   }
+  traceCacheCounters();
+  Trace::finish();
 
   if (Debug::isFlagSet(Debug::Time))
   {
@@ -12142,6 +12477,7 @@ void generateOutput()
          ((double)Debug::elapsedTime()),
          Portable::getSysElapsedTime()
         );
+    msg("String pool: %zu distinct strings, %zu bytes\n",StringPool::count(),StringPool::size());
     g_s.print();
   }
   else
@@ -52,6 +52,7 @@ class FormulaList;
 class FormulaDict;
 class FormulaNameDict;
 class Preprocessor;
+class DirCrawler;
 struct MemberGroupInfo;
 class NamespaceDefMutable;
 
@@ -81,7 +82,7 @@ class Doxygen
     static PageLinkedMap            *exampleLinkedMap;
     static PageLinkedMap            *pageLinkedMap;
     static std::unique_ptr<PageDef>  mainPage;
-    static bool                      insideMainPage;
+    static thread_local bool         insideMainPage;
     static FileNameLinkedMap        *includeNameLinkedMap;
     static FileNameLinkedMap        *exampleNameLinkedMap;
     static StringSet                 inputPaths;
@@ -110,11 +111,11 @@ class Doxygen
     static DirLinkedMap             *dirLinkedMap;
     static DirRelationLinkedMap      dirRelations;
     static ParserManager            *parserManager;
-    static bool                      suppressDocWarnings;
+    static thread_local bool         suppressDocWarnings;
     static QCString                  filterDBFileName;
     static bool                      userComments;
     static IndexList                *indexList;
-    static int                       subpageNestingLevel;
+    static thread_local int          subpageNestingLevel;
     static QCString                  spaces;
     static bool                      generatingXmlOutput;
     static DefinesPerFileList        macroDefinitions;
@@ -140,7 +141,8 @@ void readFileOrDirectory(const char *s,
                         bool recursive,
                         bool errorIfNotExist=TRUE,
                         StringUnorderedSet *killSet = 0,
-                        StringSet *paths = 0
+                        StringSet *paths = 0,
+                        DirCrawler *crawler = 0
                        );
 void copyAndFilterFile(const char *fileName,BufStr &dest);
 
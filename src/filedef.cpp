@@ -29,6 +29,8 @@
 #include "dotincldepgraph.h"
 #include "message.h"
 #include "docparser.h"
+#include "coderecorder.h"
+#include "docrootcache.h"
 #include "searchindex.h"
 #include "htags.h"
 #include "parserintf.h"
@@ -495,7 +497,7 @@ void FileDefImpl::writeBriefDescription(OutputList &ol)
 {
   if (hasBriefDescription())
   {
-    DocRoot *rootNode = validatingParseDoc(briefFile(),briefLine(),this,0,
+    std::shared_ptr<DocRoot> rootNode = DocRootCache::instance().parse(briefFile(),briefLine(),this,0,
                        briefDescription(),TRUE,FALSE,
                        0,TRUE,FALSE,Config_getBool(MARKDOWN_SUPPORT));
 
@@ -506,7 +508,7 @@ void FileDefImpl::writeBriefDescription(OutputList &ol)
       ol.disableAllBut(OutputGenerator::Man);
       ol.writeString(" - ");
       ol.popGeneratorState();
-      ol.writeDoc(rootNode,this,0);
+      ol.writeDoc(rootNode.get(),this,0);
       ol.pushGeneratorState();
       ol.disable(OutputGenerator::RTF);
       ol.writeString(" \n");
@@ -524,7 +526,6 @@ void FileDefImpl::writeBriefDescription(OutputList &ol)
       ol.popGeneratorState();
       ol.endParagraph();
     }
-    delete rootNode;
   }
   ol.writeSynopsis();
 }
@@ -1198,8 +1199,15 @@ void FileDefImpl::writeSourceBody(OutputList &ol,ClangTUParser *clangParser)
                        FALSE,0,this
                       );
     }
-    intf->parseCode(ol,0,
-        fileToString(absFilePath(),filterSourceFiles,TRUE),
+    QCString text = fileToString(absFilePath(),filterSourceFiles,TRUE);
+    // when the code will be needed again later on, record it while writing it
+    std::unique_ptr<CodeRecorder> recorder;
+    if (CodeRecordingCache::instance().isEnabled())
+    {
+      recorder = std::make_unique<CodeRecorder>(ol.id());
+    }
+    intf->parseCode(recorder ? static_cast<CodeOutputInterface&>(*recorder) : ol,0,
+        text,
         getLanguage(),      // lang
         FALSE,              // isExampleBlock
         0,                  // exampleName
@@ -1212,6 +1220,11 @@ void FileDefImpl::writeSourceBody(OutputList &ol,ClangTUParser *clangParser)
         0,                  // searchCtx
         !needs2PassParsing  // collectXRefs
         );
+    if (recorder)
+    {
+      recorder->replay(ol);
+      CodeRecordingCache::instance().store(this,text,std::move(recorder));
+    }
     ol.endCodeFragment("DoxyCode");
   }
 }
@@ -1239,12 +1252,22 @@ void FileDefImpl::parseSource(ClangTUParser *clangParser)
   {
     auto intf = Doxygen::parserManager->getCodeParser(getDefFileExtension());
     intf->resetCodeParserState();
-    intf->parseCode(
-            devNullIntf,0,
-            fileToString(absFilePath(),filterSourceFiles,TRUE),
-            getLanguage(),
-            FALSE,0,this
-           );
+    QCString text = fileToString(absFilePath(),filterSourceFiles,TRUE);
+    if (CodeRecordingCache::instance().isEnabled())
+    {
+      auto recorder = std::make_unique<CodeRecorder>();
+      intf->parseCode(*recorder,0,text,getLanguage(),FALSE,0,this);
+      CodeRecordingCache::instance().store(this,text,std::move(recorder));
+    }
+    else
+    {
+      intf->parseCode(
+              devNullIntf,0,
+              text,
+              getLanguage(),
+              FALSE,0,this
+             );
+    }
   }
 }
 
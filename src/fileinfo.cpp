@@ -25,6 +25,13 @@ size_t FileInfo::size() const
   return ec ? 0 : result;
 }
 
+std::time_t FileInfo::lastModified() const
+{
+  std::error_code ec;
+  fs::file_time_type t = fs::last_write_time(fs::path(m_name),ec);
+  return ec ? 0 : fs::file_time_type::clock::to_time_t(t);
+}
+
 bool FileInfo::exists() const
 {
   std::error_code ec;
@@ -17,6 +17,7 @@
 #define FILEINFO_H
 
 #include <string>
+#include <ctime>
 
 /** @brief Minimal replacement for QFileInfo. */
 class FileInfo
@@ -25,6 +26,7 @@ class FileInfo
     explicit FileInfo(const std::string &name) : m_name(name) {}
     bool exists() const;
     size_t size() const;
+    std::time_t lastModified() const;
     bool isWritable() const;
     bool isReadable() const;
     bool isExecutable() const;
@@ -27,6 +27,10 @@
 #include <string>
 #include <utility>
 #include <fstream>
+#include <thread>
+
+#include "md5.h"
+#include "threadpool.h"
 
 // TODO: remove these dependencies
 #include "doxygen.h" // for Doxygen::indexList
@@ -127,6 +131,299 @@ void FormulaManager::readFormulas(const char *dir,bool doCompare)
   }
 }
 
+//---------------------------------------------------------------------------
+
+/** Tool used to convert the formulas to SVG */
+enum class VectorConverter { Pdf2Svg, Inkscape };
+
+/** Cache of formula images that is kept between runs in \c FORMULA_CACHE_DIR.
+ *  An entry is identified by the text of the formula, the latex preamble
+ *  (including the macro file), the font size and the image format. It consists
+ *  of the image and a file with its display size.
+ */
+class FormulaCache
+{
+  public:
+    FormulaCache(const QCString &preamble,FormulaManager::Format format,FormulaManager::HighDPI hd)
+    {
+      QCString cacheDir = Config_getString(FORMULA_CACHE_DIR);
+      if (cacheDir.isEmpty()) return;
+      Dir d(cacheDir.str());
+      if (!d.exists() && !d.mkdir(cacheDir.str()))
+      {
+        warn_uncond("cannot create formula cache directory '%s', the formula cache is disabled.\n",qPrint(cacheDir));
+        return;
+      }
+      m_cacheDir  = d.absPath();
+      m_ext       = format==FormulaManager::Format::Vector ? ".svg" : ".png";
+      m_configKey = preamble+"\n"+m_ext.c_str()+"\n"+
+                    (hd==FormulaManager::HighDPI::On ? "hd" : "sd")+"\n"+
+                    QCString().setNum(Config_getInt(FORMULA_FONTSIZE))+"\n";
+    }
+
+    /** Links or copies the image of \a formula to \a resultName and
+     *  returns its display size in \a size. Returns FALSE if the formula
+     *  is not in the cache.
+     */
+    bool restore(const std::string &formula,const QCString &resultName,FormulaManager::DisplaySize &size)
+    {
+      if (m_cacheDir.empty()) return false;
+      std::string entryName = entryPath(formula);
+      std::ifstream sizeIn(entryName+".size",std::ifstream::in);
+      int w=-1,h=-1;
+      if (!sizeIn.is_open() || !(sizeIn >> w >> h)) return false;
+      FileInfo fi(entryName+m_ext);
+      if (!fi.exists() || fi.size()==0) return false;
+      Dir d;
+      d.remove(resultName.str());
+      if (!d.link(entryName+m_ext,resultName.str()) && !d.copy(entryName+m_ext,resultName.str()))
+      {
+        return false;
+      }
+      size = FormulaManager::DisplaySize(w,h);
+      m_numRestored++;
+      return true;
+    }
+
+    /** Stores image \a resultName with display size \a size for \a formula */
+    void store(const std::string &formula,const QCString &resultName,const FormulaManager::DisplaySize &size)
+    {
+      if (m_cacheDir.empty()) return;
+      FileInfo fi(resultName.str());
+      if (!fi.exists() || fi.size()==0) return;
+      std::string entryName = entryPath(formula);
+      Dir d;
+      std::string subDir = FileInfo(entryName).dirPath();
+      if (!d.exists(subDir)) d.mkdir(subDir);
+      // the size is written first, so an entry with an image is always complete;
+      // both files are written to a temporary file first, so they are never truncated,
+      // also not by another run using the same cache directory.
+      std::string tmpName = tempFileName(entryName);
+      {
+        std::ofstream sizeOut(tmpName,std::ofstream::out | std::ofstream::binary);
+        if (!sizeOut.is_open()) return;
+        sizeOut << size.width << " " << size.height << "\n";
+      }
+      if (!d.rename(tmpName,entryName+".size"))
+      {
+        d.remove(tmpName);
+        return;
+      }
+      if (d.copy(resultName.str(),tmpName) && d.rename(tmpName,entryName+m_ext))
+      {
+        m_numStored++;
+      }
+      else
+      {
+        d.remove(tmpName);
+      }
+    }
+
+    void printStatistics() const
+    {
+      if (!m_cacheDir.empty())
+      {
+        msg("Formula cache: %d images restored, %d images stored\n",m_numRestored,m_numStored);
+      }
+    }
+
+  private:
+    std::string entryPath(const std::string &formula) const
+    {
+      QCString keyStr = m_configKey+formula.c_str();
+      uchar md5_sig[16];
+      char sigStr[33];
+      MD5Buffer((const unsigned char*)keyStr.data(),keyStr.length(),md5_sig);
+      MD5SigToString(md5_sig,sigStr,33);
+      // use the first two characters of the key as subdirectory to limit the number of files per directory
+      return m_cacheDir+"/"+std::string(sigStr,2)+"/"+sigStr;
+    }
+    std::string m_cacheDir;
+    std::string m_ext;
+    QCString m_configKey;
+    int m_numRestored = 0;
+    int m_numStored = 0;
+};
+
+//---------------------------------------------------------------------------
+
+/** Runs the tools that convert page \a pageIndex of _formulas.dvi into the
+ *  image for formula \a pageNum and determines its display size.
+ *  Returns FALSE if one of the tools failed.
+ *  The jobs for different formulas can run at the same time, as each one
+ *  uses its own temporary files.
+ */
+static bool generateFormulaImage(int pageNum,int pageIndex,
+                                 FormulaManager::Format format,FormulaManager::HighDPI hd,
+                                 VectorConverter converter,int inkscapeVersion,
+                                 FormulaManager::DisplaySize &size)
+{
+  Dir thisDir;
+  char args[4096];
+  msg("Generating image form_%d.%s for formula\n",pageNum,(format==FormulaManager::Format::Vector) ? "svg" : "png");
+  QCString formBase;
+  formBase.sprintf("_form%d",pageNum);
+  // run dvips to convert the page with number pageIndex to an
+  // postscript file.
+  sprintf(args,"-q -D 600 -n 1 -p %d -o %s_tmp.ps _formulas.dvi",
+      pageIndex,formBase.data());
+  if (Portable::system("dvips",args)!=0)
+  {
+    err("Problems running dvips. Check your installation!\n");
+    return false;
+  }
+
+  // extract the bounding box for the postscript file
+  sprintf(args,"-q -dBATCH -dNOPAUSE -P- -dNOSAFER -sDEVICE=bbox %s_tmp.ps 2>%s_tmp.epsi",
+      formBase.data(),formBase.data());
+  if (Portable::system(Portable::ghostScriptCommand(),args)!=0)
+  {
+    err("Problems running %s. Check your installation!\n",Portable::ghostScriptCommand());
+    return false;
+  }
+
+  // extract the bounding box info from the generate .epsi file
+  int x1=0,y1=0,x2=0,y2=0;
+  FileInfo fi((formBase+"_tmp.epsi").str());
+  if (fi.exists())
+  {
+    QCString eps = fileToString(formBase+"_tmp.epsi");
+    int i = eps.find("%%BoundingBox:");
+    if (i!=-1)
+    {
+      sscanf(eps.data()+i,"%%%%BoundingBox:%d %d %d %d",&x1,&y1,&x2,&y2);
+    }
+    else
+    {
+      err("Couldn't extract bounding box from %s_tmp.epsi",formBase.data());
+    }
+  }
+  //printf("Bounding box [%d %d %d %d]\n",x1,y1,x2,y2);
+
+  // convert the corrected EPS to a bitmap
+  double scaleFactor = 1.25;
+  int zoomFactor = Config_getInt(FORMULA_FONTSIZE);
+  if (zoomFactor<8 || zoomFactor>50) zoomFactor=10;
+  scaleFactor *= zoomFactor/10.0;
+
+  size.width  = (int)((x2-x1)*scaleFactor+0.5);
+  size.height = (int)((y2-y1)*scaleFactor+0.5);
+
+  if (format==FormulaManager::Format::Vector)
+  {
+    // crop the image to its bounding box
+    sprintf(args,"-q -dBATCH -dNOPAUSE -P- -dNOSAFER -sDEVICE=pdfwrite"
+                 " -o %s_tmp.pdf -c \"[/CropBox [%d %d %d %d] /PAGES pdfmark\" -f %s_tmp.ps",
+                 formBase.data(),x1,y1,x2,y2,formBase.data());
+    if (Portable::system(Portable::ghostScriptCommand(),args)!=0)
+    {
+      err("Problems running %s. Check your installation!\n",Portable::ghostScriptCommand());
+      return false;
+    }
+
+    if (converter==VectorConverter::Pdf2Svg) // if we have pdf2svg available use it to create a SVG image
+    {
+      sprintf(args,"%s_tmp.pdf form_%d.svg",formBase.data(),pageNum);
+      if (Portable::system("pdf2svg",args)!=0)
+      {
+        err("Problems running pdf2svg. Check your installation!\n");
+        return false;
+      }
+    }
+    else // alternative is to use inkscape
+    {
+      if (inkscapeVersion == 0)
+      {
+        sprintf(args,"-l form_%d.svg -z %s_tmp.pdf 2>%s",pageNum,formBase.data(),Portable::devNull());
+      }
+      else // inkscapeVersion >= 1
+      {
+        sprintf(args,"--export-type=svg --export-filename=form_%d.svg %s_tmp.pdf 2>%s",pageNum,formBase.data(),Portable::devNull());
+      }
+      if (Portable::system("inkscape",args)!=0)
+      {
+        err("Problems running inkscape. Check your installation!\n");
+        return false;
+      }
+    }
+
+    if (RM_TMP_FILES)
+    {
+      thisDir.remove(formBase.str()+"_tmp.pdf");
+    }
+  }
+  else // format==Format::Bitmap
+  {
+    // crop the image to its bounding box
+    sprintf(args,"-q -dBATCH -dNOPAUSE -P- -dNOSAFER -sDEVICE=eps2write"
+                 " -o %s_tmp.eps -f %s_tmp.ps",formBase.data(),formBase.data());
+    if (Portable::system(Portable::ghostScriptCommand(),args)!=0)
+    {
+      err("Problems running %s. Check your installation!\n",Portable::ghostScriptCommand());
+      return false;
+    }
+
+    // read back %s_tmp.eps and replace
+    // bounding box values with x1,y1,x2,y2 and remove the HiResBoundingBox
+    std::ifstream epsIn(formBase.str()+"_tmp.eps",std::ifstream::in);
+    std::ofstream epsOut(formBase.str()+"_tmp_corr.eps",std::ofstream::out | std::ofstream::binary);
+    if (epsIn.is_open() && epsOut.is_open())
+    {
+      std::string line;
+      while (getline(epsIn,line))
+      {
+        if (line.rfind("%%BoundingBox",0)==0)
+        {
+          epsOut << "%%BoundingBox: " << x1 << " " << y1 << " " << x2 << " " << y2 << "\n";
+        }
+        else if (line.rfind("%%HiResBoundingBox",0)==0) // skip this one
+        {
+        }
+        else
+        {
+          epsOut << line << "\n";
+        }
+      }
+      epsIn.close();
+      epsOut.close();
+    }
+    else
+    {
+      err("Problems correcting the eps files from %s_tmp.eps to %s_tmp_corr.eps\n",
+          formBase.data(),formBase.data());
+      return false;
+    }
+
+    if (hd==FormulaManager::HighDPI::On) // for high DPI display it looks much better if the
+                                         // image resolution is higher than the display resolution
+    {
+      scaleFactor*=2;
+    }
+
+    sprintf(args,"-q -dNOSAFER -dBATCH -dNOPAUSE -dEPSCrop -sDEVICE=pnggray -dGraphicsAlphaBits=4 -dTextAlphaBits=4 "
+        "-r%d -sOutputFile=form_%d.png %s_tmp_corr.eps",(int)(scaleFactor*72),pageNum,formBase.data());
+    if (Portable::system(Portable::ghostScriptCommand(),args)!=0)
+    {
+      err("Problems running %s. Check your installation!\n",Portable::ghostScriptCommand());
+      return false;
+    }
+
+    if (RM_TMP_FILES)
+    {
+      thisDir.remove(formBase.str()+"_tmp.eps");
+      thisDir.remove(formBase.str()+"_tmp_corr.eps");
+    }
+  }
+
+  // remove intermediate image files
+  if (RM_TMP_FILES)
+  {
+    thisDir.remove(formBase.str()+"_tmp.ps");
+    thisDir.remove(formBase.str()+"_tmp.epsi");
+  }
+  return true;
+}
+
 void FormulaManager::generateImages(const char *path,Format format,HighDPI hd) const
 {
   Dir d(path);
@@ -148,6 +445,28 @@ void FormulaManager::generateImages(const char *path,Format format,HighDPI hd) c
   // go to the html output directory (i.e. path)
   Dir::setCurrent(d.absPath());
   Dir thisDir;
+
+  // the preamble of the latex file, it is also part of the cache key
+  // as changing it may change the images of all formulas
+  TextStream preamble;
+  if (Config_getBool(LATEX_BATCHMODE)) preamble << "\\batchmode\n";
+  preamble << "\\documentclass{article}\n";
+  preamble << "\\usepackage{ifthen}\n";
+  preamble << "\\usepackage{epsfig}\n"; // for those who want to include images
+  preamble << "\\usepackage[utf8]{inputenc}\n"; // looks like some older distributions with newunicode package 1.1 need this option.
+  writeExtraLatexPackages(preamble);
+  writeLatexSpecialFormulaChars(preamble);
+  if (!macroFile.isEmpty())
+  {
+    copyFile(macroFile,stripMacroFile);
+    preamble << "\\input{" << stripMacroFile << "}\n";
+  }
+  preamble << "\\pagestyle{empty}\n";
+
+  const char *ext = format==Format::Vector ? "svg" : "png";
+  FormulaCache cache(preamble.str()+(macroFile.isEmpty() ? QCString() : fileToString(macroFile)),
+                     format,hd);
+
   // generate a latex file containing one formula per page.
   QCString texName="_formulas.tex";
   IntVector formulasToGenerate;
@@ -155,31 +474,28 @@ void FormulaManager::generateImages(const char *path,Format format,HighDPI hd) c
   if (f.is_open())
   {
     TextStream t(&f);
-    if (Config_getBool(LATEX_BATCHMODE)) t << "\\batchmode\n";
-    t << "\\documentclass{article}\n";
-    t << "\\usepackage{ifthen}\n";
-    t << "\\usepackage{epsfig}\n"; // for those who want to include images
-    t << "\\usepackage[utf8]{inputenc}\n"; // looks like some older distributions with newunicode package 1.1 need this option.
-    writeExtraLatexPackages(t);
-    writeLatexSpecialFormulaChars(t);
-    if (!macroFile.isEmpty())
-    {
-      copyFile(macroFile,stripMacroFile);
-      t << "\\input{" << stripMacroFile << "}\n";
-    }
-    t << "\\pagestyle{empty}\n";
+    t << preamble.str();
     t << "\\begin{document}\n";
     for (int i=0; i<(int)p->formulas.size(); i++)
     {
       QCString resultName;
-      resultName.sprintf("form_%d.%s",i,format==Format::Vector?"svg":"png");
-      // only formulas for which no image exists are generated
+      resultName.sprintf("form_%d.%s",i,ext);
+      // only formulas for which no image exists are generated,
+      // unless their image can be taken from the formula cache
       FileInfo fi(resultName.str());
       if (!fi.exists())
       {
-        // we force a pagebreak after each formula
-        t << p->formulas[i].c_str() << "\n\\pagebreak\n\n";
-        formulasToGenerate.push_back(i);
+        DisplaySize size(-1,-1);
+        if (cache.restore(p->formulas[i],resultName,size))
+        {
+          p->storeDisplaySize(i,size.width,size.height);
+        }
+        else
+        {
+          // we force a pagebreak after each formula
+          t << p->formulas[i].c_str() << "\n\\pagebreak\n\n";
+          formulasToGenerate.push_back(i);
+        }
       }
       Doxygen::indexList->addImageFile(resultName);
     }
@@ -204,216 +520,81 @@ void FormulaManager::generateImages(const char *path,Format format,HighDPI hd) c
       return;
     }
     Portable::sysTimerStop();
-    //printf("Running dvips...\n");
-    int pageIndex=1;
-    for (int pageNum : formulasToGenerate)
-    {
-      msg("Generating image form_%d.%s for formula\n",pageNum,(format==Format::Vector) ? "svg" : "png");
-      QCString formBase;
-      formBase.sprintf("_form%d",pageNum);
-      // run dvips to convert the page with number pageIndex to an
-      // postscript file.
-      sprintf(args,"-q -D 600 -n 1 -p %d -o %s_tmp.ps _formulas.dvi",
-          pageIndex,formBase.data());
-      Portable::sysTimerStart();
-      if (Portable::system("dvips",args)!=0)
+
+    // determine the tool to convert to svg once, before starting the jobs
+    VectorConverter converter = VectorConverter::Pdf2Svg;
+    int inkscapeVersion = -1;
+    if (format==Format::Vector && !Portable::checkForExecutable("pdf2svg"))
+    {
+      if (Portable::checkForExecutable("inkscape"))
       {
-        err("Problems running dvips. Check your installation!\n");
-        Portable::sysTimerStop();
-        Dir::setCurrent(oldDir);
-        return;
+        converter = VectorConverter::Inkscape;
+        inkscapeVersion = determineInkscapeVersion(thisDir);
+        if (inkscapeVersion == -1)
+        {
+          err("Problems determining the version of inkscape. Check your installation!\n");
+          Dir::setCurrent(oldDir);
+          return;
+        }
       }
-      Portable::sysTimerStop();
-
-      // extract the bounding box for the postscript file
-      sprintf(args,"-q -dBATCH -dNOPAUSE -P- -dNOSAFER -sDEVICE=bbox %s_tmp.ps 2>%s_tmp.epsi",
-          formBase.data(),formBase.data());
-      Portable::sysTimerStart();
-      if (Portable::system(Portable::ghostScriptCommand(),args)!=0)
+      else
       {
-        err("Problems running %s. Check your installation!\n",Portable::ghostScriptCommand());
-        Portable::sysTimerStop();
+        err("Neither 'pdf2svg' nor 'inkscape' present for conversion of formula to 'svg'\n");
         Dir::setCurrent(oldDir);
         return;
       }
-      Portable::sysTimerStop();
+    }
 
-      // extract the bounding box info from the generate .epsi file
-      int x1=0,y1=0,x2=0,y2=0;
-      FileInfo fi((formBase+"_tmp.epsi").str());
-      if (fi.exists())
+    // run the tools for each formula, using multiple threads if allowed
+    std::vector<DisplaySize> sizes(formulasToGenerate.size(),DisplaySize(-1,-1));
+    std::vector<char> ok(formulasToGenerate.size(),0);
+    auto runJob = [&](size_t i)
+    {
+      ok[i] = generateFormulaImage(formulasToGenerate[i],static_cast<int>(i)+1,format,hd,
+                                   converter,inkscapeVersion,sizes[i]);
+    };
+    std::size_t numThreads = static_cast<std::size_t>(Config_getInt(NUM_PROC_THREADS));
+    if (numThreads==0)
+    {
+      numThreads = std::thread::hardware_concurrency();
+    }
+    Portable::sysTimerStart();
+    if (numThreads>1 && formulasToGenerate.size()>1) // multi threaded version
+    {
+      ThreadPool threadPool(std::min(numThreads,formulasToGenerate.size()));
+      std::vector< std::future<void> > results;
+      for (size_t i=0; i<formulasToGenerate.size(); i++)
       {
-        QCString eps = fileToString(formBase+"_tmp.epsi");
-        int i = eps.find("%%BoundingBox:");
-        if (i!=-1)
-        {
-          sscanf(eps.data()+i,"%%%%BoundingBox:%d %d %d %d",&x1,&y1,&x2,&y2);
-        }
-        else
-        {
-          err("Couldn't extract bounding box from %s_tmp.epsi",formBase.data());
-        }
+        results.emplace_back(threadPool.queue([&runJob,i]() { runJob(i); }));
       }
-      //printf("Bounding box [%d %d %d %d]\n",x1,y1,x2,y2);
-
-      // convert the corrected EPS to a bitmap
-      double scaleFactor = 1.25;
-      int zoomFactor = Config_getInt(FORMULA_FONTSIZE);
-      if (zoomFactor<8 || zoomFactor>50) zoomFactor=10;
-      scaleFactor *= zoomFactor/10.0;
-
-      int width  = (int)((x2-x1)*scaleFactor+0.5);
-      int height = (int)((y2-y1)*scaleFactor+0.5);
-      p->storeDisplaySize(pageNum,width,height);
-
-      if (format==Format::Vector)
+      for (auto &r : results)
       {
-        // crop the image to its bounding box
-        sprintf(args,"-q -dBATCH -dNOPAUSE -P- -dNOSAFER -sDEVICE=pdfwrite"
-                     " -o %s_tmp.pdf -c \"[/CropBox [%d %d %d %d] /PAGES pdfmark\" -f %s_tmp.ps",
-                     formBase.data(),x1,y1,x2,y2,formBase.data());
-        Portable::sysTimerStart();
-        if (Portable::system(Portable::ghostScriptCommand(),args)!=0)
-        {
-          err("Problems running %s. Check your installation!\n",Portable::ghostScriptCommand());
-          Portable::sysTimerStop();
-          Dir::setCurrent(oldDir);
-          return;
-        }
-        Portable::sysTimerStop();
-
-        // if we have pdf2svg available use it to create a SVG image
-        if (Portable::checkForExecutable("pdf2svg"))
-        {
-          sprintf(args,"%s_tmp.pdf form_%d.svg",formBase.data(),pageNum);
-          Portable::sysTimerStart();
-          if (Portable::system("pdf2svg",args)!=0)
-          {
-            err("Problems running pdf2svg. Check your installation!\n");
-            Portable::sysTimerStop();
-            Dir::setCurrent(oldDir);
-            return;
-          }
-          Portable::sysTimerStop();
-        }
-        else if (Portable::checkForExecutable("inkscape")) // alternative is to use inkscape
-        {
-          int inkscapeVersion = determineInkscapeVersion(thisDir);
-          if (inkscapeVersion == -1)
-          {
-            err("Problems determining the version of inkscape. Check your installation!\n");
-            Dir::setCurrent(oldDir);
-            return;
-          }
-          else if (inkscapeVersion == 0)
-          {
-            sprintf(args,"-l form_%d.svg -z %s_tmp.pdf 2>%s",pageNum,formBase.data(),Portable::devNull());
-          }
-          else // inkscapeVersion >= 1
-          {
-            sprintf(args,"--export-type=svg --export-filename=form_%d.svg %s_tmp.pdf 2>%s",pageNum,formBase.data(),Portable::devNull());
-          }
-          Portable::sysTimerStart();
-          if (Portable::system("inkscape",args)!=0)
-          {
-            err("Problems running inkscape. Check your installation!\n");
-            Portable::sysTimerStop();
-            Dir::setCurrent(oldDir);
-            return;
-          }
-          Portable::sysTimerStop();
-        }
-        else
-        {
-          err("Neither 'pdf2svg' nor 'inkscape' present for conversion of formula to 'svg'\n");
-          return;
-        }
-
-        if (RM_TMP_FILES)
-        {
-          thisDir.remove(formBase.str()+"_tmp.pdf");
-        }
+        r.get();
       }
-      else // format==Format::Bitmap
+    }
+    else // single threaded version
+    {
+      for (size_t i=0; i<formulasToGenerate.size() && (i==0 || ok[i-1]); i++)
       {
-        // crop the image to its bounding box
-        sprintf(args,"-q -dBATCH -dNOPAUSE -P- -dNOSAFER -sDEVICE=eps2write"
-                     " -o %s_tmp.eps -f %s_tmp.ps",formBase.data(),formBase.data());
-        Portable::sysTimerStart();
-        if (Portable::system(Portable::ghostScriptCommand(),args)!=0)
-        {
-          err("Problems running %s. Check your installation!\n",Portable::ghostScriptCommand());
-          Portable::sysTimerStop();
-          Dir::setCurrent(oldDir);
-          return;
-        }
-
-        // read back %s_tmp.eps and replace
-        // bounding box values with x1,y1,x2,y2 and remove the HiResBoundingBox
-        std::ifstream epsIn(formBase.str()+"_tmp.eps",std::ifstream::in);
-        std::ofstream epsOut(formBase.str()+"_tmp_corr.eps",std::ofstream::out | std::ofstream::binary);
-        if (epsIn.is_open() && epsOut.is_open())
-        {
-          std::string line;
-          while (getline(epsIn,line))
-          {
-            if (line.rfind("%%BoundingBox",0)==0)
-            {
-              epsOut << "%%BoundingBox: " << x1 << " " << y1 << " " << x2 << " " << y2 << "\n";
-            }
-            else if (line.rfind("%%HiResBoundingBox",0)==0) // skip this one
-            {
-            }
-            else
-            {
-              epsOut << line << "\n";
-            }
-          }
-          epsIn.close();
-          epsOut.close();
-        }
-        else
-        {
-          err("Problems correcting the eps files from %s_tmp.eps to %s_tmp_corr.eps\n",
-              formBase.data(),formBase.data());
-          Dir::setCurrent(oldDir);
-          return;
-        }
-
-        if (hd==HighDPI::On) // for high DPI display it looks much better if the
-                             // image resolution is higher than the display resolution
-        {
-          scaleFactor*=2;
-        }
-
-        Portable::sysTimerStop();
-        sprintf(args,"-q -dNOSAFER -dBATCH -dNOPAUSE -dEPSCrop -sDEVICE=pnggray -dGraphicsAlphaBits=4 -dTextAlphaBits=4 "
-            "-r%d -sOutputFile=form_%d.png %s_tmp_corr.eps",(int)(scaleFactor*72),pageNum,formBase.data());
-        Portable::sysTimerStart();
-        if (Portable::system(Portable::ghostScriptCommand(),args)!=0)
-        {
-          err("Problems running %s. Check your installation!\n",Portable::ghostScriptCommand());
-          Portable::sysTimerStop();
-          Dir::setCurrent(oldDir);
-          return;
-        }
-        Portable::sysTimerStop();
-
-        if (RM_TMP_FILES)
-        {
-          thisDir.remove(formBase.str()+"_tmp.eps");
-          thisDir.remove(formBase.str()+"_tmp_corr.eps");
-        }
+        runJob(i);
       }
+    }
+    Portable::sysTimerStop();
 
-      // remove intermediate image files
-      if (RM_TMP_FILES)
+    for (size_t i=0; i<formulasToGenerate.size(); i++)
+    {
+      if (!ok[i])
       {
-        thisDir.remove(formBase.str()+"_tmp.ps");
-        thisDir.remove(formBase.str()+"_tmp.epsi");
+        Dir::setCurrent(oldDir);
+        return;
       }
-      pageIndex++;
+      int pageNum = formulasToGenerate[i];
+      p->storeDisplaySize(pageNum,sizes[i].width,sizes[i].height);
+      QCString resultName;
+      resultName.sprintf("form_%d.%s",pageNum,ext);
+      cache.store(p->formulas[pageNum],resultName,sizes[i]);
     }
+
     // remove intermediate files produced by latex
     if (RM_TMP_FILES)
     {
@@ -444,6 +625,7 @@ void FormulaManager::generateImages(const char *path,Format format,HighDPI hd) c
       t << ":" << p->formulas[i].c_str() << "\n";
     }
   }
+  cache.printStatistics();
   // reset the directory to the original location.
   Dir::setCurrent(oldDir);
 }
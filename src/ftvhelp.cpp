@@ -31,6 +31,7 @@
 #include "layout.h"
 #include "pagedef.h"
 #include "docparser.h"
+#include "docrootcache.h"
 #include "htmldocvisitor.h"
 #include "filedef.h"
 #include "classdef.h"
@@ -350,7 +351,7 @@ static void generateBriefDoc(TextStream &t,const Definition *def)
   //printf("*** %p: generateBriefDoc(%s)='%s'\n",def,def->name().data(),brief.data());
   if (!brief.isEmpty())
   {
-    DocNode *root = validatingParseDoc(def->briefFile(),def->briefLine(),
+    std::shared_ptr<DocRoot> root = DocRootCache::instance().parse(def->briefFile(),def->briefLine(),
         def,0,brief,FALSE,FALSE,
         0,TRUE,TRUE,Config_getBool(MARKDOWN_SUPPORT));
     QCString relPath = relativePathToRoot(def->getOutputFileBase());
@@ -358,7 +359,6 @@ static void generateBriefDoc(TextStream &t,const Definition *def)
     HtmlDocVisitor *visitor = new HtmlDocVisitor(t,htmlGen,def);
     root->accept(visitor);
     delete visitor;
-    delete root;
   }
 }
 
@@ -620,7 +620,7 @@ static bool generateJSTree(NavIndexEntryList &navIndex,TextStream &t,
           fileId+="_dup";
         }
         QCString fileName = htmlOutput+"/"+fileId+".js";
-        std::ofstream f(fileName,std::ofstream::out | std::ofstream::binary);
+        OutputFileStream f(fileName.str());
         if (f.is_open())
         {
           TextStream tt(&f);
@@ -654,7 +654,7 @@ static bool generateJSTree(NavIndexEntryList &navIndex,TextStream &t,
 static void generateJSNavTree(const std::vector<FTVNode*> &nodeList)
 {
   QCString htmlOutput = Config_getString(HTML_OUTPUT);
-  std::ofstream f(htmlOutput.str()+"/navtreedata.js",std::ofstream::out | std::ofstream::binary);
+  OutputFileStream f(htmlOutput.str()+"/navtreedata.js");
   NavIndexEntryList navIndex;
   if (f.is_open())
   {
@@ -706,7 +706,7 @@ static void generateJSNavTree(const std::vector<FTVNode*> &nodeList)
     int subIndex=0;
     int elemCount=0;
     const int maxElemCount=250;
-    std::ofstream tsidx(htmlOutput.str()+"/navtreeindex0.js",std::ofstream::out | std::ofstream::binary);
+    OutputFileStream tsidx(htmlOutput.str()+"/navtreeindex0.js");
     if (tsidx.is_open())
     {
       t << "var NAVTREEINDEX =\n";
@@ -743,7 +743,7 @@ static void generateJSNavTree(const std::vector<FTVNode*> &nodeList)
           tsidx.close();
           subIndex++;
           QCString fileName = htmlOutput+"/navtreeindex"+QCString().setNum(subIndex)+".js";
-          tsidx.open(fileName.str(),std::ofstream::out | std::ofstream::binary);
+          tsidx.open(fileName.str());
           if (!tsidx.is_open()) break;
           tsidx << "var NAVTREEINDEX" << subIndex << " =\n";
           tsidx << "{\n";
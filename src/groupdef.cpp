@@ -34,6 +34,7 @@
 #include "doxygen.h"
 #include "pagedef.h"
 #include "docparser.h"
+#include "docrootcache.h"
 #include "searchindex.h"
 #include "dot.h"
 #include "dotgroupcollaboration.h"
@@ -798,7 +799,7 @@ void GroupDefImpl::writeBriefDescription(OutputList &ol)
 {
   if (hasBriefDescription())
   {
-    DocRoot *rootNode = validatingParseDoc(briefFile(),briefLine(),this,0,
+    std::shared_ptr<DocRoot> rootNode = DocRootCache::instance().parse(briefFile(),briefLine(),this,0,
                                 briefDescription(),TRUE,FALSE,
                                 0,TRUE,FALSE,Config_getBool(MARKDOWN_SUPPORT));
     if (rootNode && !rootNode->isEmpty())
@@ -808,7 +809,7 @@ void GroupDefImpl::writeBriefDescription(OutputList &ol)
       ol.disableAllBut(OutputGenerator::Man);
       ol.writeString(" - ");
       ol.popGeneratorState();
-      ol.writeDoc(rootNode,this,0);
+      ol.writeDoc(rootNode.get(),this,0);
       ol.pushGeneratorState();
       ol.disable(OutputGenerator::RTF);
       ol.writeString(" \n");
@@ -824,7 +825,6 @@ void GroupDefImpl::writeBriefDescription(OutputList &ol)
       ol.popGeneratorState();
       ol.endParagraph();
     }
-    delete rootNode;
   }
   ol.writeSynopsis();
 }
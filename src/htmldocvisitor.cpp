@@ -66,12 +66,10 @@ static const char *hex="0123456789ABCDEF";
 
 static QCString convertIndexWordToAnchor(const QCString &word)
 {
-  static int cnt = 0;
   QCString result="a";
   QCString cntStr;
-  result += cntStr.setNum(cnt);
+  result += cntStr.setNum(OutputGenerator::nextPageIndex(OutputGenerator::Html,"anchor")-1);
   result += "_";
-  cnt++;
   const char *str = word.data();
   unsigned char c;
   if (str)
@@ -549,15 +547,10 @@ void HtmlDocVisitor::visit(DocVerbatim *s)
 
     case DocVerbatim::Dot:
       {
-        static int dotindex = 1;
-        QCString fileName(4096);
+        QCString fileName = Config_getString(HTML_OUTPUT)+"/"+
+                            OutputGenerator::inlineImageName(OutputGenerator::Html,"inline_dotgraph_")+".dot";
 
         forceEndParagraph(s);
-        fileName.sprintf("%s%d%s",
-            (Config_getString(HTML_OUTPUT)+"/inline_dotgraph_").data(),
-            dotindex++,
-            ".dot"
-           );
         std::ofstream file(fileName.str(),std::ofstream::out | std::ofstream::binary);
         if (!file.is_open())
         {
@@ -585,13 +578,8 @@ void HtmlDocVisitor::visit(DocVerbatim *s)
       {
         forceEndParagraph(s);
 
-        static int mscindex = 1;
-        QCString baseName(4096);
-
-        baseName.sprintf("%s%d",
-            (Config_getString(HTML_OUTPUT)+"/inline_mscgraph_").data(),
-            mscindex++
-            );
+        QCString baseName = Config_getString(HTML_OUTPUT)+"/"+
+                            OutputGenerator::inlineImageName(OutputGenerator::Html,"inline_mscgraph_");
         std::ofstream file(baseName.str()+".msc",std::ofstream::out | std::ofstream::binary);
         if (!file.is_open())
         {
@@ -628,7 +616,9 @@ void HtmlDocVisitor::visit(DocVerbatim *s)
         {
           format = PlantumlManager::PUML_SVG;
         }
-        QCString baseName = PlantumlManager::instance().writePlantUMLSource(htmlOutput,s->exampleFile(),s->text(),format);
+        QCString baseName = PlantumlManager::instance().writePlantUMLSource(htmlOutput,
+            s->exampleFile().isEmpty() ? OutputGenerator::inlineImageName(OutputGenerator::Html,"inline_umlgraph_") : s->exampleFile(),
+            s->text(),format);
         m_t << "<div class=\"plantumlgraph\">\n";
         writePlantUMLFile(baseName,s->relPath(),s->context());
         visitPreCaption(m_t, s);
@@ -16,7 +16,6 @@
 #include <stdlib.h>
 #include <assert.h>
 
-#include <mutex>
 #include <sstream>
 
 #include "message.h"
@@ -923,7 +922,7 @@ void HtmlGenerator::init()
   }
 
   {
-    std::ofstream f(dname+"/dynsections.js",std::ofstream::out | std::ofstream::binary);
+    OutputFileStream f(dname.str()+"/dynsections.js");
     if (f.is_open())
     {
       TextStream t(&f);
@@ -998,7 +997,7 @@ void HtmlGenerator::writeSearchData(const char *dname)
   }
 
   QCString searchDirName = dname;
-  std::ofstream f(searchDirName.str()+"/search.css",std::ofstream::out | std::ofstream::binary);
+  OutputFileStream f(searchDirName.str()+"/search.css");
   if (f.is_open())
   {
     TextStream t(&f);
@@ -1038,8 +1037,6 @@ void HtmlGenerator::writeFooterFile(TextStream &t)
   t << ResourceMgr::instance().getAsString("footer.html");
 }
 
-static std::mutex g_indexLock;
-
 void HtmlGenerator::startFile(const char *name,const char *,
                               const char *title,int id)
 {
@@ -1051,10 +1048,7 @@ void HtmlGenerator::startFile(const char *name,const char *,
   startPlainFile(fileName);
   m_codeGen.setId(id);
   m_codeGen.setRelativePath(m_relPath);
-  {
-    std::lock_guard<std::mutex> lock(g_indexLock);
-    Doxygen::indexList->addIndexFile(fileName);
-  }
+  Doxygen::indexList->addIndexFile(fileName);
 
   m_lastFile = fileName;
   m_t << substituteHtmlKeywords(g_header,convertToHtml(filterTitle(title?title:"")),m_relPath);
@@ -2563,7 +2557,7 @@ void HtmlGenerator::writeSearchPage()
 
   // OPENSEARCH_PROVIDER {
   QCString configFileName = htmlOutput+"/search_config.php";
-  std::ofstream f(configFileName.str(),std::ofstream::out | std::ofstream::binary);
+  OutputFileStream f(configFileName.str());
   if (f.is_open())
   {
     TextStream t(&f);
@@ -2594,7 +2588,7 @@ void HtmlGenerator::writeSearchPage()
   // OPENSEARCH_PROVIDER }
 
   QCString fileName = htmlOutput+"/search.php";
-  f.open(fileName.str(),std::ofstream::out | std::ofstream::binary);
+  f.open(fileName.str());
   if (f.is_open())
   {
     TextStream t(&f);
@@ -2633,7 +2627,7 @@ void HtmlGenerator::writeSearchPage()
   f.close();
 
   QCString scriptName = htmlOutput+"/search/search.js";
-  f.open(scriptName.str(),std::ofstream::out | std::ofstream::binary);
+  f.open(scriptName.str());
   if (f.is_open())
   {
     TextStream t(&f);
@@ -2650,7 +2644,7 @@ void HtmlGenerator::writeExternalSearchPage()
   bool generateTreeView = Config_getBool(GENERATE_TREEVIEW);
   QCString dname = Config_getString(HTML_OUTPUT);
   QCString fileName = dname+"/search"+Doxygen::htmlFileExtension;
-  std::ofstream f(fileName.str(),std::ofstream::out | std::ofstream::binary);
+  OutputFileStream f(fileName.str());
   if (f.is_open())
   {
     TextStream t(&f);
@@ -2702,7 +2696,7 @@ void HtmlGenerator::writeExternalSearchPage()
   f.close();
 
   QCString scriptName = dname+"/search/search.js";
-  f.open(scriptName.str(),std::ofstream::out | std::ofstream::binary);
+  f.open(scriptName.str());
   if (f.is_open())
   {
     TextStream t(&f);
@@ -16,10 +16,17 @@
  *
  */
 
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include "image.h"
 #include <math.h>
 #include "lodepng.h"
 #include "config.h"
+#include "threadpool.h"
 
 typedef unsigned char  Byte;
 
@@ -379,17 +386,38 @@ void Image::fillRect(uint x,uint y,uint width,uint height,uchar colIndex,uint ma
         setPixel(xp,yp,colIndex);
 }
 
-bool Image::save(const char *fileName,int mode)
+static const Color *imagePalette(int mode,uint *numCols)
 {
   static bool useTransparency = Config_getBool(FORMULA_TRANSPARENT);
+  *numCols = mode==0 ? 8 : 16;
+  return mode==0         ? palette  :
+         useTransparency ? palette2 :
+                           palette3 ;
+}
+
+// applies PNG_COMPRESSION_LEVEL and PNG_PALETTE_FILTERING to the encoder settings
+static void initEncoder(LodePNG_Encoder &encoder)
+{
+  LodePNG_Encoder_init(&encoder);
+  int level = Config_getInt(PNG_COMPRESSION_LEVEL);
+  if (level==0) // store without compression
+  {
+    encoder.settings.zlibsettings.btype = 0;
+  }
+  else // the window doubles per level, level 5 is lodepng's default of 2048
+  {
+    encoder.settings.zlibsettings.windowSize = 128u<<(level-1);
+  }
+  encoder.settings.paletteFilter = Config_getBool(PNG_PALETTE_FILTERING) ? 1 : 0;
+}
+
+static void savePalettePng(const char *fileName,const uchar *data,uint width,uint height,
+                           const Color *pPal,uint numCols)
+{
   uchar* buffer;
   size_t bufferSize;
   LodePNG_Encoder encoder;
-  LodePNG_Encoder_init(&encoder);
-  uint numCols = mode==0 ? 8 : 16;
-  Color *pPal = mode==0         ? palette  :
-                useTransparency ? palette2 :
-                                  palette3 ;
+  initEncoder(encoder);
   uint i;
   for (i=0;i<numCols;i++,pPal++)
   {
@@ -398,13 +426,73 @@ bool Image::save(const char *fileName,int mode)
   }
   encoder.infoPng.color.colorType = 3;
   encoder.infoRaw.color.colorType = 3;
-  LodePNG_encode(&encoder, &buffer, &bufferSize, m_data, m_width, m_height);
+  LodePNG_encode(&encoder, &buffer, &bufferSize, data, width, height);
   LodePNG_saveFile(buffer, bufferSize, fileName);
   free(buffer);
   LodePNG_Encoder_cleanup(&encoder);
+}
+
+bool Image::save(const char *fileName,int mode)
+{
+  uint numCols;
+  const Color *pPal = imagePalette(mode,&numCols);
+  savePalettePng(fileName,m_data,m_width,m_height,pPal,numCols);
   return TRUE;
 }
 
+// background encoding of images passed to Image::saveAsync()
+static std::mutex g_encodeMutex;
+static std::unique_ptr<ThreadPool> g_encodePool;
+static std::vector< std::future<void> > g_encodeResults;
+
+void Image::saveAsync(const QCString &fileName,int mode)
+{
+  static std::size_t numThreads = []()
+  {
+    std::size_t n = static_cast<std::size_t>(Config_getInt(NUM_PROC_THREADS));
+    return n==0 ? static_cast<std::size_t>(std::thread::hardware_concurrency()) : n;
+  }();
+  if (numThreads<=1)
+  {
+    save(fileName.data(),mode);
+    return;
+  }
+
+  // the encoder gets its own copy of the pixels and the palette
+  uint numCols;
+  const Color *pPal = imagePalette(mode,&numCols);
+  auto pixels = std::make_shared< std::vector<uchar> >(m_data,m_data+m_width*m_height);
+  auto colors = std::make_shared< std::vector<Color> >(pPal,pPal+numCols);
+  uint width  = m_width;
+  uint height = m_height;
+
+  std::lock_guard<std::mutex> lock(g_encodeMutex);
+  if (!g_encodePool)
+  {
+    g_encodePool = std::make_unique<ThreadPool>(numThreads);
+  }
+  g_encodeResults.emplace_back(g_encodePool->queue([fileName,pixels,colors,width,height]()
+  {
+    savePalettePng(fileName.data(),pixels->data(),width,height,colors->data(),
+                   static_cast<uint>(colors->size()));
+  }));
+}
+
+void Image::finishSaves()
+{
+  std::lock_guard<std::mutex> lock(g_encodeMutex);
+  for (auto &r : g_encodeResults)
+  {
+    r.get();
+  }
+  g_encodeResults.clear();
+  if (g_encodePool)
+  {
+    g_encodePool->finish();
+    g_encodePool.reset();
+  }
+}
+
 //----------------------------------------------------------------
 
 void ColoredImage::hsl2rgb(double h,double s,double l,
@@ -509,7 +597,7 @@ bool ColoredImage::save(const char *fileName)
   uchar *buffer;
   size_t bufferSize;
   LodePNG_Encoder encoder;
-  LodePNG_Encoder_init(&encoder);
+  initEncoder(encoder);
   encoder.infoPng.color.colorType = m_hasAlpha ? 6 : 2; // 2=RGB 24 bit, 6=RGBA 32 bit
   encoder.infoRaw.color.colorType = 6; // 6=RGBA 32 bit
   LodePNG_encode(&encoder, &buffer, &bufferSize, m_data, m_width, m_height);
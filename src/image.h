@@ -20,6 +20,7 @@
 #define _IMAGE_H
 
 #include "types.h"
+#include "qcstring.h"
 
 /** Class representing a bitmap image generated by doxygen. */
 class Image
@@ -39,6 +40,16 @@ class Image
     void drawRect(uint x,uint y,uint width,uint height,uchar colIndex,uint mask);
     void fillRect(uint x,uint y,uint width,uint height,uchar colIndex,uint mask);
     bool save(const char *fileName,int mode=0);
+
+    /** Saves the image like save(), but encodes and writes the PNG file in a
+     *  background thread, so the caller can continue right away. The image
+     *  can be changed or destroyed after this call.
+     */
+    void saveAsync(const QCString &fileName,int mode=0);
+
+    /** Waits until all images passed to saveAsync() are written */
+    static void finishSaves();
+
     friend uint stringLength(const char *s);
     uint width() const { return m_width; }
     uint height() const { return m_height; }
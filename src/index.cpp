@@ -76,6 +76,8 @@ int documentedHtmlFiles;
 int documentedPages;
 int documentedDirs;
 
+thread_local IndexList::Recording *IndexList::s_recording = 0;
+
 static int countClassHierarchy(ClassDef::CompoundType ct);
 static void countFiles(int &htmlFiles,int &files);
 static int countGroups();
@@ -5166,7 +5168,7 @@ static void writeMenuData()
   if (!Config_getBool(GENERATE_HTML) || Config_getBool(DISABLE_INDEX)) return;
   QCString outputDir = Config_getBool(HTML_OUTPUT);
   LayoutNavEntry *root = LayoutDocManager::instance().rootNavEntry();
-  std::ofstream t(outputDir.str()+"/menudata.js",std::ofstream::out | std::ofstream::binary);
+  OutputFileStream t(outputDir.str()+"/menudata.js");
   if (t.is_open())
   {
     t << JAVASCRIPT_LICENSE_TEXT;
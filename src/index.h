@@ -19,6 +19,10 @@
 #include <utility>
 #include <vector>
 #include <memory>
+#include <mutex>
+#include <functional>
+#include <string>
+#include <tuple>
 
 #include "qcstring.h"
 
@@ -53,15 +57,70 @@ class IndexIntf
  */
 class IndexList : public IndexIntf
 {
+  public:
+    /** @brief The calls made to the index list by one thread while recording.
+     *
+     *  Pages generated by multiple threads record their calls, which are
+     *  then replayed in the order of the pages, so the indices do not depend
+     *  on the order in which the threads finish.
+     */
+    class Recording
+    {
+      public:
+        /** Records the calls of the current thread until stop() is called */
+        void start() { s_recording = this; }
+        void stop()  { s_recording = 0; }
+        /** Forwards the recorded calls to the index generators */
+        void replay() const { for (const auto &call : m_calls) call(); }
+      private:
+        friend class IndexList;
+        std::vector< std::function<void()> > m_calls;
+    };
+
   private:
     std::vector< std::unique_ptr<IndexIntf> > m_intfs;
+    std::mutex m_mutex;
+    static thread_local Recording *s_recording;
+
+    // A recorded string argument is copied, as the original may not live until the replay.
+    struct RecordedString
+    {
+      RecordedString(const char *s) : isNull(s==0), str(s ? s : "") {}
+      const char *get() const { return isNull ? 0 : str.c_str(); }
+      bool isNull;
+      std::string str;
+    };
+    template<class T>
+    static T recordArg(T value) { return value; }
+    static RecordedString recordArg(const char *s) { return RecordedString(s); }
+    template<class T>
+    static const T &replayArg(const T &value) { return value; }
+    static const char *replayArg(const RecordedString &s) { return s.get(); }
+
+    template<class... Ts,class Tuple,std::size_t... Is>
+    void replayCall(void (IndexIntf::*methodPtr)(Ts...),const Tuple &args,std::index_sequence<Is...>)
+    {
+      foreach(methodPtr,replayArg(std::get<Is>(args))...);
+    }
 
     // For each index format we forward the method call.
     // We use C++11 variadic templates and perfect forwarding to implement foreach() generically,
     // and split the types of the methods from the arguments passed to allow implicit conversions.
+    // Pages can be generated by multiple threads, so the calls are serialized, or recorded
+    // if the thread is recording.
     template<class... Ts,class... As>
     void foreach(void (IndexIntf::*methodPtr)(Ts...),As&&... args)
     {
+      if (s_recording)
+      {
+        auto recordedArgs = std::make_tuple(recordArg(args)...);
+        s_recording->m_calls.push_back([this,methodPtr,recordedArgs]()
+        {
+          replayCall(methodPtr,recordedArgs,std::index_sequence_for<As...>());
+        });
+        return;
+      }
+      std::lock_guard<std::mutex> lock(m_mutex);
       for (const auto &intf : m_intfs)
       {
         (intf.get()->*methodPtr)(std::forward<As>(args)...);
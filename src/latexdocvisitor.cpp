@@ -374,14 +374,8 @@ void LatexDocVisitor::visit(DocVerbatim *s)
       break;
     case DocVerbatim::Dot:
       {
-        static int dotindex = 1;
-        QCString fileName(4096);
-
-        fileName.sprintf("%s%d%s",
-            (Config_getString(LATEX_OUTPUT)+"/inline_dotgraph_").data(),
-            dotindex++,
-            ".dot"
-           );
+        QCString fileName = Config_getString(LATEX_OUTPUT)+"/"+
+                            OutputGenerator::inlineImageName(OutputGenerator::Latex,"inline_dotgraph_")+".dot";
         std::ofstream file(fileName.str(),std::ofstream::out | std::ofstream::binary);
         if (!file.is_open())
         {
@@ -402,13 +396,8 @@ void LatexDocVisitor::visit(DocVerbatim *s)
       break;
     case DocVerbatim::Msc:
       {
-        static int mscindex = 1;
-        QCString baseName(4096);
-
-        baseName.sprintf("%s%d",
-            (Config_getString(LATEX_OUTPUT)+"/inline_mscgraph_").data(),
-            mscindex++
-           );
+        QCString baseName = Config_getString(LATEX_OUTPUT)+"/"+
+                            OutputGenerator::inlineImageName(OutputGenerator::Latex,"inline_mscgraph_");
         std::string fileName = baseName.str()+".msc";
         std::ofstream file(fileName,std::ofstream::out | std::ofstream::binary);
         if (!file.is_open())
@@ -432,7 +421,9 @@ void LatexDocVisitor::visit(DocVerbatim *s)
     case DocVerbatim::PlantUML:
       {
         QCString latexOutput = Config_getString(LATEX_OUTPUT);
-        QCString baseName = PlantumlManager::instance().writePlantUMLSource(latexOutput,s->exampleFile(),s->text(),PlantumlManager::PUML_EPS);
+        QCString baseName = PlantumlManager::instance().writePlantUMLSource(latexOutput,
+            s->exampleFile().isEmpty() ? OutputGenerator::inlineImageName(OutputGenerator::Latex,"inline_umlgraph_") : s->exampleFile(),
+            s->text(),PlantumlManager::PUML_EPS);
 
         writePlantUMLFile(baseName, s);
       }
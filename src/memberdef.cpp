@@ -16,6 +16,7 @@
 
 #include <stdio.h>
 #include <assert.h>
+#include <mutex>
 
 #include "md5.h"
 #include "memberdef.h"
@@ -32,6 +33,7 @@
 #include "groupdef.h"
 #include "defargs.h"
 #include "docparser.h"
+#include "docrootcache.h"
 #include "dot.h"
 #include "dotcallgraph.h"
 #include "searchindex.h"
@@ -44,6 +46,7 @@
 #include "config.h"
 #include "definitionimpl.h"
 #include "regex.h"
+#include "stringpool.h"
 
 //-----------------------------------------------------------------------------
 
@@ -1158,7 +1161,7 @@ class MemberDefImpl::IMPL
 
     ExampleList examples;     // a dictionary of all examples for quick access
 
-    QCString type;            // return actual type
+    InternedString type;      // return actual type
     QCString accessorType;    // return type that tell how to get to this member
     ClassDef *accessorClass = 0;  // class that this member accesses (for anonymous types)
     QCString args;            // function arguments/variable array specifiers
@@ -1171,7 +1174,7 @@ class MemberDefImpl::IMPL
     QCString bitfields;       // struct member bitfields
     QCString read;            // property read accessor
     QCString write;           // property write accessor
-    QCString exception;       // exceptions that can be thrown
+    InternedString exception; // exceptions that can be thrown
     QCString initializer;     // initializer
     QCString extraTypeChars;  // extra type info found after the argument list
     QCString enumBaseType;    // base type of the enum (C++11)
@@ -1252,7 +1255,7 @@ class MemberDefImpl::IMPL
                                       // FALSE => block is put before declaration.
     ClassDef *category = 0;
     const MemberDef *categoryRelation = 0;
-    QCString declFileName;
+    InternedString declFileName;
     int declLine = -1;
     int declColumn = -1;
     int numberOfFlowKW = 0;
@@ -1290,15 +1293,15 @@ void MemberDefImpl::IMPL::init(Definition *d,
   hasReferencedByRelation = FALSE;
   hasReferencesRelation = FALSE;
   initLines=0;
-  type=t;
-  if (mt==MemberType_Typedef) type.stripPrefix("typedef ");
-  //  type.stripPrefix("struct ");
-  //  type.stripPrefix("class " );
-  //  type.stripPrefix("union " );
-  type=removeRedundantWhiteSpace(type);
+  QCString ltype=t;
+  if (mt==MemberType_Typedef) ltype.stripPrefix("typedef ");
+  //  ltype.stripPrefix("struct ");
+  //  ltype.stripPrefix("class " );
+  //  ltype.stripPrefix("union " );
+  type=removeRedundantWhiteSpace(ltype);
   args=a;
   args=removeRedundantWhiteSpace(args);
-  if (type.isEmpty()) decl=d->name()+args; else decl=type+" "+d->name()+args;
+  if (type.isEmpty()) decl=d->name()+args; else decl=QCString(type)+" "+d->name()+args;
 
   memberGroup=0;
   virt=v;
@@ -2363,7 +2366,7 @@ void MemberDefImpl::writeDeclaration(OutputList &ol,
   else if (isTypeAlias()) // using template alias
   {
     ol.writeString(" = ");
-    linkifyText(TextGeneratorOLImpl(ol),d,getBodyDef(),this,m_impl->type);
+    linkifyText(TextGeneratorOLImpl(ol),d,getBodyDef(),this,m_impl->type.data());
   }
 
 
@@ -2450,14 +2453,14 @@ void MemberDefImpl::writeDeclaration(OutputList &ol,
       /* && !annMemb */
      )
   {
-    DocRoot *rootNode = validatingParseDoc(briefFile(),briefLine(),
+    std::shared_ptr<DocRoot> rootNode = DocRootCache::instance().parse(briefFile(),briefLine(),
                 getOuterScope()?getOuterScope():d,this,briefDescription(),TRUE,FALSE,
                 0,TRUE,FALSE,Config_getBool(MARKDOWN_SUPPORT));
 
     if (rootNode && !rootNode->isEmpty())
     {
       ol.startMemberDescription(anchor(),inheritId);
-      ol.writeDoc(rootNode,getOuterScope()?getOuterScope():d,this);
+      ol.writeDoc(rootNode.get(),getOuterScope()?getOuterScope():d,this);
       if (detailsVisible)
       {
         ol.pushGeneratorState();
@@ -2478,7 +2481,6 @@ void MemberDefImpl::writeDeclaration(OutputList &ol,
       ol.popGeneratorState();
       ol.endMemberDescription();
     }
-    delete rootNode;
   }
 
   ol.endMemberDeclaration(anchor(),inheritId);
@@ -4157,7 +4159,7 @@ MemberDefMutable *MemberDefImpl::createTemplateInstanceMember(
                        substituteTemplateArgumentsInString(m_impl->type.str(),formalArgs,actualArgs),
                        methodName,
                        substituteTemplateArgumentsInString(m_impl->args.str(),formalArgs,actualArgs),
-                       m_impl->exception, m_impl->prot,
+                       m_impl->exception.data(), m_impl->prot,
                        m_impl->virt, m_impl->stat, m_impl->related, m_impl->mtype,
                        ArgumentList(), ArgumentList(), ""
                    );
@@ -4742,7 +4744,7 @@ const char *MemberDefImpl::extraTypeChars() const
 
 const char *MemberDefImpl::typeString() const
 {
-  return m_impl->type;
+  return m_impl->type.data();
 }
 
 const char *MemberDefImpl::argsString() const
@@ -4752,7 +4754,7 @@ const char *MemberDefImpl::argsString() const
 
 const char *MemberDefImpl::excpString() const
 {
-  return m_impl->exception;
+  return m_impl->exception.data();
 }
 
 const char *MemberDefImpl::bitfieldString() const
@@ -5984,9 +5986,12 @@ bool MemberDefImpl::isReference() const
 //-------------------------------------------------------------------------------
 // Helpers
 
+static std::mutex g_docCrossReferenceMutex;
+
 void addDocCrossReference(MemberDefMutable *src,MemberDefMutable *dst)
 {
   if (src==0 || dst==0) return;
+  std::lock_guard<std::mutex> lock(g_docCrossReferenceMutex);
   //printf("--> addDocCrossReference src=%s,dst=%s\n",src->name().data(),dst->name().data());
   if (dst->isTypedef() || dst->isEnumerate()) return; // don't add types
   if ((dst->hasReferencedByRelation() || dst->hasCallerGraph()) &&
@@ -29,6 +29,7 @@
 #include "membergroup.h"
 #include "config.h"
 #include "docparser.h"
+#include "docrootcache.h"
 
 MemberList::MemberList() : m_listType(MemberListType_pubMethods)
 {
@@ -426,7 +427,7 @@ void MemberList::writePlainDeclarations(OutputList &ol,
               ol.endMemberItem();
               if (!md->briefDescription().isEmpty() && Config_getBool(BRIEF_MEMBER_DESC))
               {
-                DocRoot *rootNode = validatingParseDoc(
+                std::shared_ptr<DocRoot> rootNode = DocRootCache::instance().parse(
                     md->briefFile(),md->briefLine(),
                     cd,md,
                     md->briefDescription(),
@@ -436,7 +437,7 @@ void MemberList::writePlainDeclarations(OutputList &ol,
                 if (rootNode && !rootNode->isEmpty())
                 {
                   ol.startMemberDescription(md->anchor());
-                  ol.writeDoc(rootNode,cd,md);
+                  ol.writeDoc(rootNode.get(),cd,md);
                   if (md->isDetailedSectionLinkable())
                   {
                     ol.disableAllBut(OutputGenerator::Html);
@@ -449,7 +450,6 @@ void MemberList::writePlainDeclarations(OutputList &ol,
                   }
                   ol.endMemberDescription();
                 }
-                delete rootNode;
               }
               ol.endMemberDeclaration(md->anchor(),inheritId);
             }
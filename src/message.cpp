@@ -36,6 +36,7 @@ enum warn_as_error
 };
 static warn_as_error warnBehavior = WARN_NO;
 static bool warnStat = false;
+static thread_local int warnThreadCount = 0;
 
 static std::mutex g_mutex;
 
@@ -116,6 +117,7 @@ static void format_warn(const char *file,int line,const char *text)
     exit(1);
   }
   warnStat = true;
+  warnThreadCount++;
 }
 
 static void handle_warn_as_error()
@@ -246,6 +248,11 @@ void term(const char *fmt, ...)
   exit(1);
 }
 
+int warn_thread_count()
+{
+  return warnThreadCount;
+}
+
 void warn_flush()
 {
   fflush(warnFile);
@@ -37,6 +37,8 @@ extern void err_full(const char *file,int line,const char *fmt, ...) PRINTFLIKE(
 extern void term(const char *fmt, ...) PRINTFLIKE(1, 2);
 void initWarningFormat();
 void warn_flush();
+/** Returns the number of warnings issued so far by the calling thread. */
+int warn_thread_count();
 extern void finishWarnExit();
 
 extern void printlex(int dbg, bool enter, const char *lexName, const char *fileName);
@@ -15,7 +15,9 @@
  *
  */
 
+#include <atomic>
 #include <stdexcept>
+#include <unordered_map>
 
 #include <stdlib.h>
 
@@ -23,6 +25,24 @@
 #include "outputgen.h"
 #include "message.h"
 #include "portable.h"
+#include "config.h"
+#include "fileinfo.h"
+#include "dir.h"
+#include "util.h"
+
+static std::atomic<size_t> g_filesChanged(0);
+static std::atomic<size_t> g_filesUnchanged(0);
+
+/** @brief The page a generator is writing and the numbers handed out on it */
+struct PageIndices
+{
+  QCString page;
+  std::unordered_map<std::string,int> counts;
+};
+
+// per output type, since the generators of all types write the same page
+static thread_local PageIndices t_pageIndices[OutputGenerator::Docbook+1];
+static std::atomic<int> g_noPageIndex(0);
 
 OutputGenerator::OutputGenerator(const char *dir) : m_t(nullptr), m_dir(dir)
 {
@@ -61,6 +81,18 @@ void OutputGenerator::startPlainFile(const char *name)
 {
   //printf("startPlainFile(%s)\n",name);
   m_fileName=m_dir+"/"+name;
+  PageIndices &pi = t_pageIndices[type()];
+  pi.page = stripPath(name);
+  int i = pi.page.findRev('.');
+  if (i!=-1) pi.page = pi.page.left(i);
+  pi.counts.clear();
+  m_inMemory = Config_getBool(WRITE_CHANGED_FILES_ONLY);
+  if (m_inMemory) // collect the output and write it when the file is complete
+  {
+    m_memFile.str(std::string());
+    m_t.setStream(&m_memFile);
+    return;
+  }
   m_file.open(m_fileName.str(),std::ofstream::out | std::ofstream::binary);
   if (!m_file.is_open())
   {
@@ -73,10 +105,158 @@ void OutputGenerator::endPlainFile()
 {
   m_t.flush();
   m_t.setStream(nullptr);
-  m_file.close();
+  if (m_inMemory)
+  {
+    if (!writeFileIfChanged(m_fileName,m_memFile.str()))
+    {
+      term("Could not open file %s for writing\n",m_fileName.data());
+    }
+    m_memFile.str(std::string());
+    m_inMemory = false;
+  }
+  else
+  {
+    m_file.close();
+  }
   m_fileName.resize(0);
+  PageIndices &pi = t_pageIndices[type()];
+  pi.page.resize(0);
+  pi.counts.clear();
+}
+
+int OutputGenerator::nextPageIndex(OutputType type,const char *kind)
+{
+  PageIndices &pi = t_pageIndices[type];
+  if (pi.page.isEmpty())
+  {
+    return ++g_noPageIndex;
+  }
+  return ++pi.counts[kind];
+}
+
+QCString OutputGenerator::inlineImageName(OutputType type,const char *prefix)
+{
+  int index = nextPageIndex(type,prefix);
+  const QCString &page = t_pageIndices[type].page;
+  return page.isEmpty() ? prefix+QCString().setNum(index) :
+                          prefix+page+"_"+QCString().setNum(index);
+}
+
+bool OutputGenerator::writeFileIfChanged(const QCString &fileName,const std::string &contents)
+{
+  // compare with the current contents of the file, the size is checked first
+  // so only files of the same size need to be read.
+  FileInfo fi(fileName.str());
+  if (fi.exists() && fi.isFile() && fi.size()==contents.size())
+  {
+    std::ifstream f(fileName.str(),std::ifstream::in | std::ifstream::binary);
+    if (f.is_open())
+    {
+      std::string old(contents.size(),'\0');
+      f.read(&old[0],static_cast<std::streamsize>(old.size()));
+      if (static_cast<size_t>(f.gcount())==old.size() && old==contents)
+      {
+        g_filesUnchanged++;
+        return true;
+      }
+    }
+  }
+
+  // write to a temporary file next to the target, and move it in place, so
+  // the target never has partial contents.
+  std::string tmpName = tempFileName(fileName.str());
+  {
+    std::ofstream f(tmpName,std::ofstream::out | std::ofstream::binary);
+    if (!f.is_open()) return false;
+    f.write(contents.c_str(),static_cast<std::streamsize>(contents.size()));
+    if (!f.good()) return false;
+  }
+  Dir dir;
+  if (!dir.rename(tmpName,fileName.str(),true))
+  {
+    // the target could not be replaced (e.g. it is in use), overwrite it instead
+    dir.remove(tmpName);
+    std::ofstream f(fileName.str(),std::ofstream::out | std::ofstream::binary);
+    if (!f.is_open()) return false;
+    f.write(contents.c_str(),static_cast<std::streamsize>(contents.size()));
+  }
+  g_filesChanged++;
+  return true;
+}
+
+void OutputGenerator::printFileStatistics()
+{
+  if (!Config_getBool(WRITE_CHANGED_FILES_ONLY)) return;
+  msg("Output files: %zu written, %zu unchanged\n",
+      g_filesChanged.load(),g_filesUnchanged.load());
 }
 
+//---------------------------------------------------------------------------
+
+OutputFileStream::OutputFileStream() : std::ostream(nullptr)
+{
+}
+
+OutputFileStream::OutputFileStream(const std::string &fileName) : std::ostream(nullptr)
+{
+  open(fileName);
+}
+
+OutputFileStream::~OutputFileStream()
+{
+  close();
+}
+
+void OutputFileStream::open(const std::string &fileName)
+{
+  close();
+  m_fileName = fileName;
+  m_inMemory = Config_getBool(WRITE_CHANGED_FILES_ONLY);
+  if (m_inMemory)
+  {
+    m_memBuf.str(std::string());
+    rdbuf(&m_memBuf);
+    clear();
+  }
+  else if (m_fileBuf.open(fileName,std::ios_base::out | std::ios_base::binary))
+  {
+    rdbuf(&m_fileBuf);
+    clear();
+  }
+  else
+  {
+    rdbuf(nullptr); // sets the badbit
+  }
+}
+
+bool OutputFileStream::is_open() const
+{
+  return m_inMemory ? !m_fileName.empty() : m_fileBuf.is_open();
+}
+
+void OutputFileStream::close()
+{
+  if (!is_open()) return;
+  flush();
+  if (m_inMemory)
+  {
+    if (!OutputGenerator::writeFileIfChanged(m_fileName.c_str(),m_memBuf.str()))
+    {
+      err("Could not write file %s\n",m_fileName.c_str());
+      setstate(std::ios_base::failbit);
+    }
+    m_memBuf.str(std::string());
+  }
+  else if (!m_fileBuf.close())
+  {
+    setstate(std::ios_base::failbit);
+  }
+  m_fileName.clear();
+  rdbuf(nullptr);
+}
+
+//---------------------------------------------------------------------------
+
 QCString OutputGenerator::dir() const
 {
   return m_dir;
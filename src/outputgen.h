@@ -22,6 +22,7 @@
 #include <stack>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 
 #include "index.h"
 #include "section.h"
@@ -348,6 +349,29 @@ class OutputGenerator : public BaseOutputDocInterface
 
     void startPlainFile(const char *name);
     void endPlainFile();
+
+    /** Writes \a contents to file \a fileName, unless the file already has these contents.
+     *  The file is replaced atomically. Returns FALSE if the file could not be written.
+     */
+    static bool writeFileIfChanged(const QCString &fileName,const std::string &contents);
+
+    /** Reports how many files were written and how many were left unchanged
+     *  by writeFileIfChanged().
+     */
+    static void printFileStatistics();
+
+    /** Returns the next number for things of kind \a kind on the page that the generator
+     *  of type \a type is writing on the calling thread. The numbers restart for each page,
+     *  so they do not depend on the order in which threads write the pages.
+     *  Outside of a page a number that is unique for the run is returned.
+     */
+    static int nextPageIndex(OutputType type,const char *kind);
+
+    /** Returns a file name starting with \a prefix for an image generated for
+     *  the page that the generator of type \a type is writing on the calling thread,
+     *  for instance <code>inline_dotgraph_classA_2</code>.
+     */
+    static QCString inlineImageName(OutputType type,const char *prefix);
     //QCString getContents() const;
     bool isEnabled() const { return m_active; }
     void pushGeneratorState();
@@ -504,6 +528,8 @@ class OutputGenerator : public BaseOutputDocInterface
     QCString m_dir;
     QCString m_fileName;
     std::ofstream m_file;
+    std::ostringstream m_memFile; // used if WRITE_CHANGED_FILES_ONLY is enabled
+    bool m_inMemory = false;
     bool m_active = true;
     std::stack<bool> m_genStack;
 };
@@ -561,4 +587,34 @@ class OutputDocInterface : public BaseOutputDocInterface
     virtual void popGeneratorState() = 0;
 };
 
+/** @brief Output file that is not touched when its contents do not change.
+ *
+ *  Can be used instead of a std::ofstream for output files that are not written
+ *  via OutputGenerator::startPlainFile(). If \c WRITE_CHANGED_FILES_ONLY is
+ *  enabled the output is collected in memory and written by
+ *  OutputGenerator::writeFileIfChanged() when the file is closed, otherwise the
+ *  file is written directly.
+ */
+class OutputFileStream : public std::ostream
+{
+  public:
+    OutputFileStream();
+    OutputFileStream(const std::string &fileName);
+   ~OutputFileStream();
+    OutputFileStream(const OutputFileStream &) = delete;
+    OutputFileStream &operator=(const OutputFileStream &) = delete;
+
+    /** Opens file \a fileName for writing in binary mode */
+    void open(const std::string &fileName);
+    bool is_open() const;
+    /** Closes the file, writing it if the output was collected in memory */
+    void close();
+
+  private:
+    std::string    m_fileName;
+    bool           m_inMemory = false;
+    std::filebuf   m_fileBuf;
+    std::stringbuf m_memBuf;
+};
+
 #endif
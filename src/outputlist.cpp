@@ -30,6 +30,7 @@
 #include "message.h"
 #include "definition.h"
 #include "docparser.h"
+#include "docrootcache.h"
 #include "vhdldocgen.h"
 #include "doxygen.h"
 
@@ -158,12 +159,10 @@ void OutputList::generateDoc(const char *fileName,int startLine,
   // specified as:
   // - when only XML format there should be warnings as well (XML has its own write routines)
   // - no formats there should be warnings as well
-  DocRoot *root=0;
-  root = validatingParseDoc(fileName,startLine,
+  std::shared_ptr<DocRoot> root = DocRootCache::instance().parse(fileName,startLine,
                             ctx,md,docStr,indexWords,isExample,exampleName,
                             singleLine,linkFromIndex,markdownSupport);
-  if (count>0) writeDoc(root,ctx,md,m_id);
-  delete root;
+  if (count>0) writeDoc(root.get(),ctx,md,m_id);
 }
 
 void OutputList::writeDoc(DocRoot *root,const Definition *ctx,const MemberDef *md,int)
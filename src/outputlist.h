@@ -22,6 +22,7 @@
 
 #include "index.h" // for IndexSections
 #include "outputgen.h"
+#include "trace.h"
 
 class ClassDiagram;
 class DotClassGraph;
@@ -87,6 +88,7 @@ class OutputList : public OutputDocInterface
     { forall(&OutputGenerator::writeStyleInfo,part); }
     void startFile(const char *name,const char *manName,const char *title)
     {
+      if (Trace::isEnabled()) Trace::begin("page",name,title);
       newId();
       forall(&OutputGenerator::startFile,name,manName,title,m_id);
     }
@@ -95,7 +97,10 @@ class OutputList : public OutputDocInterface
     void writeFooter(const char *navPath)
     { forall(&OutputGenerator::writeFooter,navPath); }
     void endFile()
-    { forall(&OutputGenerator::endFile); }
+    {
+      forall(&OutputGenerator::endFile);
+      if (Trace::isEnabled()) Trace::end("page");
+    }
     void startTitleHead(const char *fileName)
     { forall(&OutputGenerator::startTitleHead,fileName); }
     void endTitleHead(const char *fileName,const char *name)
@@ -0,0 +1,730 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+
+#include "md5.h"
+
+#include "parsecache.h"
+#include "entry.h"
+#include "filedef.h"
+#include "pre.h"
+#include "config.h"
+#include "doxygen.h"
+#include "message.h"
+#include "util.h"
+#include "fileinfo.h"
+#include "dir.h"
+#include "version.h"
+#include "trace.h"
+
+// Increase when the layout of a cache entry changes
+static const int  g_cacheFormatVersion = 2;
+static const int  g_cacheMagic         = 0x44585043; // 'DXPC'
+
+static thread_local bool g_fileIsCacheable = true;
+static thread_local int  g_fileWarnCount   = 0;
+
+//---------------------------------------------------------------------------
+
+/** Helper to serialize the parts of a cache entry into a byte buffer */
+class CacheWriter
+{
+  public:
+    void writeInt(int v)         { m_buf.append(reinterpret_cast<const char*>(&v),sizeof(v)); }
+    void writeUInt64(uint64 v)   { m_buf.append(reinterpret_cast<const char*>(&v),sizeof(v)); }
+    void writeBool(bool b)       { m_buf+=(b ? '\1' : '\0'); }
+    void writeString(const QCString &s)
+    {
+      writeInt((int)s.length());
+      if (!s.isEmpty()) m_buf.append(s.data(),s.length());
+    }
+    const std::string &data() const { return m_buf; }
+  private:
+    std::string m_buf;
+};
+
+/** Helper to deserialize the parts of a cache entry from a byte buffer.
+ *  Reading past the end of the buffer sets an error state instead of
+ *  crashing, so a truncated or corrupt file just results in a cache miss.
+ */
+class CacheReader
+{
+  public:
+    CacheReader(const std::string &buf) : m_buf(buf) {}
+    int readInt()
+    {
+      int v=0;
+      readRaw(&v,sizeof(v));
+      return v;
+    }
+    uint64 readUInt64()
+    {
+      uint64 v=0;
+      readRaw(&v,sizeof(v));
+      return v;
+    }
+    bool readBool()
+    {
+      char c=0;
+      readRaw(&c,1);
+      return c!=0;
+    }
+    QCString readString()
+    {
+      int len = readInt();
+      if (len<0 || m_pos+len>m_buf.size()) { m_ok=false; return QCString(); }
+      QCString result(m_buf.substr(m_pos,len));
+      m_pos+=len;
+      return result;
+    }
+    bool ok() const    { return m_ok; }
+    bool atEnd() const { return m_pos==m_buf.size(); }
+  private:
+    void readRaw(void *dst,size_t len)
+    {
+      if (!m_ok || m_pos+len>m_buf.size()) { m_ok=false; return; }
+      memcpy(dst,m_buf.data()+m_pos,len);
+      m_pos+=len;
+    }
+    const std::string &m_buf;
+    size_t m_pos = 0;
+    bool m_ok = true;
+};
+
+//---------------------------------------------------------------------------
+
+static void writeArgumentList(CacheWriter &w,const ArgumentList &al)
+{
+  w.writeInt((int)al.size());
+  for (const Argument &a : al)
+  {
+    w.writeString(a.attrib);
+    w.writeString(a.type);
+    w.writeString(a.canType);
+    w.writeString(a.name);
+    w.writeString(a.array);
+    w.writeString(a.defval);
+    w.writeString(a.docs);
+    w.writeString(a.typeConstraint);
+  }
+  w.writeBool(al.constSpecifier());
+  w.writeBool(al.volatileSpecifier());
+  w.writeBool(al.pureSpecifier());
+  w.writeString(al.trailingReturnType());
+  w.writeBool(al.isDeleted());
+  w.writeInt((int)al.refQualifier());
+  w.writeBool(al.noParameters());
+}
+
+static void readArgumentList(CacheReader &r,ArgumentList &al)
+{
+  al.reset();
+  int count = r.readInt();
+  for (int i=0;i<count && r.ok();i++)
+  {
+    Argument a;
+    a.attrib         = r.readString();
+    a.type           = r.readString();
+    a.canType        = r.readString();
+    a.name           = r.readString();
+    a.array          = r.readString();
+    a.defval         = r.readString();
+    a.docs           = r.readString();
+    a.typeConstraint = r.readString();
+    al.push_back(a);
+  }
+  al.setConstSpecifier(r.readBool());
+  al.setVolatileSpecifier(r.readBool());
+  al.setPureSpecifier(r.readBool());
+  al.setTrailingReturnType(r.readString());
+  al.setIsDeleted(r.readBool());
+  al.setRefQualifier((RefQualifierType)r.readInt());
+  al.setNoParameters(r.readBool());
+}
+
+static void writeEntry(CacheWriter &w,const Entry *e)
+{
+  w.writeInt(e->section);
+  w.writeString(e->type);
+  w.writeString(e->name);
+  w.writeBool(e->hasTagInfo);
+  w.writeString(e->tagInfoData.tagName);
+  w.writeString(e->tagInfoData.fileName);
+  w.writeString(e->tagInfoData.anchor);
+  w.writeInt((int)e->protection);
+  w.writeInt((int)e->mtype);
+  w.writeUInt64(e->spec);
+  w.writeInt(e->initLines);
+  w.writeBool(e->stat);
+  w.writeBool(e->explicitExternal);
+  w.writeBool(e->proto);
+  w.writeBool(e->subGrouping);
+  w.writeBool(e->callGraph);
+  w.writeBool(e->callerGraph);
+  w.writeBool(e->referencedByRelation);
+  w.writeBool(e->referencesRelation);
+  w.writeInt((int)e->virt);
+  w.writeString(e->args);
+  w.writeString(e->bitfields);
+  writeArgumentList(w,e->argList);
+  w.writeInt((int)e->tArgLists.size());
+  for (const ArgumentList &al : e->tArgLists)
+  {
+    writeArgumentList(w,al);
+  }
+  w.writeString(QCString(e->program.str()));
+  w.writeString(QCString(e->initializer.str()));
+  w.writeString(e->includeFile);
+  w.writeString(e->includeName);
+  w.writeString(e->doc);
+  w.writeInt(e->docLine);
+  w.writeString(e->docFile);
+  w.writeString(e->brief);
+  w.writeInt(e->briefLine);
+  w.writeString(e->briefFile);
+  w.writeString(e->inbodyDocs);
+  w.writeInt(e->inbodyLine);
+  w.writeString(e->inbodyFile);
+  w.writeString(e->relates);
+  w.writeInt((int)e->relatesType);
+  w.writeString(e->read);
+  w.writeString(e->write);
+  w.writeString(e->inside);
+  w.writeString(e->exception);
+  writeArgumentList(w,e->typeConstr);
+  w.writeInt(e->bodyLine);
+  w.writeInt(e->bodyColumn);
+  w.writeInt(e->endBodyLine);
+  w.writeInt(e->mGrpId);
+  w.writeInt((int)e->extends.size());
+  for (const BaseInfo &bi : e->extends)
+  {
+    w.writeString(bi.name);
+    w.writeInt((int)bi.prot);
+    w.writeInt((int)bi.virt);
+  }
+  w.writeInt((int)e->groups.size());
+  for (const Grouping &g : e->groups)
+  {
+    w.writeString(g.groupname);
+    w.writeInt((int)g.pri);
+  }
+  w.writeString(e->fileName);
+  w.writeInt(e->startLine);
+  w.writeInt(e->startColumn);
+  w.writeInt((int)e->lang);
+  w.writeBool(e->hidden);
+  w.writeBool(e->artificial);
+  w.writeInt((int)e->groupDocType);
+  w.writeString(e->id);
+  w.writeInt(e->localToc.mask());
+  w.writeInt(e->localToc.htmlLevel());
+  w.writeInt(e->localToc.latexLevel());
+  w.writeInt(e->localToc.xmlLevel());
+  w.writeInt(e->localToc.docbookLevel());
+  w.writeString(e->metaData);
+  w.writeString(e->req);
+  w.writeInt((int)e->children().size());
+  for (const auto &child : e->children())
+  {
+    writeEntry(w,child.get());
+  }
+}
+
+static void readEntry(CacheReader &r,Entry *e)
+{
+  e->section              = r.readInt();
+  e->type                 = r.readString();
+  e->name                 = r.readString();
+  e->hasTagInfo           = r.readBool();
+  e->tagInfoData.tagName  = r.readString();
+  e->tagInfoData.fileName = r.readString();
+  e->tagInfoData.anchor   = r.readString();
+  e->protection           = (Protection)r.readInt();
+  e->mtype                = (MethodTypes)r.readInt();
+  e->spec                 = r.readUInt64();
+  e->initLines            = r.readInt();
+  e->stat                 = r.readBool();
+  e->explicitExternal     = r.readBool();
+  e->proto                = r.readBool();
+  e->subGrouping          = r.readBool();
+  e->callGraph            = r.readBool();
+  e->callerGraph          = r.readBool();
+  e->referencedByRelation = r.readBool();
+  e->referencesRelation   = r.readBool();
+  e->virt                 = (Specifier)r.readInt();
+  e->args                 = r.readString();
+  e->bitfields            = r.readString();
+  readArgumentList(r,e->argList);
+  int numTArgLists = r.readInt();
+  for (int i=0;i<numTArgLists && r.ok();i++)
+  {
+    ArgumentList al;
+    readArgumentList(r,al);
+    e->tArgLists.push_back(al);
+  }
+  e->program.str(r.readString().str());
+  e->initializer.str(r.readString().str());
+  e->includeFile          = r.readString();
+  e->includeName          = r.readString();
+  e->doc                  = r.readString();
+  e->docLine              = r.readInt();
+  e->docFile              = r.readString();
+  e->brief                = r.readString();
+  e->briefLine            = r.readInt();
+  e->briefFile            = r.readString();
+  e->inbodyDocs           = r.readString();
+  e->inbodyLine           = r.readInt();
+  e->inbodyFile           = r.readString();
+  e->relates              = r.readString();
+  e->relatesType          = (RelatesType)r.readInt();
+  e->read                 = r.readString();
+  e->write                = r.readString();
+  e->inside               = r.readString();
+  e->exception            = r.readString();
+  readArgumentList(r,e->typeConstr);
+  e->bodyLine             = r.readInt();
+  e->bodyColumn           = r.readInt();
+  e->endBodyLine          = r.readInt();
+  e->mGrpId               = r.readInt();
+  int numExtends = r.readInt();
+  for (int i=0;i<numExtends && r.ok();i++)
+  {
+    QCString name  = r.readString();
+    Protection prot = (Protection)r.readInt();
+    Specifier virt  = (Specifier)r.readInt();
+    e->extends.push_back(BaseInfo(name,prot,virt));
+  }
+  int numGroups = r.readInt();
+  for (int i=0;i<numGroups && r.ok();i++)
+  {
+    QCString name = r.readString();
+    Grouping::GroupPri_t pri = (Grouping::GroupPri_t)r.readInt();
+    e->groups.push_back(Grouping(name,pri));
+  }
+  e->fileName             = r.readString();
+  e->startLine            = r.readInt();
+  e->startColumn          = r.readInt();
+  e->lang                 = (SrcLangExt)r.readInt();
+  e->hidden               = r.readBool();
+  e->artificial           = r.readBool();
+  e->groupDocType         = (Entry::GroupDocType)r.readInt();
+  e->id                   = r.readString();
+  int tocMask      = r.readInt();
+  int htmlLevel    = r.readInt();
+  int latexLevel   = r.readInt();
+  int xmlLevel     = r.readInt();
+  int docbookLevel = r.readInt();
+  if (tocMask & (1<<LocalToc::Html))    e->localToc.enableHtml(htmlLevel);
+  if (tocMask & (1<<LocalToc::Latex))   e->localToc.enableLatex(latexLevel);
+  if (tocMask & (1<<LocalToc::Xml))     e->localToc.enableXml(xmlLevel);
+  if (tocMask & (1<<LocalToc::Docbook)) e->localToc.enableDocbook(docbookLevel);
+  e->metaData             = r.readString();
+  e->req                  = r.readString();
+  int numChildren = r.readInt();
+  for (int i=0;i<numChildren && r.ok();i++)
+  {
+    std::shared_ptr<Entry> child = std::make_shared<Entry>();
+    readEntry(r,child.get());
+    e->moveToSubEntryAndKeep(child);
+  }
+}
+
+//---------------------------------------------------------------------------
+
+static QCString md5String(const char *buf,size_t len)
+{
+  uchar md5_sig[16];
+  QCString sigStr(33);
+  MD5Buffer((const unsigned char *)buf,(unsigned int)len,md5_sig);
+  MD5SigToString(md5_sig,sigStr.rawData(),33);
+  return sigStr;
+}
+
+static bool readRawFile(const std::string &fileName,std::string &contents)
+{
+  std::ifstream f(fileName,std::ifstream::in | std::ifstream::binary);
+  if (!f.is_open()) return false;
+  contents.assign(std::istreambuf_iterator<char>(f),std::istreambuf_iterator<char>());
+  return !f.bad();
+}
+
+//---------------------------------------------------------------------------
+
+struct ParseCache::Private
+{
+  /** Returns the MD5 of the file's raw contents, or an empty string if it could not be read.
+   *  Headers are typically a dependency of many files, so results are remembered.
+   */
+  QCString fileHash(const std::string &fileName)
+  {
+    {
+      std::lock_guard<std::mutex> lock(hashMutex);
+      auto it = hashes.find(fileName);
+      if (it!=hashes.end()) return it->second;
+    }
+    std::string contents;
+    QCString hash;
+    if (readRawFile(fileName,contents))
+    {
+      hash = md5String(contents.data(),contents.size());
+    }
+    std::lock_guard<std::mutex> lock(hashMutex);
+    hashes.insert(std::make_pair(fileName,hash));
+    return hash;
+  }
+  std::string entryPath(const QCString &key) const
+  {
+    return cacheDir+"/"+key.str()+".entry";
+  }
+
+  bool enabled = false;
+  std::string cacheDir;
+  QCString configKey;
+  std::mutex hashMutex;
+  std::unordered_map<std::string,QCString> hashes;
+  std::atomic_int numHits   { 0 };
+  std::atomic_int numMisses { 0 };
+  std::atomic_int numStored { 0 };
+};
+
+ParseCache::ParseCache() : p(std::make_unique<Private>())
+{
+}
+
+ParseCache::~ParseCache()
+{
+}
+
+ParseCache &ParseCache::instance()
+{
+  static ParseCache cache;
+  return cache;
+}
+
+void ParseCache::init()
+{
+  QCString cacheDir = Config_getString(PARSE_CACHE_DIR);
+  if (cacheDir.isEmpty()) return;
+  if (Doxygen::clangAssistedParsing)
+  {
+    warn_uncond("PARSE_CACHE_DIR cannot be combined with CLANG_ASSISTED_PARSING, the parse cache is disabled.\n");
+    return;
+  }
+  Dir d(cacheDir.str());
+  if (!d.exists() && !d.mkdir(cacheDir.str()))
+  {
+    warn_uncond("cannot create parse cache directory '%s', the parse cache is disabled.\n",qPrint(cacheDir));
+    return;
+  }
+  p->cacheDir = d.absPath();
+
+  // collect the options that influence the outcome of parsing a file
+  TextStream t;
+  auto addList = [&t](const char *name,const StringVector &list)
+  {
+    t << name << "=";
+    for (const auto &s : list) t << s << '\1';
+    t << "\n";
+  };
+  t << "version="                << getDoxygenVersion() << "\n";
+  t << "format="                 << g_cacheFormatVersion << "\n";
+  t << "ENABLE_PREPROCESSING="   << Config_getBool(ENABLE_PREPROCESSING) << "\n";
+  t << "MACRO_EXPANSION="        << Config_getBool(MACRO_EXPANSION) << "\n";
+  t << "EXPAND_ONLY_PREDEF="     << Config_getBool(EXPAND_ONLY_PREDEF) << "\n";
+  t << "SEARCH_INCLUDES="        << Config_getBool(SEARCH_INCLUDES) << "\n";
+  t << "SKIP_FUNCTION_MACROS="   << Config_getBool(SKIP_FUNCTION_MACROS) << "\n";
+  t << "MARKDOWN_SUPPORT="       << Config_getBool(MARKDOWN_SUPPORT) << "\n";
+  t << "JAVADOC_AUTOBRIEF="      << Config_getBool(JAVADOC_AUTOBRIEF) << "\n";
+  t << "JAVADOC_BANNER="         << Config_getBool(JAVADOC_BANNER) << "\n";
+  t << "QT_AUTOBRIEF="           << Config_getBool(QT_AUTOBRIEF) << "\n";
+  t << "MULTILINE_CPP_IS_BRIEF=" << Config_getBool(MULTILINE_CPP_IS_BRIEF) << "\n";
+  t << "PYTHON_DOCSTRING="       << Config_getBool(PYTHON_DOCSTRING) << "\n";
+  t << "INTERNAL_DOCS="          << Config_getBool(INTERNAL_DOCS) << "\n";
+  t << "HIDE_IN_BODY_DOCS="      << Config_getBool(HIDE_IN_BODY_DOCS) << "\n";
+  t << "CPP_CLI_SUPPORT="        << Config_getBool(CPP_CLI_SUPPORT) << "\n";
+  t << "IDL_PROPERTY_SUPPORT="   << Config_getBool(IDL_PROPERTY_SUPPORT) << "\n";
+  t << "SIP_SUPPORT="            << Config_getBool(SIP_SUPPORT) << "\n";
+  t << "BUILTIN_STL_SUPPORT="    << Config_getBool(BUILTIN_STL_SUPPORT) << "\n";
+  t << "OPTIMIZE_OUTPUT_FOR_C="  << Config_getBool(OPTIMIZE_OUTPUT_FOR_C) << "\n";
+  t << "OPTIMIZE_OUTPUT_JAVA="   << Config_getBool(OPTIMIZE_OUTPUT_JAVA) << "\n";
+  t << "OPTIMIZE_FOR_FORTRAN="   << Config_getBool(OPTIMIZE_FOR_FORTRAN) << "\n";
+  t << "OPTIMIZE_OUTPUT_VHDL="   << Config_getBool(OPTIMIZE_OUTPUT_VHDL) << "\n";
+  t << "OPTIMIZE_OUTPUT_SLICE="  << Config_getBool(OPTIMIZE_OUTPUT_SLICE) << "\n";
+  t << "EXTRACT_ANON_NSPACES="   << Config_getBool(EXTRACT_ANON_NSPACES) << "\n";
+  t << "FORCE_LOCAL_INCLUDES="   << Config_getBool(FORCE_LOCAL_INCLUDES) << "\n";
+  t << "GROUP_NESTED_COMPOUNDS=" << Config_getBool(GROUP_NESTED_COMPOUNDS) << "\n";
+  t << "SHOW_INCLUDE_FILES="     << Config_getBool(SHOW_INCLUDE_FILES) << "\n";
+  t << "TYPEDEF_HIDES_STRUCT="   << Config_getBool(TYPEDEF_HIDES_STRUCT) << "\n";
+  t << "CALL_GRAPH="             << Config_getBool(CALL_GRAPH) << "\n";
+  t << "CALLER_GRAPH="           << Config_getBool(CALLER_GRAPH) << "\n";
+  t << "REFERENCED_BY_RELATION=" << Config_getBool(REFERENCED_BY_RELATION) << "\n";
+  t << "REFERENCES_RELATION="    << Config_getBool(REFERENCES_RELATION) << "\n";
+  t << "CASE_SENSE_NAMES="       << Config_getBool(CASE_SENSE_NAMES) << "\n";
+  t << "TAB_SIZE="               << Config_getInt(TAB_SIZE) << "\n";
+  t << "TOC_INCLUDE_HEADINGS="   << Config_getInt(TOC_INCLUDE_HEADINGS) << "\n";
+  t << "INPUT_ENCODING="         << Config_getString(INPUT_ENCODING) << "\n";
+  t << "INPUT_FILTER="           << Config_getString(INPUT_FILTER) << "\n";
+  t << "USE_MDFILE_AS_MAINPAGE=" << Config_getString(USE_MDFILE_AS_MAINPAGE) << "\n";
+  t << "OUTPUT_LANGUAGE="        << Config_getEnum(OUTPUT_LANGUAGE) << "\n";
+  addList("PREDEFINED",            Config_getList(PREDEFINED));
+  addList("EXPAND_AS_DEFINED",     Config_getList(EXPAND_AS_DEFINED));
+  addList("INCLUDE_PATH",          Config_getList(INCLUDE_PATH));
+  addList("INCLUDE_FILE_PATTERNS", Config_getList(INCLUDE_FILE_PATTERNS));
+  addList("EXCLUDE_PATTERNS",      Config_getList(EXCLUDE_PATTERNS));
+  addList("FILTER_PATTERNS",       Config_getList(FILTER_PATTERNS));
+  addList("EXTENSION_MAPPING",     Config_getList(EXTENSION_MAPPING));
+  addList("ALIASES",               Config_getList(ALIASES));
+  addList("ENABLED_SECTIONS",      Config_getList(ENABLED_SECTIONS));
+  std::string options = t.str();
+  p->configKey = md5String(options.data(),options.size());
+  p->enabled = true;
+}
+
+bool ParseCache::isEnabled() const
+{
+  return p->enabled;
+}
+
+QCString ParseCache::computeKey(const char *fileName,const char *buf,uint len) const
+{
+  MD5Context ctx;
+  MD5Init(&ctx);
+  MD5Update(&ctx,(const unsigned char *)p->configKey.data(),p->configKey.length());
+  MD5Update(&ctx,(const unsigned char *)fileName,(unsigned int)qstrlen(fileName)+1);
+  MD5Update(&ctx,(const unsigned char *)buf,len);
+  uchar md5_sig[16];
+  MD5Final(md5_sig,&ctx);
+  QCString sigStr(33);
+  MD5SigToString(md5_sig,sigStr.rawData(),33);
+  return sigStr;
+}
+
+std::shared_ptr<Entry> ParseCache::restore(const QCString &key,const char *fileName,FileDef *fd)
+{
+  std::string data;
+  if (!p->enabled || !readRawFile(p->entryPath(key),data))
+  {
+    p->numMisses++;
+    return nullptr;
+  }
+  CacheReader r(data);
+  if (r.readInt()!=g_cacheMagic || r.readInt()!=g_cacheFormatVersion)
+  {
+    p->numMisses++;
+    return nullptr;
+  }
+
+  // check that none of the files included while preprocessing changed
+  int numDeps = r.readInt();
+  for (int i=0;i<numDeps && r.ok();i++)
+  {
+    QCString depName = r.readString();
+    QCString depHash = r.readString();
+    if (!r.ok() || p->fileHash(depName.str())!=depHash)
+    {
+      p->numMisses++;
+      return nullptr;
+    }
+  }
+
+  // check that no file appeared where an include file was looked for
+  int numMissing = r.readInt();
+  for (int i=0;i<numMissing && r.ok();i++)
+  {
+    QCString missingName = r.readString();
+    if (!r.ok() || FileInfo(missingName.str()).exists())
+    {
+      p->numMisses++;
+      return nullptr;
+    }
+  }
+
+  IncludeInfoList includes;
+  int numIncludes = r.readInt();
+  for (int i=0;i<numIncludes && r.ok();i++)
+  {
+    QCString incFile  = r.readString();
+    IncludeInfo ii;
+    ii.includeName    = r.readString();
+    ii.local          = r.readBool();
+    ii.imported       = r.readBool();
+    if (!incFile.isEmpty())
+    {
+      bool ambig;
+      ii.fileDef = findFileDef(Doxygen::inputNameLinkedMap,incFile,ambig);
+      if (ambig) ii.fileDef=0;
+    }
+    includes.push_back(ii);
+  }
+
+  DefineList defines;
+  int numDefines = r.readInt();
+  for (int i=0;i<numDefines && r.ok();i++)
+  {
+    Define def;
+    def.name         = r.readString();
+    def.definition   = r.readString();
+    def.fileName     = r.readString();
+    def.args         = r.readString();
+    def.lineNr       = r.readInt();
+    def.columnNr     = r.readInt();
+    def.nargs        = r.readInt();
+    def.undef        = r.readBool();
+    def.varArgs      = r.readBool();
+    def.isPredefined = r.readBool();
+    def.nonRecursive = r.readBool();
+    defines.push_back(def);
+  }
+
+  std::shared_ptr<Entry> root = std::make_shared<Entry>();
+  readEntry(r,root.get());
+  if (!r.ok() || !r.atEnd())
+  {
+    warn_uncond("ignoring corrupt parse cache entry '%s'\n",p->entryPath(key).c_str());
+    p->numMisses++;
+    return nullptr;
+  }
+
+  if (numIncludes>0 || numDefines>0)
+  {
+    Preprocessor::restoreFileResults(fileName,fd,includes,defines);
+  }
+  p->numHits++;
+  return root;
+}
+
+void ParseCache::store(const QCString &key,const char *fileName,FileDef *fd,
+                       const std::shared_ptr<Entry> &root,const Preprocessor *preprocessor)
+{
+  if (!p->enabled || !isCacheable()) return;
+
+  CacheWriter w;
+  w.writeInt(g_cacheMagic);
+  w.writeInt(g_cacheFormatVersion);
+  if (preprocessor)
+  {
+    const StringSet &deps = preprocessor->dependencies();
+    w.writeInt((int)deps.size());
+    for (const auto &dep : deps)
+    {
+      w.writeString(QCString(dep));
+      w.writeString(p->fileHash(dep));
+    }
+    const StringSet &missing = preprocessor->missingIncludes();
+    w.writeInt((int)missing.size());
+    for (const auto &name : missing)
+    {
+      w.writeString(QCString(name));
+    }
+    // the preprocessor only records include relations for files that are known to doxygen
+    const IncludeInfoList &includes = fd->includeFileList();
+    w.writeInt((int)includes.size());
+    for (const auto &ii : includes)
+    {
+      w.writeString(ii.fileDef ? ii.fileDef->absFilePath() : QCString());
+      w.writeString(ii.includeName);
+      w.writeBool(ii.local);
+      w.writeBool(ii.imported);
+    }
+    const DefineList &defines = preprocessor->macroDefinitions();
+    w.writeInt((int)defines.size());
+    for (const auto &def : defines)
+    {
+      w.writeString(def.name);
+      w.writeString(def.definition);
+      w.writeString(def.fileName);
+      w.writeString(def.args);
+      w.writeInt(def.lineNr);
+      w.writeInt(def.columnNr);
+      w.writeInt(def.nargs);
+      w.writeBool(def.undef);
+      w.writeBool(def.varArgs);
+      w.writeBool(def.isPredefined);
+      w.writeBool(def.nonRecursive);
+    }
+  }
+  else
+  {
+    w.writeInt(0); // dependencies
+    w.writeInt(0); // missing includes
+    w.writeInt(0); // includes
+    w.writeInt(0); // defines
+  }
+  writeEntry(w,root.get());
+
+  // write to a temporary file first, so an interrupted run cannot leave a truncated entry behind
+  std::string entryName = p->entryPath(key);
+  std::string tmpName   = tempFileName(entryName);
+  {
+    std::ofstream f(tmpName,std::ofstream::out | std::ofstream::binary);
+    if (!f.is_open())
+    {
+      warn_uncond("cannot write parse cache entry for '%s'\n",fileName);
+      return;
+    }
+    f.write(w.data().data(),w.data().size());
+    if (f.fail())
+    {
+      warn_uncond("problems while writing parse cache entry for '%s'\n",fileName);
+      return;
+    }
+  }
+  Dir d;
+  d.remove(entryName);
+  if (d.rename(tmpName,entryName))
+  {
+    p->numStored++;
+  }
+}
+
+void ParseCache::startFile()
+{
+  g_fileIsCacheable = true;
+  g_fileWarnCount   = warn_thread_count();
+}
+
+void ParseCache::markUncacheable()
+{
+  g_fileIsCacheable = false;
+}
+
+bool ParseCache::isCacheable()
+{
+  // a cache hit would not reproduce the warnings issued while parsing
+  return g_fileIsCacheable && g_fileWarnCount==warn_thread_count();
+}
+
+void ParseCache::printStatistics() const
+{
+  if (p->enabled)
+  {
+    msg("Parse cache: %d files restored, %d files parsed, %d files stored\n",
+        p->numHits.load(),p->numMisses.load(),p->numStored.load());
+  }
+}
+
+void ParseCache::traceStatistics() const
+{
+  if (p->enabled)
+  {
+    Trace::counter("parse cache","restored",p->numHits.load());
+    Trace::counter("parse cache","parsed",p->numMisses.load());
+  }
+}
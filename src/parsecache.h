@@ -0,0 +1,96 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef PARSECACHE_H
+#define PARSECACHE_H
+
+#include <memory>
+
+#include "qcstring.h"
+#include "containers.h"
+
+class Entry;
+class FileDef;
+class Preprocessor;
+
+/** @brief Persistent cache of the results of parsing an input file.
+ *
+ *  The cache is stored in the directory set by \c PARSE_CACHE_DIR. Each
+ *  entry is keyed by the MD5 of the file's contents, its name, the doxygen
+ *  version and the configuration options that influence parsing. Next to the
+ *  Entry tree produced by the language parser an entry records the include
+ *  relations and macro definitions found by the preprocessor, the files
+ *  that were included while preprocessing, and the paths where an include
+ *  file was looked for but did not exist. A cached result is only used
+ *  when none of these files changed and none of these paths exist.
+ *
+ *  Parsing a file can have side effects outside of its Entry tree, such as
+ *  registering sections, formulas, citations or anonymous scope names.
+ *  Code producing such side effects calls markUncacheable(), after which the
+ *  result of parsing the current file is not stored.
+ */
+class ParseCache
+{
+  public:
+    static ParseCache &instance();
+
+    /** Prepares the cache for use. Does nothing if \c PARSE_CACHE_DIR is empty. */
+    void init();
+
+    /** Returns TRUE if the cache is active for this run. */
+    bool isEnabled() const;
+
+    /** Computes the key for file \a fileName whose (filtered) contents are
+     *  given by \a buf with length \a len.
+     */
+    QCString computeKey(const char *fileName,const char *buf,uint len) const;
+
+    /** Tries to restore the results of parsing the file with the given
+     *  \a key. If successful the include relations and macro definitions
+     *  are registered for \a fd and the Entry tree is returned. Otherwise
+     *  a null pointer is returned.
+     */
+    std::shared_ptr<Entry> restore(const QCString &key,const char *fileName,FileDef *fd);
+
+    /** Stores \a root as the result of parsing the file with the given \a key.
+     *  If \a preprocessor is not null, its dependencies and macro definitions
+     *  are stored as well.
+     */
+    void store(const QCString &key,const char *fileName,FileDef *fd,
+               const std::shared_ptr<Entry> &root,const Preprocessor *preprocessor);
+
+    /** Signals the start of parsing a file on the calling thread */
+    static void startFile();
+
+    /** Marks the file being parsed by the calling thread as not cacheable */
+    static void markUncacheable();
+
+    /** Returns TRUE if the file parsed by the calling thread can be stored */
+    static bool isCacheable();
+
+    /** Reports the number of hits and misses */
+    void printStatistics() const;
+
+    /** Adds the current counters to the trace, see Trace::counter() */
+    void traceStatistics() const;
+
+  private:
+    ParseCache();
+   ~ParseCache();
+    struct Private;
+    std::unique_ptr<Private> p;
+};
+
+#endif
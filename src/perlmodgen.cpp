@@ -25,6 +25,7 @@
 
 #include "perlmodgen.h"
 #include "docparser.h"
+#include "docrootcache.h"
 #include "message.h"
 #include "doxygen.h"
 #include "pagedef.h"
@@ -1451,7 +1452,7 @@ static void addPerlModDocBlock(PerlModOutput &output,
   if (stext.isEmpty())
     output.addField(name).add("{}");
   else {
-    DocNode *root = validatingParseDoc(fileName,lineNr,scope,md,stext,FALSE,FALSE,
+    std::shared_ptr<DocRoot> root = DocRootCache::instance().parse(fileName,lineNr,scope,md,stext,FALSE,FALSE,
                                        0,FALSE,FALSE,Config_getBool(MARKDOWN_SUPPORT));
     output.openHash(name);
     PerlModDocVisitor *visitor = new PerlModDocVisitor(output);
@@ -1459,7 +1460,6 @@ static void addPerlModDocBlock(PerlModOutput &output,
     visitor->finish();
     output.closeHash();
     delete visitor;
-    delete root;
   }
 }
 
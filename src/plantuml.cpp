@@ -13,6 +13,14 @@
  *
  */
 
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include <string.h>
+
 #include "plantuml.h"
 #include "util.h"
 #include "portable.h"
@@ -21,9 +29,21 @@
 #include "message.h"
 #include "debug.h"
 #include "fileinfo.h"
+#include "dir.h"
+#include "md5.h"
+
+#if !defined(_WIN32) || defined(__CYGWIN__)
+#include <pthread.h>
+#include <signal.h>
+#include <sys/wait.h>
+#define HAS_SIGNALS
+#endif
+
+static std::mutex g_plantUmlMutex;
 
 QCString PlantumlManager::writePlantUMLSource(const QCString &outDirArg,const QCString &fileName,const QCString &content,OutputFormat format)
 {
+  std::lock_guard<std::mutex> lock(g_plantUmlMutex);
   QCString baseName;
   QCString puName;
   QCString imgName;
@@ -75,12 +95,7 @@ QCString PlantumlManager::writePlantUMLSource(const QCString &outDirArg,const QC
   text+=content;
   text+="\n@enduml\n";
 
-  QCString qcOutDir(outDir);
-  uint pos = qcOutDir.findRev("/");
-  QCString generateType(qcOutDir.right(qcOutDir.length() - (pos + 1)) );
-  Debug::print(Debug::Plantuml,0,"*** %s generateType: %s\n","writePlantUMLSource",qPrint(generateType));
-  PlantumlManager::instance().insert(generateType.str(),puName.str(),outDir,format,text);
-  Debug::print(Debug::Plantuml,0,"*** %s generateType: %s\n","writePlantUMLSource",qPrint(generateType));
+  insert(baseName,format,text);
 
   return baseName;
 }
@@ -127,36 +142,24 @@ PlantumlManager &PlantumlManager::instance()
 PlantumlManager::PlantumlManager()
 {
   QCString outputFilename = Config_getString(OUTPUT_DIRECTORY) + "/" + CACHE_FILENAME;
-  FileInfo fi(outputFilename.str());
-  if (fi.exists())
+  std::ifstream f(outputFilename.str(),std::ifstream::in);
+  if (f.is_open())
   {
-    m_cachedPlantumlAllContent = fileToString(outputFilename);
+    std::string line;
+    while (getline(f,line))
+    {
+      if (!line.empty()) m_cachedDiagrams.insert(line);
+    }
   }
-  Debug::print(Debug::Plantuml,0,"*** instance() : m_cachedPlantumlAllContent = [%s]\n",qPrint(m_cachedPlantumlAllContent));
+  Debug::print(Debug::Plantuml,0,"*** instance() : %zu cached diagrams\n",m_cachedDiagrams.size());
 }
 
-static void runPlantumlContent(const PlantumlManager::FilesMap &plantumlFiles,
-                               const PlantumlManager::ContentMap &plantumlContent,
-                               PlantumlManager::OutputFormat format)
+static QCString plantumlArguments()
 {
-  /* example : running: java -Djava.awt.headless=true
-               -jar "/usr/local/bin/plantuml.jar"
-               -o "test_doxygen/DOXYGEN_OUTPUT/html"
-               -tpng
-               "test_doxygen/DOXYGEN_OUTPUT/html/A.pu"
-               -charset UTF-8
-               outDir:test_doxygen/DOXYGEN_OUTPUT/html
-               test_doxygen/DOXYGEN_OUTPUT/html/A
-   */
-  int exitCode;
   QCString plantumlJarPath = Config_getString(PLANTUML_JAR_PATH);
   QCString plantumlConfigFile = Config_getString(PLANTUML_CFG_FILE);
   QCString dotPath = Config_getString(DOT_PATH);
-
-  QCString pumlExe = "java";
   QCString pumlArgs = "";
-  QCString pumlType = "";
-  QCString pumlOutDir = "";
 
   const StringVector &pumlIncludePathList = Config_getList(PLANTUML_INCLUDE_PATH);
   {
@@ -190,195 +193,350 @@ static void runPlantumlContent(const PlantumlManager::FilesMap &plantumlFiles,
     pumlArgs += Portable::commandExtension();
     pumlArgs += "\" ";
   }
+  return pumlArgs;
+}
+
+static const char *plantumlType(PlantumlManager::OutputFormat format)
+{
   switch (format)
   {
-    case PlantumlManager::PUML_BITMAP:
-      pumlType="png";
-      break;
-    case PlantumlManager::PUML_EPS:
-      pumlType="eps";
-      break;
-    case PlantumlManager::PUML_SVG:
-      pumlType="svg";
-      break;
+    case PlantumlManager::PUML_BITMAP: return "png";
+    case PlantumlManager::PUML_EPS:    return "eps";
+    case PlantumlManager::PUML_SVG:    return "svg";
+  }
+  return "";
+}
+
+// written by PlantUML after each image, so the images can be split up again
+static const char *g_pipeDelimiter = "___doxygen_plantuml_image_end___";
+
+// returns TRUE if the diagram is split in pages by newpage, PlantUML then writes
+// an image per page
+static bool hasMultiplePages(const QCString &content)
+{
+  const char *p = content.data();
+  while (p && *p)
+  {
+    while (*p==' ' || *p=='\t') p++;
+    if (qstrncmp(p,"newpage",7)==0 && (p[7]=='\0' || p[7]==' ' || p[7]=='\t' || p[7]=='\r' || p[7]=='\n'))
+    {
+      return TRUE;
+    }
+    p = strchr(p,'\n');
+    if (p) p++;
   }
+  return FALSE;
+}
 
+#ifdef HAS_SIGNALS
+/** Blocks SIGPIPE for the calling thread while it writes to a PlantUML process.
+ *
+ *  If PlantUML exits early, the write then fails instead of stopping doxygen. A
+ *  SIGPIPE raised meanwhile is taken from the pending signals before the previous
+ *  signal mask is restored, so the signal handling of the rest of doxygen is not
+ *  changed.
+ */
+class SigPipeBlocker
+{
+  public:
+    SigPipeBlocker()
+    {
+      sigemptyset(&m_set);
+      sigaddset(&m_set,SIGPIPE);
+      m_blocked = pthread_sigmask(SIG_BLOCK,&m_set,&m_oldSet)==0 && !sigismember(&m_oldSet,SIGPIPE);
+      if (m_blocked)
+      {
+        sigset_t pending;
+        m_wasPending = sigpending(&pending)==0 && sigismember(&pending,SIGPIPE);
+      }
+    }
+   ~SigPipeBlocker()
+    {
+      if (!m_blocked) return;
+      sigset_t pending;
+      if (!m_wasPending && sigpending(&pending)==0 && sigismember(&pending,SIGPIPE))
+      {
+        int sig;
+        sigwait(&m_set,&sig); // returns at once, as the signal is pending
+      }
+      pthread_sigmask(SIG_SETMASK,&m_oldSet,0);
+    }
+    SigPipeBlocker(const SigPipeBlocker &) = delete;
+    SigPipeBlocker &operator=(const SigPipeBlocker &) = delete;
+
+  private:
+    sigset_t m_set;
+    sigset_t m_oldSet;
+    bool m_blocked = false;
+    bool m_wasPending = false;
+};
+#else
+class SigPipeBlocker {};
+#endif
+
+static void runEpstopdf(const std::string &image)
+{
+  Debug::print(Debug::Plantuml,0,"*** %s Running epstopdf for %s\n","runEpstopdf",image.c_str());
+  QCString epstopdfArgs = "\""+QCString(image)+".eps\" --outfile=\""+QCString(image)+".pdf\"";
+  int exitCode;
+  if ((exitCode=Portable::system("epstopdf",epstopdfArgs))!=0)
   {
-    for (const auto &kv : plantumlContent)
+    err("Problems running epstopdf. Check your TeX installation! Exit code: %d\n",exitCode);
+  }
+}
+
+/** A PlantUML process in pipe mode that renders all diagrams of one image format.
+ *
+ *  The process is started for the first diagram that needs to be rendered, and the
+ *  diagrams are written to its input while the output is still being generated.
+ *  PlantUML writes the images, each followed by g_pipeDelimiter, to a single file
+ *  that is split into the image files by finish().
+ *
+ *  A diagram with more than one page results in an image per page, which cannot be
+ *  told apart from the images of the next diagrams. Such diagrams are rendered by
+ *  finish() with a PlantUML process per diagram instead.
+ */
+class PlantumlManager::Process
+{
+  public:
+    Process(OutputFormat format) : m_format(format) {}
+   ~Process()
+    {
+      if (m_pipe)
+      {
+        SigPipeBlocker blocker;
+        Portable::pclose(m_pipe);
+      }
+    }
+
+    /** Renders diagram \a content into the image \a baseName plus the extension for the format */
+    void add(const QCString &baseName,const QCString &content)
     {
-      const PlantumlContent &nb = kv.second;
-      QCString pumlArguments = pumlArgs;
-      msg("Generating PlantUML %s Files in %s\n",qPrint(pumlType),kv.first.c_str());
-      pumlArguments+="-o \"";
-      pumlArguments+=nb.outDir;
-      pumlArguments+="\" ";
-      pumlArguments+="-charset UTF-8 -t";
-      pumlArguments+=pumlType;
-      pumlArguments+=" ";
-
-      QCString puFileName("");
-      puFileName+=nb.outDir;
-      puFileName+="/";
-      pumlOutDir=puFileName;
-      puFileName+="inline_umlgraph_";
-      puFileName+=pumlType;
-      puFileName+=kv.first.c_str();
-      puFileName+=".pu";
-
-      pumlArguments+="\"";
-      pumlArguments+=puFileName;
-      pumlArguments+="\" ";
-
-      std::ofstream file(puFileName.str(),std::ofstream::out | std::ofstream::binary);
-      if (!file.is_open())
+      if (hasMultiplePages(content))
+      {
+        m_multiPageDiagrams.push_back(std::make_pair(baseName.str(),content.str()));
+        return;
+      }
+      if (!m_pipe && !m_failed) start();
+      if (!m_pipe) return;
       {
-        err("Could not open file %s for writing\n",puFileName.data());
+        SigPipeBlocker blocker;
+        fwrite(content.data(),1,content.length(),m_pipe);
+        fflush(m_pipe);
       }
-      file.write( nb.content.data(), nb.content.length() );
-      file.close();
-      Debug::print(Debug::Plantuml,0,"*** %s Running Plantuml arguments:%s\n","PlantumlManager::runPlantumlContent",qPrint(pumlArguments));
+      if (m_source.is_open()) m_source << content;
+      m_images.push_back(baseName.str());
+    }
 
+    /** Waits for PlantUML to exit and writes the image files */
+    void finish()
+    {
+      finishMultiPageDiagrams();
+      if (!m_pipe) return;
+      QCString pumlType = plantumlType(m_format);
+      msg("Generating %zu PlantUML %s files\n",m_images.size(),qPrint(pumlType));
       Portable::sysTimerStart();
-      if ((exitCode=Portable::system(pumlExe,pumlArguments,TRUE))!=0)
+      int exitCode;
+      {
+        SigPipeBlocker blocker;
+        exitCode = Portable::pclose(m_pipe);
+      }
+      Portable::sysTimerStop();
+#if !defined(_WIN32) || defined(__CYGWIN__)
+      if (exitCode!=-1 && WIFEXITED(exitCode)) exitCode = WEXITSTATUS(exitCode);
+#endif
+      m_pipe = 0;
+      if (m_source.is_open()) m_source.close();
+      if (exitCode!=0)
       {
         err("Problems running PlantUML. Verify that the command 'java -jar \"%splantuml.jar\" -h' works from the command line. Exit code: %d\n",
-            plantumlJarPath.data(),exitCode);
+            Config_getString(PLANTUML_JAR_PATH).data(),exitCode);
+      }
+
+      std::ifstream f(m_outputFileName.str(),std::ifstream::in | std::ifstream::binary);
+      std::stringstream ss;
+      ss << f.rdbuf();
+      f.close();
+      std::string output = ss.str();
+      const size_t delimLen = qstrlen(g_pipeDelimiter);
+      size_t pos = 0;
+      for (const auto &image : m_images)
+      {
+        size_t end = output.find(g_pipeDelimiter,pos);
+        if (end==std::string::npos)
+        {
+          err("PlantUML did not generate the image %s.%s\n",image.c_str(),qPrint(pumlType));
+          break;
+        }
+        std::string imgName = image+"."+pumlType.str();
+        std::ofstream img(imgName,std::ofstream::out | std::ofstream::binary);
+        if (!img.is_open())
+        {
+          err("Could not open file %s for writing\n",imgName.c_str());
+        }
+        img.write(output.data()+pos,static_cast<std::streamsize>(end-pos));
+        img.close();
+        // skip over the delimiter and the line break that follows it
+        pos = end+delimLen;
+        if (pos<output.length() && output[pos]=='\r') pos++;
+        if (pos<output.length() && output[pos]=='\n') pos++;
+
+        if (m_format==PUML_EPS && Config_getBool(USE_PDFLATEX))
+        {
+          runEpstopdf(image);
+        }
       }
-      else if (Config_getBool(DOT_CLEANUP))
+      if (Config_getBool(DOT_CLEANUP))
       {
-        Debug::print(Debug::Plantuml,0,"*** %s Remove %s file\n","PlantumlManager::runPlantumlContent",qPrint(puFileName));
-        Dir().remove(puFileName.str());
+        Dir().remove(m_outputFileName.str());
       }
-      Portable::sysTimerStop();
+      m_images.clear();
+    }
 
-      if ( (format==PlantumlManager::PUML_EPS) && (Config_getBool(USE_PDFLATEX)) )
+  private:
+    // renders the diagrams with more than one page in file mode, one process per diagram.
+    // PlantUML names the images after the @startuml line, followed by _001, _002, etc.
+    // for the pages after the first.
+    void finishMultiPageDiagrams()
+    {
+      QCString pumlType = plantumlType(m_format);
+      for (const auto &diagram : m_multiPageDiagrams)
       {
-        Debug::print(Debug::Plantuml,0,"*** %s Running epstopdf\n","PlantumlManager::runPlantumlContent");
-        auto files_kv = plantumlFiles.find(kv.first);
-        if (files_kv!=plantumlFiles.end())
+        const std::string &image = diagram.first;
+        QCString puFileName = image+".pu";
         {
-          for (const auto &str : files_kv->second)
+          std::ofstream file(puFileName.str(),std::ofstream::out | std::ofstream::binary);
+          if (!file.is_open())
           {
-            const int maxCmdLine = 40960;
-            QCString epstopdfArgs(maxCmdLine);
-            epstopdfArgs.sprintf("\"%s%s.eps\" --outfile=\"%s%s.pdf\"",
-                pumlOutDir.data(),str.c_str(), pumlOutDir.data(),str.c_str());
-            Portable::sysTimerStart();
-            if ((exitCode=Portable::system("epstopdf",epstopdfArgs))!=0)
-            {
-              err("Problems running epstopdf. Check your TeX installation! Exit code: %d\n",exitCode);
-            }
-            Portable::sysTimerStop();
+            err("Could not open file %s for writing\n",qPrint(puFileName));
+            continue;
           }
+          file << diagram.second;
+        }
+        QCString args = plantumlArguments()+"-charset UTF-8 -t"+pumlType+" \""+puFileName+"\"";
+        msg("Generating PlantUML %s file %s\n",qPrint(pumlType),image.c_str());
+        Debug::print(Debug::Plantuml,0,"*** %s Running Plantuml arguments:%s\n","PlantumlManager::Process::finishMultiPageDiagrams",qPrint(args));
+        Portable::sysTimerStart();
+        int exitCode = Portable::system("java",args,TRUE);
+        Portable::sysTimerStop();
+        if (exitCode!=0)
+        {
+          err("Problems running PlantUML. Verify that the command 'java -jar \"%splantuml.jar\" -h' works from the command line. Exit code: %d\n",
+              Config_getString(PLANTUML_JAR_PATH).data(),exitCode);
+          continue;
+        }
+        if (Config_getBool(DOT_CLEANUP))
+        {
+          Dir().remove(puFileName.str());
+        }
+        if (m_format==PUML_EPS && Config_getBool(USE_PDFLATEX))
+        {
+          runEpstopdf(image);
         }
       }
+      m_multiPageDiagrams.clear();
     }
-  }
-}
 
-void PlantumlManager::run()
-{
-  Debug::print(Debug::Plantuml,0,"*** %s\n","PlantumlManager::run");
-  if (m_currentPlantumlAllContent.isEmpty()) return;
-  runPlantumlContent(m_pngPlantumlFiles, m_pngPlantumlContent, PUML_BITMAP);
-  runPlantumlContent(m_svgPlantumlFiles, m_svgPlantumlContent, PUML_SVG);
-  runPlantumlContent(m_epsPlantumlFiles, m_epsPlantumlContent, PUML_EPS);
-  QCString outputFilename = Config_getString(OUTPUT_DIRECTORY) + "/" + CACHE_FILENAME;
-  std::ofstream file(outputFilename.str(),std::ofstream::out | std::ofstream::binary);
-  if (!file.is_open())
-  {
-    err("Could not open file %s for writing\n",CACHE_FILENAME);
-  }
-  file.write( m_currentPlantumlAllContent.data(), m_currentPlantumlAllContent.length() );
-  file.close();
-}
-
-static void print(const PlantumlManager::FilesMap &plantumlFiles)
-{
-  if (Debug::isFlagSet(Debug::Plantuml))
-  {
-    for (const auto &kv : plantumlFiles)
+    void start()
     {
-      Debug::print(Debug::Plantuml,0,"*** %s PlantumlFiles key:%s size:%zu\n","PlantumlManager::print Files",kv.first.c_str(),kv.second.size());
-      for (const auto &s : kv.second)
+      /* example : running: java -Djava.awt.headless=true
+                   -jar "/usr/local/bin/plantuml.jar"
+                   -pipe -pipedelimitor "___doxygen_plantuml_image_end___"
+                   -charset UTF-8 -tpng
+                   > "test_doxygen/DOXYGEN_OUTPUT/inline_umlgraph_png.out"
+       */
+      QCString pumlType = plantumlType(m_format);
+      QCString outDir = Config_getString(OUTPUT_DIRECTORY);
+      m_outputFileName = outDir+"/inline_umlgraph_"+pumlType+".out";
+      QCString cmd = "java "+plantumlArguments();
+      cmd += "-pipe -pipedelimitor \"";
+      cmd += g_pipeDelimiter;
+      cmd += "\" -charset UTF-8 -t";
+      cmd += pumlType;
+      cmd += " > \"";
+      cmd += m_outputFileName;
+      cmd += "\"";
+      Debug::print(Debug::Plantuml,0,"*** %s Running Plantuml: %s\n","PlantumlManager::Process::start",qPrint(cmd));
+      Debug::print(Debug::ExtCmd,0,"Executing popen(`%s`)\n",qPrint(cmd));
+      m_pipe = Portable::popen(cmd,"w");
+      if (!m_pipe)
+      {
+        err("Problems running PlantUML. Verify that the command 'java -jar \"%splantuml.jar\" -h' works from the command line.\n",
+            Config_getString(PLANTUML_JAR_PATH).data());
+        m_failed = true;
+        return;
+      }
+      if (!Config_getBool(DOT_CLEANUP)) // keep the diagrams that were rendered, for debugging
       {
-        Debug::print(Debug::Plantuml,0,"*** %s             list:%s\n","PlantumlManager::print",s.c_str());
+        QCString puFileName = outDir+"/inline_umlgraph_"+pumlType+".pu";
+        m_source.open(puFileName.str(),std::ofstream::out | std::ofstream::binary);
       }
     }
-  }
-}
 
-static void print(const PlantumlManager::ContentMap &plantumlContent)
+    OutputFormat m_format;
+    FILE *m_pipe = 0;
+    bool m_failed = false;
+    QCString m_outputFileName;
+    std::ofstream m_source;
+    StringVector m_images;         // image file names without extension, in the order of the diagrams
+    std::vector< std::pair<std::string,std::string> > m_multiPageDiagrams; // image file name and source
+};
+
+PlantumlManager::~PlantumlManager()
 {
-  if (Debug::isFlagSet(Debug::Plantuml))
-  {
-    for (const auto &kv : plantumlContent)
-    {
-      Debug::print(Debug::Plantuml,0,"*** %s PlantumlContent key:%s\n","PlantumlManager::print Content",kv.first.c_str());
-      Debug::print(Debug::Plantuml,0,"*** %s                 Content :%s\n","PlantumlManager::print",kv.second.content.data());
-    }
-  }
 }
 
-static void addPlantumlFiles(PlantumlManager::FilesMap &plantumlFiles,
-                             const std::string &key, const std::string &value)
+void PlantumlManager::run()
 {
-  auto kv = plantumlFiles.find(key);
-  if (kv==plantumlFiles.end())
+  Debug::print(Debug::Plantuml,0,"*** %s\n","PlantumlManager::run");
+  if (m_currentDiagrams.empty()) return;
+
+  for (auto &process : m_processes)
   {
-    kv = plantumlFiles.insert(std::make_pair(key,StringVector())).first;
+    if (process) process->finish();
   }
-  kv->second.push_back(value);
-}
 
-static void addPlantumlContent(PlantumlManager::ContentMap &plantumlContent,
-                               const std::string &key, const QCString &outDir, const QCString &puContent)
-{
-  auto kv = plantumlContent.find(key);
-  if (kv==plantumlContent.end())
+  QCString outputFilename = Config_getString(OUTPUT_DIRECTORY) + "/" + CACHE_FILENAME;
+  std::ofstream file(outputFilename.str(),std::ofstream::out | std::ofstream::binary);
+  if (!file.is_open())
+  {
+    err("Could not open file %s for writing\n",CACHE_FILENAME);
+  }
+  for (const auto &hash : m_currentDiagrams)
   {
-    kv = plantumlContent.insert(std::make_pair(key,PlantumlContent("",outDir))).first;
+    file << hash << "\n";
   }
-  kv->second.content+=puContent;
+  file.close();
 }
 
-void PlantumlManager::insert(const std::string &key, const std::string &value,
-                             const QCString &outDir,OutputFormat format,const QCString &puContent)
+void PlantumlManager::insert(const QCString &baseName,OutputFormat format,const QCString &puContent)
 {
-  int find;
-
-  Debug::print(Debug::Plantuml,0,"*** %s key:%s ,value:%s\n","PlantumlManager::insert",qPrint(key),qPrint(value));
-
-  m_currentPlantumlAllContent+=puContent;
-
-  find = m_cachedPlantumlAllContent.find(puContent);
-  Debug::print(Debug::Plantuml,0,"*** %s find: %d\n","PlantumlManager::addPlantumlContent",find);
-  if (find >=0)
-  {         // matched in cache. so we skip to run java for this plantuml
+  Debug::print(Debug::Plantuml,0,"*** %s baseName:%s\n","PlantumlManager::insert",qPrint(baseName));
+
+  // a diagram is identified by the hash of its source, which includes the
+  // image name, and of the image format.
+  std::string hashInput = puContent.str()+plantumlType(format);
+  uchar md5_sig[16];
+  char sigStr[33];
+  MD5Buffer((const unsigned char*)hashInput.data(),static_cast<unsigned int>(hashInput.length()),md5_sig);
+  MD5SigToString(md5_sig,sigStr,33);
+  m_currentDiagrams.push_back(sigStr);
+
+  std::string imgBase = baseName.str()+".";
+  bool cached = m_cachedDiagrams.find(sigStr)!=m_cachedDiagrams.end() &&
+                FileInfo(imgBase+plantumlType(format)).exists() &&
+                (format!=PUML_EPS || !Config_getBool(USE_PDFLATEX) || FileInfo(imgBase+"pdf").exists());
+  Debug::print(Debug::Plantuml,0,"*** %s cached: %d\n","PlantumlManager::insert",cached);
+  if (cached)
+  {         // rendered in a previous run, so we skip to run java for this plantuml
       return ;
   }
 
-  switch (format)
+  if (!m_processes[format])
   {
-    case PUML_BITMAP:
-      addPlantumlFiles(m_pngPlantumlFiles,key,value);
-      print(m_pngPlantumlFiles);
-      addPlantumlContent(m_pngPlantumlContent,key,outDir,puContent);
-      print(m_pngPlantumlContent);
-      break;
-    case PUML_EPS:
-      addPlantumlFiles(m_epsPlantumlFiles,key,value);
-      print(m_epsPlantumlFiles);
-      addPlantumlContent(m_epsPlantumlContent,key,outDir,puContent);
-      print(m_epsPlantumlContent);
-      break;
-    case PUML_SVG:
-      addPlantumlFiles(m_svgPlantumlFiles,key,value);
-      print(m_svgPlantumlFiles);
-      addPlantumlContent(m_svgPlantumlContent,key,outDir,puContent);
-      print(m_svgPlantumlContent);
-      break;
+    m_processes[format] = std::make_unique<Process>(format);
   }
+  m_processes[format]->add(baseName,puContent);
 }
 
 //--------------------------------------------------------------------
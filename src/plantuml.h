@@ -16,28 +16,13 @@
 #ifndef PLANTUML_H
 #define PLANTUML_H
 
-#include <map>
+#include <memory>
 #include <string>
 
 #include "containers.h"
 #include "qcstring.h"
 
 #define CACHE_FILENAME          "inline_umlgraph_cache_all.pu"
-#define DIVIDE_COUNT            4
-#define MIN_PLANTUML_COUNT      8
-
-class QCString;
-struct PlantumlContent
-{
-  QCString outDir;
-  QCString content;
-  PlantumlContent(const QCString Content, const QCString OutDir)
-  {
-    outDir = OutDir;
-    content = Content;
-  };
-  ~PlantumlContent(){};
-};
 
 /** Singleton that manages plantuml relation actions */
 class PlantumlManager
@@ -48,12 +33,15 @@ class PlantumlManager
 
     static PlantumlManager &instance();
 
-    /** Run plant UML tool for all images */
+    /** Wait for the plant UML processes to render all images */
     void run();
 
     /** Write a PlantUML compatible file.
      *  @param[in] outDir   the output directory to write the file to.
-     *  @param[in] fileName the name of the file. If empty a name will be chosen automatically.
+     *  @param[in] fileName the name of the file. If empty a name will be chosen automatically,
+     *                      numbered in the order of the calls. The doc visitors pass a name
+     *                      made by OutputGenerator::inlineImageName() instead, which does not
+     *                      depend on the order in which threads write the pages.
      *  @param[in] content  the contents of the PlantUML file.
      *  @param[in] format   the image format to generate.
      *  @returns The name of the generated file.
@@ -67,24 +55,15 @@ class PlantumlManager
      */
     void generatePlantUMLOutput(const char *baseName,const char *outDir,OutputFormat format);
 
-    using FilesMap   = std::map< std::string, StringVector    >;
-    using ContentMap = std::map< std::string, PlantumlContent >;
   private:
     PlantumlManager();
-    void insert(const std::string &key,
-                const std::string &value,
-                const QCString &outDir,
-                OutputFormat format,
-                const QCString &puContent);
+   ~PlantumlManager();
+    void insert(const QCString &baseName,OutputFormat format,const QCString &puContent);
 
-    FilesMap   m_pngPlantumlFiles;
-    FilesMap   m_svgPlantumlFiles;
-    FilesMap   m_epsPlantumlFiles;
-    ContentMap m_pngPlantumlContent;               // use circular queue for using multi-processor (multi threading)
-    ContentMap m_svgPlantumlContent;
-    ContentMap m_epsPlantumlContent;
-    QCString   m_cachedPlantumlAllContent;         // read from CACHE_FILENAME file
-    QCString   m_currentPlantumlAllContent;        // processing plantuml then write it into CACHE_FILENAME to reuse the next time as cache information
+    class Process;
+    std::unique_ptr<Process> m_processes[PUML_SVG+1]; // PlantUML in pipe mode, one per image format
+    StringUnorderedSet m_cachedDiagrams;           // hashes of the diagrams of the previous run, read from CACHE_FILENAME
+    StringVector       m_currentDiagrams;          // hashes of the diagrams of this run, written to CACHE_FILENAME
 };
 
 #endif
@@ -9,14 +9,25 @@
 #undef UNICODE
 #define _WIN32_DCOM
 #include <windows.h>
+#include <psapi.h>
+#ifdef _MSC_VER
+#pragma comment(lib,"psapi.lib")
+#endif
 #else
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
 #include <errno.h>
 extern char **environ;
 #endif
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#endif
 
+#include <algorithm>
 #include <assert.h>
 #include <ctype.h>
 #include <map>
@@ -26,6 +37,7 @@ extern char **environ;
 
 #include "util.h"
 #include "dir.h"
+#include "trace.h"
 #ifndef NODEBUG
 #include "debug.h"
 #endif
@@ -61,6 +73,11 @@ int Portable::system(const char *command,const char *args,bool commandHasConsole
 #ifndef NODEBUG
   Debug::print(Debug::ExtCmd,0,"Executing external command `%s`\n",qPrint(fullCmd));
 #endif
+  // name the span after the command without its path and quotes
+  QCString traceName = QCString(command).stripWhiteSpace();
+  int sep = std::max(traceName.findRev('/'),traceName.findRev('\\'));
+  if (sep!=-1) traceName = traceName.mid(sep+1);
+  TraceSpan traceSpan("exec",substitute(traceName,"\"",""),args);
 
 #if !defined(_WIN32) || defined(__CYGWIN__)
   (void)commandHasConsole;
@@ -215,6 +232,38 @@ unsigned int Portable::pid()
   return pid;
 }
 
+uint64_t Portable::residentMemory()
+{
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  PROCESS_MEMORY_COUNTERS pmc;
+  if (GetProcessMemoryInfo(GetCurrentProcess(),&pmc,sizeof(pmc)))
+  {
+    return pmc.WorkingSetSize;
+  }
+#elif defined(__APPLE__)
+  mach_task_basic_info_data_t info;
+  mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+  if (task_info(mach_task_self(),MACH_TASK_BASIC_INFO,(task_info_t)&info,&count)==KERN_SUCCESS)
+  {
+    return info.resident_size;
+  }
+#else
+  // the second field of statm is the number of resident pages
+  FILE *f = fopen("/proc/self/statm","r");
+  if (f)
+  {
+    unsigned long size=0,resident=0;
+    int n = fscanf(f,"%lu %lu",&size,&resident);
+    fclose(f);
+    if (n==2)
+    {
+      return static_cast<uint64_t>(resident)*static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    }
+  }
+#endif
+  return 0;
+}
+
 #if !defined(_WIN32) || defined(__CYGWIN__)
 void loadEnvironment()
 {
@@ -616,4 +665,64 @@ size_t Portable::recodeUtf8StringToW(const char *inputStr,uint16_t **outBuf)
   return len;
 }
 
+/** Maps the contents of file \a fileName into memory for reading.
+ *  Returns a pointer to the data and sets \a size to its length, or
+ *  returns 0 if the file could not be mapped (e.g. because it is empty).
+ *  The mapping must be released with unmapFile().
+ */
+const char *Portable::mapFile(const char *fileName,size_t &size)
+{
+  size=0;
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  uint16_t *fn = 0;
+  size_t fn_len = recodeUtf8StringToW(fileName,&fn);
+  if (fn_len==(size_t)-1) { delete[] fn; return 0; }
+  HANDLE file = CreateFileW((wchar_t*)fn,GENERIC_READ,FILE_SHARE_READ,NULL,
+                            OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,NULL);
+  delete[] fn;
+  if (file==INVALID_HANDLE_VALUE) return 0;
+  LARGE_INTEGER fileSize;
+  const char *data = 0;
+  if (GetFileSizeEx(file,&fileSize) && fileSize.QuadPart>0)
+  {
+    HANDLE mapping = CreateFileMapping(file,NULL,PAGE_READONLY,0,0,NULL);
+    if (mapping)
+    {
+      data = (const char *)MapViewOfFile(mapping,FILE_MAP_READ,0,0,0);
+      if (data) size = (size_t)fileSize.QuadPart;
+      CloseHandle(mapping); // the view keeps the mapping alive
+    }
+  }
+  CloseHandle(file);
+  return data;
+#else
+  int fd = ::open(fileName,O_RDONLY);
+  if (fd==-1) return 0;
+  struct stat st;
+  const char *data = 0;
+  if (fstat(fd,&st)==0 && st.st_size>0)
+  {
+    void *addr = mmap(0,(size_t)st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+    if (addr!=MAP_FAILED)
+    {
+#if defined(MADV_SEQUENTIAL)
+      madvise(addr,(size_t)st.st_size,MADV_SEQUENTIAL);
+#endif
+      data = (const char *)addr;
+      size = (size_t)st.st_size;
+    }
+  }
+  ::close(fd); // the mapping stays valid after closing the file
+  return data;
+#endif
+}
 
+void Portable::unmapFile(const char *data,size_t size)
+{
+  if (data==0) return;
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  UnmapViewOfFile(data);
+#else
+  munmap((void*)data,size);
+#endif
+}
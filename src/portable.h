@@ -21,6 +21,7 @@ namespace Portable
 {
   int            system(const char *command,const char *args,bool commandHasConsole=true);
   unsigned int   pid();
+  uint64_t       residentMemory();
   const char *   getenv(const char *variable);
   void           setenv(const char *variable,const char *value);
   void           unsetenv(const char *variable);
@@ -46,6 +47,8 @@ namespace Portable
   const char *   devNull();
   bool           checkForExecutable(const char *fileName);
   size_t         recodeUtf8StringToW(const char *inputStr,uint16_t **buf);
+  const char *   mapFile(const char *fileName,size_t &size);
+  void           unmapFile(const char *data,size_t size);
 }
 
 
@@ -20,7 +20,12 @@
 
 #include <memory>
 
+#include "containers.h"
+#include "define.h"
+
 class BufStr;
+class FileDef;
+class IncludeInfoList;
 
 class Preprocessor
 {
@@ -29,6 +34,29 @@ class Preprocessor
    ~Preprocessor();
     void processFile(const char *fileName,BufStr &input,BufStr &output);
     void addSearchDir(const char *dir);
+
+    /** Returns the absolute names of the files that were read, or whose
+     *  macros were reused, while processing the last file.
+     */
+    const StringSet &dependencies() const;
+
+    /** Returns the paths at which an include file was looked for, but where
+     *  no file existed, while processing the last file.
+     */
+    const StringSet &missingIncludes() const;
+
+    /** Returns the macro definitions found in the last processed file. */
+    const DefineList &macroDefinitions() const;
+
+    /** Registers the include relations and macro definitions of file
+     *  \a fileName without processing it. Used to restore the results of
+     *  an earlier processFile() call, e.g. from the parse cache.
+     */
+    static void restoreFileResults(const char *fileName,FileDef *fd,
+                                   const IncludeInfoList &includes,const DefineList &defines);
+
+    /** Reports the use of the include file cache shared by all instances */
+    static void printStatistics();
  private:
    struct Private;
    std::unique_ptr<Private> p;
@@ -16,6 +16,7 @@
 #include "regex.h"
 #include <cstdint>
 #include <vector>
+#include <bitset>
 #include <cctype>
 #include <cassert>
 #include <algorithm>
@@ -27,6 +28,12 @@
 #define DBG(fmt,...) do {} while(0)
 #endif
 
+// Set to 1 to match without the start and required characters found by analyse(),
+// as was done before. Used by testing/bench/regexbench to compare both.
+#ifndef REGEX_NO_PREFILTER
+#define REGEX_NO_PREFILTER 0
+#endif
+
 namespace reg
 {
 
@@ -175,10 +182,14 @@ class Ex::Private
       data.reserve(100);
     }
     void compile();
+    void analyse();
 #if ENABLE_DEBUG
     void dump();
 #endif
+    bool matchCharClass(size_t tp,char c) const;
     bool matchAt(size_t tokenPos,const std::string &str,Match &match,size_t pos,int level) const;
+    size_t nextCandidate(const std::string &str,size_t pos) const;
+    bool hasRequiredChars(const std::string &str,size_t pos) const;
 
     /** Flag indicating the expression was successfully compiled */
     bool error = false;
@@ -188,8 +199,56 @@ class Ex::Private
 
     /** The pattern string as passed by the user */
     std::string pattern;
+
+    /** The characters at which a match can start. Only valid if numFirstChars>0 */
+    std::bitset<256> firstChars;
+
+    /** The number of characters in firstChars, 0 if a match can start with any character */
+    size_t numFirstChars = 0;
+
+    /** The start character if numFirstChars==1 */
+    char firstChar = 0;
+
+    /** Characters that are part of every match */
+    std::string requiredChars;
 };
 
+static inline bool isStartIdChar(char c) { return isalpha(c) || c=='_'; }
+static inline bool isIdChar(char c)      { return isalnum(c) || c=='_'; }
+
+bool Ex::Private::matchCharClass(size_t tp,char c) const
+{
+  PToken tok = data[tp];
+  bool negate = tok.kind()==PToken::Kind::NegCharClass;
+  uint16_t numFields = tok.value();
+  bool found = false;
+  for (uint16_t i=0;i<numFields;i++)
+  {
+    tok = data[++tp];
+    // first check for built-in ranges
+    if ((tok.kind()==PToken::Kind::Alpha      && isStartIdChar(c)) ||
+        (tok.kind()==PToken::Kind::AlphaNum   && isIdChar(c))      ||
+        (tok.kind()==PToken::Kind::WhiteSpace && isspace(c))  ||
+        (tok.kind()==PToken::Kind::Digit      && isdigit(c))
+       )
+    {
+      found=true;
+      break;
+    }
+    else // user specified range
+    {
+      uint16_t v = static_cast<uint16_t>(c);
+      if (tok.from()<=v && v<=tok.to())
+      {
+        found=true;
+        break;
+      }
+    }
+  }
+  DBG("matchCharClass(tp=%zu,c=%c (x%02x))=%d\n",tp,c,c,negate?!found:found);
+  return negate ? !found : found;
+}
+
 /** Compiles a regular expression passed as a string into a stream of tokens that can be used for
  *  efficient searching.
  */
@@ -396,6 +455,120 @@ void Ex::Private::compile()
   //addToken(PToken(PToken::Kind::End));
 }
 
+/** Determines from the compiled token stream the characters at which a match can start,
+ *  and the characters that must be part of any match. These are used by Ex::match() to
+ *  skip over positions and strings for which matchAt() would fail anyway.
+ */
+void Ex::Private::analyse()
+{
+  firstChars.reset();
+  numFirstChars = 0;
+  firstChar = 0;
+  requiredChars.clear();
+  if (error || data.empty()) return;
+
+  // find the first token that consumes a character, zero width assertions and captures
+  // do not change the set of characters at which a match can start.
+  size_t i=0;
+  while (i<data.size() &&
+         (data[i].kind()==PToken::Kind::BeginCapture ||
+          data[i].kind()==PToken::Kind::EndCapture   ||
+          data[i].kind()==PToken::Kind::BeginOfWord  ||
+          data[i].kind()==PToken::Kind::EndOfWord)) i++;
+  if (i<data.size())
+  {
+    PToken tok = data[i];
+    switch (tok.kind())
+    {
+      case PToken::Kind::Character:
+        firstChars.set(static_cast<unsigned char>(tok.asciiValue()));
+        break;
+      case PToken::Kind::CharClass:
+      case PToken::Kind::NegCharClass:
+        for (int c=0;c<256;c++) if (matchCharClass(i,static_cast<char>(c))) firstChars.set(c);
+        break;
+      case PToken::Kind::Alpha:
+        for (int c=0;c<256;c++) if (isStartIdChar(static_cast<char>(c))) firstChars.set(c);
+        break;
+      case PToken::Kind::AlphaNum:
+        for (int c=0;c<256;c++) if (isIdChar(static_cast<char>(c))) firstChars.set(c);
+        break;
+      case PToken::Kind::WhiteSpace:
+        for (int c=0;c<256;c++) if (isspace(static_cast<char>(c))) firstChars.set(c);
+        break;
+      case PToken::Kind::Digit:
+        for (int c=0;c<256;c++) if (isdigit(static_cast<char>(c))) firstChars.set(c);
+        break;
+      default: // Any, Star, Optional, ...: a match can start with any character
+        break;
+    }
+    numFirstChars = firstChars.count();
+    if (numFirstChars==1) // take it from the set, tok may be a class like [_]
+    {
+      int c=0;
+      while (!firstChars[c]) c++;
+      firstChar = static_cast<char>(c);
+    }
+    else if (numFirstChars==256) // no restriction
+    {
+      firstChars.reset();
+      numFirstChars = 0;
+    }
+  }
+
+  // collect the literal characters outside of 'x*' and 'x?' sequences, each match contains them
+  i=0;
+  while (i<data.size())
+  {
+    PToken tok = data[i];
+    if (tok.kind()==PToken::Kind::Character)
+    {
+      char c = tok.asciiValue();
+      if ((numFirstChars!=1 || c!=firstChar) && requiredChars.find(c)==std::string::npos)
+      {
+        requiredChars+=c;
+      }
+      i++;
+    }
+    else if (tok.isCharClass())
+    {
+      i+=tok.value()+1; // skip over character ranges
+    }
+    else if (tok.kind()==PToken::Kind::Star || tok.kind()==PToken::Kind::Optional)
+    {
+      i++;
+      if (i<data.size() && data[i].isCharClass()) i+=data[i].value();
+      i+=2; // skip over the sequence and its end marker
+    }
+    else
+    {
+      i++;
+    }
+  }
+}
+
+/** Returns the first position at or after \a pos at which a match can start, or std::string::npos. */
+size_t Ex::Private::nextCandidate(const std::string &str,size_t pos) const
+{
+  if (numFirstChars==1)
+  {
+    return str.find(firstChar,pos);
+  }
+  size_t len = str.length();
+  while (pos<len && !firstChars[static_cast<unsigned char>(str[pos])]) pos++;
+  return pos<len ? pos : std::string::npos;
+}
+
+/** Returns true iff all characters required by the pattern appear at or after \a pos in \a str */
+bool Ex::Private::hasRequiredChars(const std::string &str,size_t pos) const
+{
+  for (char c : requiredChars)
+  {
+    if (str.find(c,pos)==std::string::npos) return false;
+  }
+  return true;
+}
+
 #if ENABLE_DEBUG
 /** Dump the compiled token stream for this regular expression. For debugging purposes. */
 void Ex::Private::dump()
@@ -438,44 +611,9 @@ void Ex::Private::dump()
 bool Ex::Private::matchAt(size_t tokenPos,const std::string &str,Match &match,const size_t pos,int level) const
 {
   DBG("%d:matchAt(tokenPos=%zu, str='%s', pos=%zu)\n",level,tokenPos,str.c_str(),pos);
-  auto isStartIdChar = [](char c) { return isalpha(c) || c=='_'; };
-  auto isIdChar      = [](char c) { return isalnum(c) || c=='_'; };
-  auto matchCharClass = [this,isStartIdChar,isIdChar](size_t tp,char c) -> bool
-  {
-    PToken tok = data[tp];
-    bool negate = tok.kind()==PToken::Kind::NegCharClass;
-    uint16_t numFields = tok.value();
-    bool found = false;
-    for (uint16_t i=0;i<numFields;i++)
-    {
-      tok = data[++tp];
-      // first check for built-in ranges
-      if ((tok.kind()==PToken::Kind::Alpha      && isStartIdChar(c)) ||
-          (tok.kind()==PToken::Kind::AlphaNum   && isIdChar(c))      ||
-          (tok.kind()==PToken::Kind::WhiteSpace && isspace(c))  ||
-          (tok.kind()==PToken::Kind::Digit      && isdigit(c))
-         )
-      {
-        found=true;
-        break;
-      }
-      else // user specified range
-      {
-        uint16_t v = static_cast<uint16_t>(c);
-        if (tok.from()<=v && v<=tok.to())
-        {
-          found=true;
-          break;
-        }
-      }
-    }
-    DBG("matchCharClass(tp=%zu,c=%c (x%02x))=%d\n",tp,c,c,negate?!found:found);
-    return negate ? !found : found;
-  };
   size_t index = pos;
   enum SequenceType { Star, Optional };
-  auto processSequence = [this,&tokenPos,&index,&str,&matchCharClass,
-                          &isStartIdChar,&isIdChar,&match,&level,&pos](SequenceType type) -> bool
+  auto processSequence = [this,&tokenPos,&index,&str,&match,&level,&pos](SequenceType type) -> bool
   {
     size_t startIndex = index;
     PToken tok = data[++tokenPos];
@@ -663,6 +801,9 @@ Ex::Ex(const std::string &pattern, Mode mode)
   : p(std::make_unique<Private>(mode==Mode::RegEx ? pattern : wildcard2regex(pattern)))
 {
   p->compile();
+#if !REGEX_NO_PREFILTER
+  p->analyse();
+#endif
 #if ENABLE_DEBUG
   p->dump();
   assert(!p->error);
@@ -679,6 +820,13 @@ bool Ex::match(const std::string &str,Match &match,size_t pos) const
   if (p->data.size()==0 || p->error) return found;
   match.init(&str);
 
+  if (!p->hasRequiredChars(str,pos))
+  {
+    DBG("Ex::match(str='%s',pos=%zu)=false (required chars '%s' not found)\n",
+        str.c_str(),pos,p->requiredChars.c_str());
+    return false;
+  }
+
   PToken tok = p->data[0];
   if (tok.kind()==PToken::Kind::BeginOfLine) // only test match at the given position
   {
@@ -686,19 +834,17 @@ bool Ex::match(const std::string &str,Match &match,size_t pos) const
   }
   else
   {
-    if (tok.kind()==PToken::Kind::Character) // search for the start character
+    while (pos<str.length()) // search for a match starting at pos
     {
-      size_t index = str.find(tok.asciiValue(),pos);
-      if (index==std::string::npos)
+      if (p->numFirstChars>0) // skip to the next possible start character
       {
-        DBG("Ex::match(str='%s',pos=%zu)=false (no start char '%c')\n",str.c_str(),pos,tok.asciiValue());
-        return false;
+        pos = p->nextCandidate(str,pos);
+        if (pos==std::string::npos)
+        {
+          DBG("Ex::match(str='%s')=false (no start char)\n",str.c_str());
+          return false;
+        }
       }
-      DBG("pos=%zu str='%s' char='%c' index=%zu\n",index,str.c_str(),tok.asciiValue(),index);
-      pos=index;
-    }
-    while (pos<str.length()) // search for a match starting at pos
-    {
       found = p->matchAt(0,str,match,pos,0);
       if (found) break;
       pos++;
@@ -708,6 +854,20 @@ bool Ex::match(const std::string &str,Match &match,size_t pos) const
   return found;
 }
 
+bool Ex::matchAnchored(const std::string &str,Match &match) const
+{
+  // only a match starting at position 0 can cover the whole string
+  if (p->data.size()==0 || p->error) return false;
+#if REGEX_NO_PREFILTER
+  return this->match(str,match,0) && match.position()==0 && match.length()==str.length();
+#else
+  if (str.empty() && p->data[0].kind()!=PToken::Kind::BeginOfLine) return false;
+  if (!p->hasRequiredChars(str,0)) return false;
+  match.init(&str);
+  return p->matchAt(0,str,match,0,0) && match.position()==0 && match.length()==str.length();
+#endif
+}
+
 bool Ex::isValid() const
 {
   return !p->pattern.empty() && !p->error;
@@ -728,13 +888,13 @@ bool search(const std::string &str,const Ex &re,size_t pos)
 
 bool match(const std::string &str,Match &match,const Ex &re)
 {
-  return re.match(str,match,0) && match.position()==0 && match.length()==str.length();
+  return re.matchAnchored(str,match);
 }
 
 bool match(const std::string &str,const Ex &re)
 {
   Match match;
-  return re.match(str,match,0) && match.position()==0 && match.length()==str.length();
+  return re.matchAnchored(str,match);
 }
 
 std::string replace(const std::string &str,const Ex &re,const std::string &replacement)
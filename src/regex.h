@@ -108,6 +108,11 @@ class Ex
     Ex(const Ex &) = delete;
     Ex &operator=(const Ex &e) = delete;
 
+    /** Checks if the whole string \a str matches, only trying a match at the start */
+    bool matchAnchored(const std::string &str,Match &match) const;
+    friend bool match(const std::string &str,Match &match,const Ex &re);
+    friend bool match(const std::string &str,const Ex &re);
+
     class Private;
     std::unique_ptr<Private> p;
 };
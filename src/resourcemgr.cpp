@@ -22,6 +22,7 @@
 #include "version.h"
 #include "message.h"
 #include "config.h"
+#include "outputgen.h"
 
 class ResourceMgr::Private
 {
@@ -59,7 +60,7 @@ bool ResourceMgr::writeCategory(const char *categoryName,const char *targetDir)
     if (qstrcmp(res.category,categoryName)==0)
     {
       std::string pathName = std::string(targetDir)+"/"+res.name;
-      std::ofstream f(pathName,std::ofstream::out | std::ofstream::binary);
+      OutputFileStream f(pathName);
       bool ok=false;
       if (f.is_open())
       {
@@ -86,7 +87,7 @@ bool ResourceMgr::copyResourceAs(const char *name,const char *targetDir,const ch
     {
       case Resource::Verbatim:
         {
-          std::ofstream f(pathName,std::ofstream::out | std::ofstream::binary);
+          OutputFileStream f(pathName);
           bool ok=false;
           if (f.is_open())
           {
@@ -137,7 +138,7 @@ bool ResourceMgr::copyResourceAs(const char *name,const char *targetDir,const ch
         break;
       case Resource::CSS:
         {
-          std::ofstream t(pathName,std::ofstream::out | std::ofstream::binary);
+          OutputFileStream t(pathName);
           if (t.is_open())
           {
             QCString buf(res->size+1);
@@ -157,7 +158,7 @@ bool ResourceMgr::copyResourceAs(const char *name,const char *targetDir,const ch
         break;
       case Resource::SVG:
         {
-          std::ofstream t(pathName,std::ostream::out | std::ofstream::binary);
+          OutputFileStream t(pathName);
           if (t.is_open())
           {
             QCString buf(res->size+1);
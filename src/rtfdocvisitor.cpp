@@ -325,14 +325,8 @@ void RTFDocVisitor::visit(DocVerbatim *s)
       break;
     case DocVerbatim::Dot:
       {
-        static int dotindex = 1;
-        QCString fileName(4096);
-
-        fileName.sprintf("%s%d%s",
-            (Config_getString(RTF_OUTPUT)+"/inline_dotgraph_").data(),
-            dotindex++,
-            ".dot"
-           );
+        QCString fileName = Config_getString(RTF_OUTPUT)+"/"+
+                            OutputGenerator::inlineImageName(OutputGenerator::RTF,"inline_dotgraph_")+".dot";
         std::ofstream file(fileName.str(),std::ofstream::out | std::ofstream::binary);
         if (!file.is_open())
         {
@@ -354,14 +348,8 @@ void RTFDocVisitor::visit(DocVerbatim *s)
       break;
     case DocVerbatim::Msc:
       {
-        static int mscindex = 1;
-        QCString baseName(4096);
-
-        baseName.sprintf("%s%d%s",
-            (Config_getString(RTF_OUTPUT)+"/inline_mscgraph_").data(),
-            mscindex++,
-            ".msc"
-           );
+        QCString baseName = Config_getString(RTF_OUTPUT)+"/"+
+                            OutputGenerator::inlineImageName(OutputGenerator::RTF,"inline_mscgraph_")+".msc";
         std::ofstream file(baseName.str(),std::ofstream::out | std::ofstream::binary);
         if (!file.is_open())
         {
@@ -383,7 +371,9 @@ void RTFDocVisitor::visit(DocVerbatim *s)
     case DocVerbatim::PlantUML:
       {
         static QCString rtfOutput = Config_getString(RTF_OUTPUT);
-        QCString baseName = PlantumlManager::instance().writePlantUMLSource(rtfOutput,s->exampleFile(),s->text(),PlantumlManager::PUML_BITMAP);
+        QCString baseName = PlantumlManager::instance().writePlantUMLSource(rtfOutput,
+            s->exampleFile().isEmpty() ? OutputGenerator::inlineImageName(OutputGenerator::RTF,"inline_umlgraph_") : s->exampleFile(),
+            s->text(),PlantumlManager::PUML_BITMAP);
 
         writePlantUMLFile(baseName, s->hasCaption());
         visitCaption(this, s->children());
@@ -17,6 +17,11 @@
 #include <ctype.h>
 #include <assert.h>
 #include <sstream>
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <thread>
+#include <unordered_map>
 
 #include "searchindex.h"
 #include "config.h"
@@ -38,6 +43,10 @@
 #include "utf8.h"
 #include "classlist.h"
 #include "urlstring.h"
+#include "threadpool.h"
+#include "textstream.h"
+#include "debug.h"
+#include "outputgen.h"
 
 //---------------------------------------------------------------------------------------------
 // the following part is for the server based search engine
@@ -58,29 +67,139 @@ const size_t numIndexEntries = 256*256;
 
 //--------------------------------------------------------------------
 
-IndexWord::IndexWord(QCString word) : m_word(word)
+struct URL
 {
-  //printf("IndexWord::IndexWord(%s)\n",word);
-}
+  URL(QCString n,QCString u) : name(n), url(u) {}
+  QCString name;
+  QCString url;
+};
+
+struct URLInfo
+{
+  URLInfo(int idx,int f) : urlIdx(idx), freq(f) {}
+  int urlIdx;
+  int freq;
+};
 
-void IndexWord::addUrlIndex(int idx,bool hiPriority)
+static void encodeVarInt(std::string &buf,uint32_t v)
 {
-  //printf("IndexWord::addUrlIndex(%d,%d)\n",idx,hiPriority);
-  auto it = m_urls.find(idx);
-  if (it==m_urls.end())
+  while (v>=0x80)
   {
-    //printf("URLInfo::URLInfo(%d)\n",idx);
-    it = m_urls.insert(std::make_pair(idx,URLInfo(idx,0))).first;
+    buf+=static_cast<char>((v&0x7f)|0x80);
+    v>>=7;
   }
-  it->second.freq+=2;
-  if (hiPriority) it->second.freq|=1; // mark as high priority document
+  buf+=static_cast<char>(v);
 }
 
-//--------------------------------------------------------------------
+static uint32_t decodeVarInt(const char *&p)
+{
+  uint32_t v=0;
+  int shift=0;
+  uchar c;
+  do
+  {
+    c = static_cast<uchar>(*p++);
+    v |= static_cast<uint32_t>(c&0x7f)<<shift;
+    shift+=7;
+  } while (c&0x80);
+  return v;
+}
+
+/** The documents containing a word, as collected by a single thread.
+ *
+ *  Each (url index, frequency) pair is stored as two variable length
+ *  integers, where the url index is stored as the (zigzag encoded)
+ *  difference with the previous one. Words are typically added for the same
+ *  document in a row, so the pair for the current document is only encoded
+ *  when another document is seen.
+ */
+class PostingList
+{
+  public:
+    void add(int urlIdx,bool hiPriority)
+    {
+      if (urlIdx!=m_curUrl)
+      {
+        flush();
+        m_curUrl  = urlIdx;
+        m_curFreq = 0;
+      }
+      m_curFreq+=2;
+      if (hiPriority) m_curFreq|=1; // mark as high priority document
+    }
+    /** Calls \a func(urlIdx,freq) for each document in the list */
+    template<class Func>
+    void forEach(Func func) const
+    {
+      const char *p   = m_data.data();
+      const char *end = p+m_data.size();
+      int urlIdx = 0;
+      while (p<end)
+      {
+        uint32_t zz = decodeVarInt(p);
+        urlIdx += static_cast<int>(zz>>1) ^ -static_cast<int>(zz&1);
+        int freq = static_cast<int>(decodeVarInt(p));
+        func(urlIdx,freq);
+      }
+      if (m_curUrl!=-1) func(m_curUrl,m_curFreq);
+    }
+  private:
+    void flush()
+    {
+      if (m_curUrl==-1) return;
+      int delta = m_curUrl-m_lastUrl;
+      encodeVarInt(m_data,(static_cast<uint32_t>(delta)<<1) ^ static_cast<uint32_t>(delta>>31));
+      encodeVarInt(m_data,static_cast<uint32_t>(m_curFreq));
+      m_lastUrl = m_curUrl;
+    }
+    std::string m_data;
+    int m_lastUrl = 0;
+    int m_curUrl  = -1;
+    int m_curFreq = 0;
+};
+
+/** Words added to the search index by a single thread */
+using IndexBuilder = std::unordered_map<std::string,PostingList>;
+
+struct SearchIndex::Private
+{
+  /** Returns the builder of the calling thread */
+  IndexBuilder &builder()
+  {
+    // the builder is cached per thread, the id protects against a
+    // new index being allocated at the address of a deleted one
+    static thread_local std::pair<int,IndexBuilder*> current(-1,nullptr);
+    if (current.first!=id)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      builders.push_back(std::make_unique<IndexBuilder>());
+      current = std::make_pair(id,builders.back().get());
+    }
+    return *current.second;
+  }
+  void addWord(IndexBuilder &b,const char *word,bool hiPrio,bool recurse);
+
+  static std::atomic<int> nextId;
+  const int id = nextId++;
+  std::vector< std::unique_ptr<IndexBuilder> > builders;
+  std::unordered_map<std::string,int> url2IdMap;
+  std::map<int,URL> urls;
+  int urlIndex = -1;
+  std::mutex mutex;
+};
+
+std::atomic<int> SearchIndex::Private::nextId { 0 };
+
+// The current document is tracked per thread, so source files can be
+// indexed while they are generated in parallel.
+static thread_local int g_currentUrlIndex = -1;
 
-SearchIndex::SearchIndex() : SearchIndexIntf(Internal)
+SearchIndex::SearchIndex() : SearchIndexIntf(Internal), p(std::make_unique<Private>())
+{
+}
+
+SearchIndex::~SearchIndex()
 {
-  m_index.resize(numIndexEntries);
 }
 
 void SearchIndex::setCurrentDoc(const Definition *ctx,const char *anchor,bool isSourceFile)
@@ -164,16 +283,22 @@ void SearchIndex::setCurrentDoc(const Definition *ctx,const char *anchor,bool is
     }
   }
 
-  auto it = m_url2IdMap.find(baseUrl().str());
-  if (it == m_url2IdMap.end())
+  std::lock_guard<std::mutex> lock(p->mutex);
+  auto it = p->url2IdMap.find(baseUrl().str());
+  if (it == p->url2IdMap.end())
   {
-    ++m_urlIndex;
-    m_url2IdMap.insert(std::make_pair(baseUrl(),m_urlIndex));
-    m_urls.insert(std::make_pair(m_urlIndex,URL(name,url())));
+    ++p->urlIndex;
+    p->url2IdMap.insert(std::make_pair(baseUrl(),p->urlIndex));
+    p->urls.insert(std::make_pair(p->urlIndex,URL(name,url())));
+    g_currentUrlIndex = p->urlIndex;
   }
   else
   {
-    m_urls.insert(std::make_pair(it->second,URL(name,url())));
+    // a source file is indexed with several anchors, keep the first one
+    // independent of the order in which threads get here
+    URL &u = p->urls.at(it->second);
+    if (qstrcmp(url(),u.url)<0) u = URL(name,url());
+    g_currentUrlIndex = it->second;
   }
 }
 
@@ -199,21 +324,14 @@ static int charsToIndex(const char *word)
   return c1*256+c2;
 }
 
-void SearchIndex::addWord(const char *word,bool hiPriority,bool recurse)
+void SearchIndex::Private::addWord(IndexBuilder &b,const char *word,bool hiPriority,bool recurse)
 {
   if (word==0 || word[0]=='\0') return;
   QCString wStr = QCString(word).lower();
   //printf("SearchIndex::addWord(%s,%d) wStr=%s\n",word,hiPriority,wStr.data());
   int idx=charsToIndex(wStr);
-  if (idx<0 || idx>=static_cast<int>(m_index.size())) return;
-  auto it = m_words.find(wStr.str());
-  if (it==m_words.end())
-  {
-    //fprintf(stderr,"addWord(%s) at index %d\n",word,idx);
-    m_index[idx].push_back(IndexWord(wStr));
-    it = m_words.insert({ wStr.str(), static_cast<int>(m_index[idx].size())-1 }).first;
-  }
-  m_index[idx][it->second].addUrlIndex(m_urlIndex,hiPriority);
+  if (idx<0 || idx>=static_cast<int>(numIndexEntries)) return;
+  b[wStr.str()].add(g_currentUrlIndex,hiPriority);
   int i;
   bool found=FALSE;
   if (!recurse) // the first time we check if we can strip the prefix
@@ -221,7 +339,7 @@ void SearchIndex::addWord(const char *word,bool hiPriority,bool recurse)
     i=getPrefixIndex(word);
     if (i>0)
     {
-      addWord(word+i,hiPriority,TRUE);
+      addWord(b,word+i,hiPriority,TRUE);
       found=TRUE;
     }
   }
@@ -236,14 +354,15 @@ void SearchIndex::addWord(const char *word,bool hiPriority,bool recurse)
     }
     if (word[i]!=0 && i>=1)
     {
-      addWord(word+i+1,hiPriority,TRUE);
+      addWord(b,word+i+1,hiPriority,TRUE);
     }
   }
 }
 
 void SearchIndex::addWord(const char *word,bool hiPriority)
 {
-  addWord(word,hiPriority,FALSE);
+  if (g_currentUrlIndex<0) return; // no current document
+  p->addWord(p->builder(),word,hiPriority,FALSE);
 }
 
 static void writeInt(std::ostream &f,size_t index)
@@ -261,80 +380,128 @@ static void writeString(std::ostream &f,const char *s)
   f.put(0);
 }
 
-void SearchIndex::write(const char *fileName)
+/** A word in the index together with its posting list in one of the builders */
+struct TermRef
 {
-  size_t i;
-  size_t size=4; // for the header
-  size+=4*numIndexEntries; // for the index
-  size_t wordsOffset = size;
-  // first pass: compute the size of the wordlist
-  for (i=0;i<numIndexEntries;i++)
+  const std::string *word;
+  const PostingList *postings;
+};
+
+/** Merges the posting lists of \a count entries in \a refs (all for the
+ *  same word) into \a urls, with the url indices mapped by \a urlOrder
+ *  and sorted on them.
+ */
+static void mergePostings(const TermRef *refs,size_t count,const std::vector<int> &urlOrder,
+                          std::vector<URLInfo> &urls)
+{
+  urls.clear();
+  for (size_t i=0;i<count;i++)
+  {
+    refs[i].postings->forEach([&urls,&urlOrder](int urlIdx,int freq) { urls.emplace_back(urlOrder[urlIdx],freq); });
+  }
+  std::sort(urls.begin(),urls.end(),[](const URLInfo &u1,const URLInfo &u2) { return u1.urlIdx<u2.urlIdx; });
+  // combine entries for the same document
+  size_t n=0;
+  for (size_t i=0;i<urls.size();i++)
   {
-    const auto &wlist = m_index[i];
-    if (!wlist.empty())
+    if (n>0 && urls[n-1].urlIdx==urls[i].urlIdx)
     {
-      for (const auto &iw : wlist)
-      {
-        int ws = iw.word().length()+1;
-        size+=ws+4; // word + url info list offset
-      }
-      size+=1; // zero list terminator
+      int f1 = urls[n-1].freq, f2 = urls[i].freq;
+      urls[n-1].freq = ((f1&~1)+(f2&~1)) | ((f1|f2)&1);
+    }
+    else
+    {
+      urls[n++] = urls[i];
     }
   }
+  urls.resize(n,URLInfo(0,0));
+}
 
-  // second pass: compute the offsets in the index
-  size_t indexOffsets[numIndexEntries];
-  size_t offset=wordsOffset;
-  for (i=0;i<numIndexEntries;i++)
+void SearchIndex::write(const char *fileName)
+{
+  // the url indices are handed out in the order in which threads index the
+  // documents, so number them again in the order of the urls.
+  std::vector<std::pair<std::string,int>> sortedUrls(p->url2IdMap.begin(),p->url2IdMap.end());
+  std::sort(sortedUrls.begin(),sortedUrls.end());
+  std::vector<int> urlOrder(sortedUrls.size());
+  for (size_t i=0;i<sortedUrls.size();i++)
   {
-    const auto &wlist = m_index[i];
-    if (!wlist.empty())
+    urlOrder[sortedUrls[i].second] = static_cast<int>(i);
+  }
+
+  // collect the words of all builders, sorting them puts the words of
+  // the same index entry (first two characters) next to each other.
+  std::vector<TermRef> refs;
+  for (const auto &b : p->builders)
+  {
+    for (const auto &kv : *b)
     {
-      indexOffsets[i]=offset;
-      for (const auto &iw : wlist)
-      {
-        offset+= iw.word().length()+1;
-        offset+=4; // word + offset to url info array
-      }
-      offset+=1; // zero list terminator
+      refs.push_back({&kv.first,&kv.second});
     }
-    else
+  }
+  std::sort(refs.begin(),refs.end(),[](const TermRef &t1,const TermRef &t2) { return *t1.word<*t2.word; });
+
+  // group the references per word and determine the number of documents of each word
+  struct Word
+  {
+    size_t first;   // index of the first reference in refs
+    size_t count;   // number of references for this word
+    size_t numUrls; // number of documents containing the word
+  };
+  std::vector<Word> words;
+  std::vector<URLInfo> urls;
+  for (size_t i=0;i<refs.size();)
+  {
+    size_t j=i+1;
+    while (j<refs.size() && *refs[j].word==*refs[i].word) j++;
+    mergePostings(&refs[i],j-i,urlOrder,urls);
+    words.push_back({i,j-i,urls.size()});
+    i=j;
+  }
+  auto wordIndex = [&refs](const Word &w) { return charsToIndex(refs[w.first].word->c_str()); };
+
+  size_t i;
+  size_t size=4; // for the header
+  size+=4*numIndexEntries; // for the index
+
+  // compute the size of the word lists and the offsets in the index
+  std::vector<size_t> indexOffsets(numIndexEntries,0);
+  int lastIdx=-1;
+  for (const auto &w : words)
+  {
+    int idx = wordIndex(w);
+    if (idx!=lastIdx)
     {
-      indexOffsets[i]=0;
+      if (lastIdx!=-1) size+=1; // zero list terminator
+      indexOffsets[idx]=size;
+      lastIdx=idx;
     }
+    size+=refs[w.first].word->length()+1+4; // word + url info list offset
   }
+  if (lastIdx!=-1) size+=1; // zero list terminator
+
   size_t padding = size;
   size = (size+3)&~3; // round up to 4 byte boundary
   padding = size - padding;
 
-  std::vector<size_t> wordStatOffsets(m_words.size());
-
-  int count=0;
-
-  // third pass: compute offset to stats info for each word
-  for (i=0;i<numIndexEntries;i++)
+  // compute offset to stats info for each word
+  std::vector<size_t> wordStatOffsets(words.size());
+  for (i=0;i<words.size();i++)
   {
-    const auto &wlist = m_index[i];
-    if (!wlist.empty())
-    {
-      for (const auto &iw : wlist)
-      {
-        //printf("wordStatOffsets[%d]=%d\n",count,size);
-        wordStatOffsets[count++] = size;
-        size+=4 + iw.urls().size() * 8; // count + (url_index,freq) per url
-      }
-    }
+    wordStatOffsets[i] = size;
+    size+=4 + words[i].numUrls * 8; // count + (url_index,freq) per url
   }
-  std::vector<size_t> urlOffsets(m_urls.size());
-  for (const auto &udi : m_urls)
+  std::vector<size_t> urlOffsets(sortedUrls.size());
+  for (i=0;i<sortedUrls.size();i++)
   {
-    urlOffsets[udi.first]=size;
-    size+=udi.second.name.length()+1+
-          udi.second.url.length()+1;
+    const URL &url = p->urls.at(sortedUrls[i].second);
+    urlOffsets[i]=size;
+    size+=url.name.length()+1+
+          url.url.length()+1;
   }
 
   //printf("Total size %x bytes (word=%x stats=%x urls=%x)\n",size,wordsOffset,statsOffset,urlsOffset);
-  std::ofstream f(fileName,std::ofstream::out | std::ofstream::binary);
+  OutputFileStream f(fileName);
   if (f.is_open())
   {
     // write header
@@ -345,45 +512,38 @@ void SearchIndex::write(const char *fileName)
       writeInt(f,indexOffsets[i]);
     }
     // write word lists
-    count=0;
-    for (i=0;i<numIndexEntries;i++)
+    lastIdx=-1;
+    for (i=0;i<words.size();i++)
     {
-      const auto &wlist = m_index[i];
-      if (!wlist.empty())
+      int idx = wordIndex(words[i]);
+      if (idx!=lastIdx)
       {
-        for (const auto &iw : wlist)
-        {
-          writeString(f,iw.word());
-          writeInt(f,wordStatOffsets[count++]);
-        }
-        f.put(0);
+        if (lastIdx!=-1) f.put(0);
+        lastIdx=idx;
       }
+      writeString(f,refs[words[i].first].word->c_str());
+      writeInt(f,wordStatOffsets[i]);
     }
+    if (lastIdx!=-1) f.put(0);
     // write extra padding bytes
     for (i=0;i<padding;i++) f.put(0);
     // write word statistics
-    for (i=0;i<numIndexEntries;i++)
+    for (const auto &w : words)
     {
-      const auto &wlist = m_index[i];
-      if (!wlist.empty())
+      mergePostings(&refs[w.first],w.count,urlOrder,urls);
+      writeInt(f,urls.size());
+      for (const auto &ui : urls)
       {
-        for (const auto &iw : wlist)
-        {
-          size_t numUrls = iw.urls().size();
-          writeInt(f,numUrls);
-          for (const auto &ui : iw.urls())
-          {
-            writeInt(f,urlOffsets[ui.second.urlIdx]);
-            writeInt(f,ui.second.freq);
-          }
-        }
+        writeInt(f,urlOffsets[ui.urlIdx]);
+        writeInt(f,ui.freq);
       }
     }
     // write urls
-    for (const auto &udi : m_urls)
+    for (const auto &su : sortedUrls)
     {
-      writeString(f,udi.second.name);
-      writeString(f,udi.second.url);
+      const URL &url = p->urls.at(su.second);
+      writeString(f,url.name);
+      writeString(f,url.url);
     }
   }
 
@@ -407,9 +567,11 @@ struct SearchDocEntry
 struct SearchIndexExternal::Private
 {
   std::map<std::string,SearchDocEntry> docEntries;
-  SearchDocEntry *current = 0;
+  std::mutex mutex;
 };
 
+static thread_local SearchDocEntry *g_currentDocEntry = 0;
+
 SearchIndexExternal::SearchIndexExternal() : SearchIndexIntf(External), p(std::make_unique<Private>())
 {
 }
@@ -479,6 +641,7 @@ void SearchIndexExternal::setCurrentDoc(const Definition *ctx,const char *anchor
   if (anchor) url+=QCString("#")+anchor;
   QCString key = extId+";"+url;
 
+  std::lock_guard<std::mutex> lock(p->mutex);
   auto it = p->docEntries.find(key.str());
   if (it == p->docEntries.end())
   {
@@ -494,13 +657,14 @@ void SearchIndexExternal::setCurrentDoc(const Definition *ctx,const char *anchor
     it = p->docEntries.insert({key.str(),e}).first;
     //printf("searchIndexExt %s : %s\n",e->name.data(),e->url.data());
   }
-  p->current = &it->second;
+  g_currentDocEntry = &it->second;
 }
 
 void SearchIndexExternal::addWord(const char *word,bool hiPriority)
 {
-  if (word==0 || !isId(*word) || p->current==0) return;
-  GrowBuf *pText = hiPriority ? &p->current->importantText : &p->current->normalText;
+  if (word==0 || !isId(*word) || g_currentDocEntry==0) return;
+  std::lock_guard<std::mutex> lock(p->mutex);
+  GrowBuf *pText = hiPriority ? &g_currentDocEntry->importantText : &g_currentDocEntry->normalText;
   if (pText->getPos()>0) pText->addChar(' ');
   pText->addStr(word);
   //printf("addWord %s\n",word);
@@ -508,7 +672,7 @@ void SearchIndexExternal::addWord(const char *word,bool hiPriority)
 
 void SearchIndexExternal::write(const char *fileName)
 {
-  std::ofstream t(fileName,std::ofstream::out | std::ofstream::binary);
+  OutputFileStream t(fileName);
   if (t.is_open())
   {
     t << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
@@ -905,12 +1069,199 @@ void createJavaScriptSearchIndex()
   }
 }
 
-void writeJavaScriptSearchIndex()
+//---------------------------------------------------------------------------------------------
+
+/** @brief A name in the client side search index together with the places where
+ *  something with this name is documented.
+ */
+struct SearchTerm
 {
-  int cnt = 0;
-  // write index files
-  QCString searchDirName = Config_getString(HTML_OUTPUT)+"/search";
+  struct Link
+  {
+    QCString file;     // URL of the page
+    QCString anchor;   // anchor within the page, may be empty
+    bool     inParent; // TRUE if the link opens in the parent of the results frame
+    QCString scope;    // text shown to tell the links of the term apart
+  };
+  QCString id;         // search name in lower case, with non-identifier characters escaped
+  QCString name;       // search name as shown
+  std::vector<Link> links;
+};
+
+/** Adds the terms for the sorted list of definitions \a list to \a terms */
+static void addSearchTerms(const SearchIndexList &list,std::vector<SearchTerm> &terms)
+{
+  static bool extLinksInWindow = Config_getBool(EXT_LINKS_IN_WINDOW);
+  QCString lastName;
+  const Definition *prevScope = 0;
+  for (auto it = list.begin(); it!=list.end();)
+  {
+    const Definition *d = *it;
+    QCString sname = searchName(d);
+
+    if (sname!=lastName) // this item has a different search word
+    {
+      SearchTerm term;
+      term.id   = searchId(d);
+      term.name = convertToXML(sname);
+      terms.push_back(term);
+      prevScope=0;
+    }
+
+    ++it;
+    const Definition *scope     = d->getOuterScope();
+    const Definition *next      = it!=list.end() ? *it : 0;
+    const Definition *nextScope = 0;
+    const MemberDef  *md        = toMemberDef(d);
+    if (next) nextScope = next->getOuterScope();
 
+    SearchTerm::Link link;
+    link.file     = externalRef("../",d->getReference(),TRUE)+addHtmlExtensionIfMissing(d->getOutputFileBase());
+    link.anchor   = d->anchor();
+    link.inParent = !extLinksInWindow || d->getReference().isEmpty();
+
+    if (lastName!=sname && (next==0 || searchName(next)!=sname)) // unique name
+    {
+      if (d->getOuterScope()!=Doxygen::globalScope)
+      {
+        link.scope = convertToXML(d->getOuterScope()->name());
+      }
+      else if (md)
+      {
+        const FileDef *fd = md->getBodyDef();
+        if (fd==0) fd = md->getFileDef();
+        if (fd)
+        {
+          link.scope = convertToXML(fd->localName());
+        }
+      }
+    }
+    else // multiple entries with the same name
+    {
+      bool found=FALSE;
+      bool overloadedFunction = ((prevScope!=0 && scope==prevScope) ||
+          (scope && scope==nextScope)) && md && (md->isFunction() || md->isSlot());
+      QCString prefix;
+      if (md) prefix=convertToXML(md->localName());
+      if (overloadedFunction) // overloaded member function
+      {
+        prefix+=convertToXML(md->argsString());
+        // show argument list to disambiguate overloaded functions
+      }
+      else if (md) // unique member function
+      {
+        prefix+="()"; // only to show it is a function
+      }
+      QCString name;
+      if (d->definitionType()==Definition::TypeClass)
+      {
+        name = convertToXML((toClassDef(d))->displayName());
+        found = TRUE;
+      }
+      else if (d->definitionType()==Definition::TypeNamespace)
+      {
+        name = convertToXML((toNamespaceDef(d))->displayName());
+        found = TRUE;
+      }
+      else if (scope==0 || scope==Doxygen::globalScope) // in global scope
+      {
+        if (md)
+        {
+          const FileDef *fd = md->getBodyDef();
+          if (fd==0) fd = md->resolveAlias()->getFileDef();
+          if (fd)
+          {
+            if (!prefix.isEmpty()) prefix+=":&#160;";
+            name = prefix + convertToXML(fd->localName());
+            found = TRUE;
+          }
+        }
+      }
+      else if (md && (md->resolveAlias()->getClassDef() || md->resolveAlias()->getNamespaceDef()))
+        // member in class or namespace scope
+      {
+        SrcLangExt lang = md->getLanguage();
+        name = convertToXML(d->getOuterScope()->qualifiedName())
+          + getLanguageSpecificSeparator(lang) + prefix;
+        found = TRUE;
+      }
+      else if (scope) // some thing else? -> show scope
+      {
+        name = prefix + convertToXML(scope->name());
+        found = TRUE;
+      }
+      if (!found) // fallback
+      {
+        name = prefix + "("+theTranslator->trGlobalNamespace()+")";
+      }
+
+      link.scope = name;
+      prevScope = scope;
+    }
+    terms.back().links.push_back(link);
+    lastName = sname;
+  }
+}
+
+/** Writes the page shown in the search results frame. The page loads \a dataFile, if given,
+ *  runs \a createCode to fill the results and then \a searchCode to show the matching ones.
+ */
+static void writeResultsPage(const QCString &fileName,const QCString &dataFile,
+                             const QCString &createCode,const QCString &searchCode)
+{
+  OutputFileStream t(fileName.str());
+  if (!t.is_open())
+  {
+    err("Failed to open file '%s' for writing...\n",fileName.data());
+    return;
+  }
+  t << "<!DOCTYPE html PUBLIC \"-//W3C//DTD XHTML 1.0 Transitional//EN\""
+    " \"https://www.w3.org/TR/xhtml1/DTD/xhtml1-transitional.dtd\">\n";
+  t << "<html xmlns=\"http://www.w3.org/1999/xhtml\">\n";
+  t << "<head><title></title>\n";
+  t << "<meta http-equiv=\"Content-Type\" content=\"text/xhtml;charset=UTF-8\"/>\n";
+  t << "<meta name=\"generator\" content=\"Doxygen " << getDoxygenVersion() << "\"/>\n";
+  t << "<link rel=\"stylesheet\" type=\"text/css\" href=\"search.css\"/>\n";
+  if (!dataFile.isEmpty())
+  {
+    t << "<script type=\"text/javascript\" src=\"" << dataFile << "\"></script>\n";
+  }
+  t << "<script type=\"text/javascript\" src=\"search.js\"></script>\n";
+  t << "</head>\n";
+  t << "<body class=\"SRPage\">\n";
+  t << "<div id=\"SRIndex\">\n";
+  t << "<div class=\"SRStatus\" id=\"Loading\">" << theTranslator->trLoading() << "</div>\n";
+  t << "<div id=\"SRResults\"></div>\n"; // here the results will be inserted
+  t << "<script type=\"text/javascript\">\n";
+  t << "/* @license magnet:?xt=urn:btih:cf05388f2679ee054f2beb29a391d25f4e673ac3&amp;dn=gpl-2.0.txt GPL-v2 */\n";
+  t << createCode; // this code will insert the results
+  t << "/* @license-end */\n";
+  t << "</script>\n";
+  t << "<div class=\"SRStatus\" id=\"Searching\">"
+    << theTranslator->trSearching() << "</div>\n";
+  t << "<div class=\"SRStatus\" id=\"NoMatches\">"
+    << theTranslator->trNoMatches() << "</div>\n";
+
+  t << "<script type=\"text/javascript\">\n";
+  t << "/* @license magnet:?xt=urn:btih:cf05388f2679ee054f2beb29a391d25f4e673ac3&amp;dn=gpl-2.0.txt GPL-v2 */\n";
+  t << searchCode;
+  t << "window.addEventListener(\"message\", function(event) {\n";
+  t << "  if (event.data == \"take_focus\") {\n";
+  t << "    var elem = searchResults.NavNext(0);\n";
+  t << "    if (elem) elem.focus();\n";
+  t << "  }\n";
+  t << "});\n";
+  t << "/* @license-end */\n";
+  t << "</script>\n";
+  t << "</div>\n"; // SRIndex
+  t << "</body>\n";
+  t << "</html>\n";
+}
+
+/** Writes one results page and data file per index and first letter */
+static void writeLetterSearchIndex(const QCString &searchDirName)
+{
+  int cnt = 0;
   for (auto &sii : g_searchIndexInfo)
   {
     int p=0;
@@ -922,54 +1273,16 @@ void writeJavaScriptSearchIndex()
       QCString fileName = searchDirName + "/"+baseName+Doxygen::htmlFileExtension;
       QCString dataFileName = searchDirName + "/"+baseName+".js";
 
-      std::ofstream t(fileName.str(), std::ofstream::out | std::ofstream::binary);
-      std::ofstream ti(dataFileName.str(), std::ofstream::out | std::ofstream::binary);
-      if (t.is_open() && ti.is_open())
-      {
-        {
-          t << "<!DOCTYPE html PUBLIC \"-//W3C//DTD XHTML 1.0 Transitional//EN\""
-            " \"https://www.w3.org/TR/xhtml1/DTD/xhtml1-transitional.dtd\">\n";
-          t << "<html xmlns=\"http://www.w3.org/1999/xhtml\">\n";
-          t << "<head><title></title>\n";
-          t << "<meta http-equiv=\"Content-Type\" content=\"text/xhtml;charset=UTF-8\"/>\n";
-          t << "<meta name=\"generator\" content=\"Doxygen " << getDoxygenVersion() << "\"/>\n";
-          t << "<link rel=\"stylesheet\" type=\"text/css\" href=\"search.css\"/>\n";
-          t << "<script type=\"text/javascript\" src=\"" << baseName << ".js\"></script>\n";
-          t << "<script type=\"text/javascript\" src=\"search.js\"></script>\n";
-          t << "</head>\n";
-          t << "<body class=\"SRPage\">\n";
-          t << "<div id=\"SRIndex\">\n";
-          t << "<div class=\"SRStatus\" id=\"Loading\">" << theTranslator->trLoading() << "</div>\n";
-          t << "<div id=\"SRResults\"></div>\n"; // here the results will be inserted
-          t << "<script type=\"text/javascript\">\n";
-          t << "/* @license magnet:?xt=urn:btih:cf05388f2679ee054f2beb29a391d25f4e673ac3&amp;dn=gpl-2.0.txt GPL-v2 */\n";
-          t << "createResults();\n"; // this function will insert the results
-          t << "/* @license-end */\n";
-          t << "</script>\n";
-          t << "<div class=\"SRStatus\" id=\"Searching\">"
-            << theTranslator->trSearching() << "</div>\n";
-          t << "<div class=\"SRStatus\" id=\"NoMatches\">"
-            << theTranslator->trNoMatches() << "</div>\n";
-
-          t << "<script type=\"text/javascript\">\n";
-          t << "/* @license magnet:?xt=urn:btih:cf05388f2679ee054f2beb29a391d25f4e673ac3&amp;dn=gpl-2.0.txt GPL-v2 */\n";
-          t << "document.getElementById(\"Loading\").style.display=\"none\";\n";
-          t << "document.getElementById(\"NoMatches\").style.display=\"none\";\n";
-          t << "var searchResults = new SearchResults(\"searchResults\");\n";
-          t << "searchResults.Search();\n";
-          t << "window.addEventListener(\"message\", function(event) {\n";
-          t << "  if (event.data == \"take_focus\") {\n";
-          t << "    var elem = searchResults.NavNext(0);\n";
-          t << "    if (elem) elem.focus();\n";
-          t << "  }\n";
-          t << "});\n";
-          t << "/* @license-end */\n";
-          t << "</script>\n";
-          t << "</div>\n"; // SRIndex
-          t << "</body>\n";
-          t << "</html>\n";
-        }
+      writeResultsPage(fileName,baseName+".js",
+                       "createResults();\n",
+                       "document.getElementById(\"Loading\").style.display=\"none\";\n"
+                       "document.getElementById(\"NoMatches\").style.display=\"none\";\n"
+                       "var searchResults = new SearchResults(\"searchResults\");\n"
+                       "searchResults.Search();\n");
 
+      OutputFileStream ti(dataFileName.str());
+      if (ti.is_open())
+      {
         ti << "var searchData=\n";
         // format
         // searchData[] = array of items
@@ -982,164 +1295,378 @@ void writeJavaScriptSearchIndex()
         // searchData[x][1][y+1][2] = scope
 
         ti << "[\n";
+        std::vector<SearchTerm> terms;
+        addSearchTerms(kv.second,terms);
         bool firstEntry=TRUE;
-
-        int childCount=0;
-        QCString lastName;
-        const Definition *prevScope = 0;
-        for (auto it = kv.second.begin(); it!=kv.second.end();)
+        for (const auto &term : terms)
         {
-          const Definition *d = *it;
-          QCString sname = searchName(d);
-          QCString id    = searchId(d);
-
-          if (sname!=lastName) // this item has a different search word
+          if (!firstEntry)
           {
-            if (!firstEntry)
-            {
-              ti << "]]]";
-              ti << ",\n";
-            }
-            firstEntry=FALSE;
-
-            ti << "  ['" << id << "_" << cnt++ << "',['" << convertToXML(sname) << "',[";
-            childCount=0;
-            prevScope=0;
-          }
-
-          ++it;
-          const Definition *scope     = d->getOuterScope();
-          const Definition *next      = it!=kv.second.end() ? *it : 0;
-          const Definition *nextScope = 0;
-          const MemberDef  *md        = toMemberDef(d);
-          if (next) nextScope = next->getOuterScope();
-          QCString anchor = d->anchor();
-
-          if (childCount>0)
-          {
-            ti << "],[";
-          }
-          ti << "'" << externalRef("../",d->getReference(),TRUE)
-            << addHtmlExtensionIfMissing(d->getOutputFileBase());
-          if (!anchor.isEmpty())
-          {
-            ti << "#" << anchor;
-          }
-          ti << "',";
-
-          static bool extLinksInWindow = Config_getBool(EXT_LINKS_IN_WINDOW);
-          if (!extLinksInWindow || d->getReference().isEmpty())
-          {
-            ti << "1,";
-          }
-          else
-          {
-            ti << "0,";
+            ti << ",\n";
           }
+          firstEntry=FALSE;
 
-          if (lastName!=sname && (next==0 || searchName(next)!=sname)) // unique name
-          {
-            if (d->getOuterScope()!=Doxygen::globalScope)
-            {
-              ti << "'" << convertToXML(d->getOuterScope()->name()) << "'";
-            }
-            else if (md)
-            {
-              const FileDef *fd = md->getBodyDef();
-              if (fd==0) fd = md->getFileDef();
-              if (fd)
-              {
-                ti << "'" << convertToXML(fd->localName()) << "'";
-              }
-            }
-            else
-            {
-              ti << "''";
-            }
-          }
-          else // multiple entries with the same name
+          ti << "  ['" << term.id << "_" << cnt++ << "',['" << term.name << "',[";
+          bool firstLink=TRUE;
+          for (const auto &link : term.links)
           {
-            bool found=FALSE;
-            bool overloadedFunction = ((prevScope!=0 && scope==prevScope) ||
-                (scope && scope==nextScope)) && md && (md->isFunction() || md->isSlot());
-            QCString prefix;
-            if (md) prefix=convertToXML(md->localName());
-            if (overloadedFunction) // overloaded member function
-            {
-              prefix+=convertToXML(md->argsString());
-              // show argument list to disambiguate overloaded functions
-            }
-            else if (md) // unique member function
-            {
-              prefix+="()"; // only to show it is a function
-            }
-            QCString name;
-            if (d->definitionType()==Definition::TypeClass)
-            {
-              name = convertToXML((toClassDef(d))->displayName());
-              found = TRUE;
-            }
-            else if (d->definitionType()==Definition::TypeNamespace)
-            {
-              name = convertToXML((toNamespaceDef(d))->displayName());
-              found = TRUE;
-            }
-            else if (scope==0 || scope==Doxygen::globalScope) // in global scope
-            {
-              if (md)
-              {
-                const FileDef *fd = md->getBodyDef();
-                if (fd==0) fd = md->resolveAlias()->getFileDef();
-                if (fd)
-                {
-                  if (!prefix.isEmpty()) prefix+=":&#160;";
-                  name = prefix + convertToXML(fd->localName());
-                  found = TRUE;
-                }
-              }
-            }
-            else if (md && (md->resolveAlias()->getClassDef() || md->resolveAlias()->getNamespaceDef()))
-              // member in class or namespace scope
-            {
-              SrcLangExt lang = md->getLanguage();
-              name = convertToXML(d->getOuterScope()->qualifiedName())
-                + getLanguageSpecificSeparator(lang) + prefix;
-              found = TRUE;
-            }
-            else if (scope) // some thing else? -> show scope
+            if (!firstLink)
             {
-              name = prefix + convertToXML(scope->name());
-              found = TRUE;
+              ti << "],[";
             }
-            if (!found) // fallback
+            firstLink=FALSE;
+            ti << "'" << link.file;
+            if (!link.anchor.isEmpty())
             {
-              name = prefix + "("+theTranslator->trGlobalNamespace()+")";
+              ti << "#" << link.anchor;
             }
-
-            ti << "'" << name << "'";
-
-            prevScope = scope;
-            childCount++;
+            ti << "'," << (link.inParent ? "1," : "0,");
+            ti << "'" << link.scope << "'";
           }
-          lastName = sname;
+          ti << "]]]";
         }
         if (!firstEntry)
         {
-          ti << "]]]\n";
+          ti << "\n";
         }
         ti << "];\n";
       }
       else
       {
-        err("Failed to open file '%s' for writing...\n",fileName.data());
+        err("Failed to open file '%s' for writing...\n",dataFileName.data());
       }
       p++;
     }
   }
+}
 
+//---------------------------------------------------------------------------------------------
+
+// shards with more terms or more bytes than this are split on a longer prefix
+static const size_t g_maxShardTerms = 500;
+static const size_t g_maxShardBytes = 64*1024;
+
+/** @brief Range of the sorted terms of an index that is stored in one file.
+ *  A term with too many links for one shard continues in the next shard.
+ */
+struct SearchShard
+{
+  std::string key;  // prefix shared by the ids of all terms in the shard
+  size_t first;     // index of the first term
+  size_t last;      // index after the last term
+  size_t firstLink; // index of the first link of the first term
+  size_t lastLink;  // index after the last link of the last term
+};
+
+// upper bounds of the bytes writeShard() uses for the shard, a term, one of its links,
+// and a file or scope, not counting escaped characters.
+static const size_t g_shardBytes = 32;
+
+static size_t termBytes(const SearchTerm &term)
+{
+  return term.id.length()+term.name.length()+8;
+}
+
+static size_t linkBytes(const SearchTerm::Link &link)
+{
+  return link.anchor.length()+19;
+}
+
+static size_t listedBytes(const QCString &s)
+{
+  return s.length()+4;
+}
+
+// the files and scopes are stored once per shard, but counted for each link here
+static size_t termBytesWithLinks(const SearchTerm &term)
+{
+  size_t bytes = termBytes(term);
+  for (const auto &link : term.links)
   {
-    std::ofstream t(searchDirName.str()+"/searchdata.js",
-                    std::ofstream::out | std::ofstream::binary);
+    bytes+=linkBytes(link)+listedBytes(link.file)+listedBytes(link.scope);
+  }
+  return bytes;
+}
+
+/** Divides the terms in the range [first,last), which all have the same id and so
+ *  cannot be split on a longer prefix, over shards with key \a key of at most
+ *  g_maxShardBytes, splitting the links of a term where needed.
+ */
+static void packShards(const std::vector<SearchTerm> &terms,size_t first,size_t last,
+                       const std::string &key,std::vector<SearchShard> &shards)
+{
+  SearchShard shard{key,first,first,0,0};
+  size_t bytes=g_shardBytes;
+  StringUnorderedSet files;
+  StringUnorderedSet scopes;
+  for (size_t i=first;i<last;i++)
+  {
+    bytes+=termBytes(terms[i]);
+    for (size_t l=0;l<terms[i].links.size();l++)
+    {
+      const SearchTerm::Link &link = terms[i].links[l];
+      bool newFile  = files.find(link.file.str())==files.end();
+      bool newScope = scopes.find(link.scope.str())==scopes.end();
+      size_t lb = linkBytes(link)+(newFile ? listedBytes(link.file) : 0)+(newScope ? listedBytes(link.scope) : 0);
+      if (bytes+lb>g_maxShardBytes && (i>shard.first || l>shard.firstLink)) // shard is full
+      {
+        if (l==0) // close the shard after the previous term
+        {
+          shard.last     = i;
+          shard.lastLink = terms[i-1].links.size();
+        }
+        else // close the shard in the middle of this term
+        {
+          shard.last     = i+1;
+          shard.lastLink = l;
+        }
+        shards.push_back(shard);
+        shard = SearchShard{key,i,i,l,0};
+        bytes = g_shardBytes+termBytes(terms[i]);
+        files.clear();
+        scopes.clear();
+        lb = linkBytes(link)+listedBytes(link.file)+listedBytes(link.scope);
+      }
+      files.insert(link.file.str());
+      scopes.insert(link.scope.str());
+      bytes+=lb;
+    }
+  }
+  shard.last     = last;
+  shard.lastLink = terms[last-1].links.size();
+  shards.push_back(shard);
+}
+
+// returns the first numChars characters of the UTF-8 string s
+static std::string utf8Prefix(const std::string &s,size_t numChars)
+{
+  size_t pos=0;
+  while (pos<s.length() && numChars>0)
+  {
+    pos+=getUTF8CharNumBytes(s[pos]);
+    numChars--;
+  }
+  return s.substr(0,pos);
+}
+
+/** Divides the terms in the range [first,last) over shards whose key is the first
+ *  \a prefixLen characters of the ids, recursing with a longer prefix for shards
+ *  with too many terms or bytes.
+ */
+static void splitShards(const std::vector<SearchTerm> &terms,size_t first,size_t last,
+                        size_t prefixLen,std::vector<SearchShard> &shards)
+{
+  size_t i=first;
+  while (i<last)
+  {
+    std::string key = utf8Prefix(terms[i].id.str(),prefixLen);
+    size_t bytes=g_shardBytes+termBytesWithLinks(terms[i]);
+    size_t j=i+1;
+    while (j<last && utf8Prefix(terms[j].id.str(),prefixLen)==key)
+    {
+      bytes+=termBytesWithLinks(terms[j]);
+      j++;
+    }
+    if (j-i<=g_maxShardTerms && bytes<=g_maxShardBytes)
+    {
+      shards.push_back({key,i,j,0,terms[j-1].links.size()});
+    }
+    else if (terms[i].id!=terms[j-1].id)
+    {
+      splitShards(terms,i,j,prefixLen+1,shards);
+    }
+    else if (bytes>g_maxShardBytes) // a single id with too many links
+    {
+      packShards(terms,i,j,key,shards);
+    }
+    else // many terms with the same id, but they fit in one shard
+    {
+      shards.push_back({key,i,j,0,terms[j-1].links.size()});
+    }
+    i=j;
+  }
+}
+
+static void writeJSString(std::ostream &t,const QCString &s)
+{
+  t << '"';
+  for (char c : s.str())
+  {
+    if (c=='"' || c=='\\') t << '\\';
+    t << c;
+  }
+  t << '"';
+}
+
+/** Writes the terms of \a shard to \a fileName. The files and scopes of the links
+ *  are stored once per shard and referred to by their index.
+ */
+static void writeShard(const QCString &fileName,const std::vector<SearchTerm> &terms,const SearchShard &shard)
+{
+  std::unordered_map<std::string,size_t> fileIndex;
+  std::unordered_map<std::string,size_t> scopeIndex;
+  StringVector files;
+  StringVector scopes;
+  auto add = [](std::unordered_map<std::string,size_t> &index,StringVector &list,const QCString &s)
+  {
+    auto result = index.insert(std::make_pair(s.str(),list.size()));
+    if (result.second) list.push_back(s.str());
+  };
+  // returns the range of the links of term i that are stored in this shard
+  auto linkRange = [&shard,&terms](size_t i)
+  {
+    return std::make_pair(i==shard.first  ? shard.firstLink : 0,
+                          i+1==shard.last ? shard.lastLink  : terms[i].links.size());
+  };
+  for (size_t i=shard.first;i<shard.last;i++)
+  {
+    auto range = linkRange(i);
+    for (size_t l=range.first;l<range.second;l++)
+    {
+      add(fileIndex,files,terms[i].links[l].file);
+      add(scopeIndex,scopes,terms[i].links[l].scope);
+    }
+  }
+
+  OutputFileStream t(fileName.str());
+  if (!t.is_open())
+  {
+    err("Failed to open file '%s' for writing...\n",fileName.data());
+    return;
+  }
+  // format
+  // searchShard(files,scopes,terms)
+  // files[] = urls of the pages
+  // scopes[] = texts shown to tell the links of a term apart
+  // terms[x][0] = id
+  // terms[x][1] = name as shown
+  // terms[x][2+4*y..5+4*y] = link y: index in files, anchor, 1 => target="_parent", index in scopes
+  // a term with too many links continues as the first term of the next shard
+  t << "searchShard(\n[";
+  for (size_t i=0;i<files.size();i++)
+  {
+    if (i>0) t << ",\n";
+    writeJSString(t,files[i]);
+  }
+  t << "],\n[";
+  for (size_t i=0;i<scopes.size();i++)
+  {
+    if (i>0) t << ",\n";
+    writeJSString(t,scopes[i]);
+  }
+  t << "],\n[";
+  for (size_t i=shard.first;i<shard.last;i++)
+  {
+    const SearchTerm &term = terms[i];
+    if (i>shard.first) t << ",\n";
+    t << "[";
+    writeJSString(t,term.id);
+    t << ",";
+    writeJSString(t,term.name);
+    auto range = linkRange(i);
+    for (size_t l=range.first;l<range.second;l++)
+    {
+      const SearchTerm::Link &link = term.links[l];
+      t << "," << fileIndex[link.file.str()] << ",";
+      writeJSString(t,link.anchor);
+      t << "," << (link.inParent ? 1 : 0) << "," << scopeIndex[link.scope.str()];
+    }
+    t << "]";
+  }
+  t << "]);\n";
+}
+
+/** Writes per index a results page and the terms sorted on their id, divided over
+ *  shards by prefix. The results page only loads the shards that can contain matches.
+ */
+static void writeShardedSearchIndex(const QCString &searchDirName)
+{
+  struct IndexShards
+  {
+    const SearchIndexInfo *info;
+    std::vector<SearchTerm> terms;
+    std::vector<SearchShard> shards;
+  };
+  std::vector<IndexShards> indices;
+
+  // the definitions compute some of their names on first use, so the terms
+  // are collected here, the rest is done in parallel.
+  for (const auto &sii : g_searchIndexInfo)
+  {
+    if (sii.symbolMap.empty()) continue;
+    indices.push_back(IndexShards{&sii,{},{}});
+    for (const auto &kv : sii.symbolMap)
+    {
+      addSearchTerms(kv.second,indices.back().terms);
+    }
+  }
+
+  std::size_t numThreads = static_cast<std::size_t>(Config_getInt(NUM_PROC_THREADS));
+  if (numThreads==0)
+  {
+    numThreads = std::thread::hardware_concurrency();
+  }
+  ThreadPool threadPool(std::max<std::size_t>(numThreads,1));
+  std::vector< std::future<void> > results;
+  for (auto &idx : indices)
+  {
+    results.emplace_back(threadPool.queue([&idx]()
+    {
+      std::stable_sort(idx.terms.begin(),idx.terms.end(),
+                       [](const SearchTerm &t1,const SearchTerm &t2) { return qstrcmp(t1.id,t2.id)<0; });
+      splitShards(idx.terms,0,idx.terms.size(),1,idx.shards);
+    }));
+  }
+  for (auto &f : results) f.get();
+  results.clear();
+
+  size_t numShards=0;
+  for (const auto &idx : indices)
+  {
+    QCString baseName = idx.info->name;
+    TextStream keys;
+    keys << "var searchShards = [";
+    for (size_t i=0;i<idx.shards.size();i++)
+    {
+      QCString shardFileName;
+      shardFileName.sprintf("%s/%s_s%x.js",searchDirName.data(),baseName.data(),static_cast<unsigned int>(i));
+      results.emplace_back(threadPool.queue([&idx,i,shardFileName]()
+      {
+        writeShard(shardFileName,idx.terms,idx.shards[i]);
+      }));
+      if (i>0) keys << ",";
+      keys << "\"" << idx.shards[i].key << "\"";
+    }
+    keys << "];\n";
+    numShards+=idx.shards.size();
+
+    writeResultsPage(searchDirName+"/"+baseName+"_shards"+Doxygen::htmlFileExtension,QCString(),
+                     keys.str(),
+                     "document.getElementById(\"NoMatches\").style.display=\"none\";\n"
+                     "var searchResults = new SearchResults(\"searchResults\");\n"
+                     "searchResults.SearchShards(searchShards,\""+baseName+"\");\n");
+  }
+  for (auto &f : results) f.get();
+  Debug::print(Debug::Time,0,"Wrote %zu search index shards using %zu threads\n",numShards,numThreads);
+}
+
+void writeJavaScriptSearchIndex()
+{
+  // write index files
+  QCString searchDirName = Config_getString(HTML_OUTPUT)+"/search";
+  static bool sharded = Config_getBool(SEARCHENGINE_SHARDED);
+
+  if (sharded)
+  {
+    writeShardedSearchIndex(searchDirName);
+  }
+  else
+  {
+    writeLetterSearchIndex(searchDirName);
+  }
+
+  {
+    OutputFileStream t(searchDirName.str()+"/searchdata.js");
     if (t.is_open())
     {
       t << "var indexSectionsWithContent =\n";
@@ -1191,13 +1718,17 @@ void writeJavaScriptSearchIndex()
       }
       if (j>0) t << "\n";
       t << "};\n\n";
+      if (sharded)
+      {
+        t << "var indexSectionsSharded = true;\n\n";
+      }
     }
     ResourceMgr::instance().copyResource("search.js",searchDirName);
   }
 
   {
     QCString noMatchesFileName =searchDirName+"/nomatches"+Doxygen::htmlFileExtension;
-    std::ofstream t(noMatchesFileName.str(), std::ofstream::out | std::ofstream::binary);
+    OutputFileStream t(noMatchesFileName.str());
     if (t.is_open())
     {
       t << "<!DOCTYPE html PUBLIC \"-//W3C//DTD XHTML 1.0 Transitional//EN\" "
@@ -23,6 +23,7 @@
 #include <string>
 #include <array>
 #include <functional>
+#include <mutex>
 
 #include "qcstring.h"
 
@@ -35,35 +36,6 @@ void finalizeSearchIndexer();
 
 //------- server side search index ----------------------
 
-struct URL
-{
-  URL(QCString n,QCString u) : name(n), url(u) {}
-  QCString name;
-  QCString url;
-};
-
-
-struct URLInfo
-{
-  URLInfo(int idx,int f) : urlIdx(idx), freq(f) {}
-  int urlIdx;
-  int freq;
-};
-
-class IndexWord
-{
-  public:
-    using URLInfoMap = std::unordered_map<int,URLInfo>;
-    IndexWord(QCString word);
-    void addUrlIndex(int,bool);
-    URLInfoMap urls() const { return m_urls; }
-    QCString word() const { return m_word; }
-
-  private:
-    QCString    m_word;
-    URLInfoMap  m_urls;
-};
-
 class SearchIndexIntf
 {
   public:
@@ -78,20 +50,23 @@ class SearchIndexIntf
     Kind m_kind;
 };
 
+/** Search index used by the server based search engine (doxysearch.php).
+ *
+ *  Each thread adding words collects them in its own builder, which stores
+ *  a compact posting list per word, so no locking is needed while indexing.
+ *  The builders are merged when the index is written.
+ */
 class SearchIndex : public SearchIndexIntf
 {
+    struct Private;
   public:
     SearchIndex();
+   ~SearchIndex();
     void setCurrentDoc(const Definition *ctx,const char *anchor,bool isSourceFile) override;
     void addWord(const char *word,bool hiPriority) override;
     void write(const char *file) override;
   private:
-    void addWord(const char *word,bool hiPrio,bool recurse);
-    std::unordered_map<std::string,int> m_words;
-    std::vector< std::vector< IndexWord> > m_index;
-    std::unordered_map<std::string,int> m_url2IdMap;
-    std::map<int,URL> m_urls;
-    int m_urlIndex = -1;
+    std::unique_ptr<Private> p;
 };
 
 
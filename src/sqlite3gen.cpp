@@ -16,6 +16,9 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <sstream>
+#include <deque>
+#include <future>
+#include <thread>
 
 #include "settings.h"
 #include "message.h"
@@ -30,6 +33,7 @@
 #include "util.h"
 #include "outputlist.h"
 #include "docparser.h"
+#include "docrootcache.h"
 #include "language.h"
 
 #include "version.h"
@@ -47,6 +51,7 @@
 #include "section.h"
 #include "fileinfo.h"
 #include "dir.h"
+#include "threadpool.h"
 
 #include <sys/stat.h>
 #include <string.h>
@@ -1392,10 +1397,10 @@ QCString getSQLDocBlock(const Definition *scope,
   if (doc.isEmpty()) return "";
 
   TextStream t;
-  DocNode *root = validatingParseDoc(
+  std::shared_ptr<DocRoot> root = DocRootCache::instance().parse(
     fileName,
     lineNr,
-    const_cast<Definition*>(scope),
+    scope,
     toMemberDef(def),
     doc,
     FALSE,
@@ -1410,15 +1415,137 @@ QCString getSQLDocBlock(const Definition *scope,
   XmlDocVisitor *visitor = new XmlDocVisitor(t,codeGen,scope?scope->getDefFileExtension():QCString(""));
   root->accept(visitor);
   delete visitor;
-  delete root;
   return convertCharEntitiesToUTF8(t.str().c_str());
 }
 
+/** Converts the documentation of the definitions to XML in worker threads,
+ *  while the results are written to the database on the main thread. The
+ *  documentation is listed in the order in which the writer needs it, and
+ *  only a limited number of conversions is kept ahead of the writer.
+ */
+class SqlDocBlockQueue
+{
+  public:
+    SqlDocBlockQueue(std::size_t numThreads) : m_maxPending(4*numThreads)
+    {
+      if (numThreads>1) m_threadPool = std::make_unique<ThreadPool>(numThreads);
+    }
+   ~SqlDocBlockQueue()
+    {
+      if (m_threadPool) m_threadPool->finish();
+    }
+
+    /** Adds the brief, detailed and inbody documentation of \a def to the list */
+    void add(const Definition *def,bool withInbody=false)
+    {
+      if (!m_threadPool) return;
+      m_work.push_back({def,DocType::Brief});
+      m_work.push_back({def,DocType::Detailed});
+      if (withInbody) m_work.push_back({def,DocType::Inbody});
+    }
+
+    /** Adds the documentation of the members that are written for compound \a d */
+    void addMembers(const Definition *d,const MemberGroupList &mgl,const MemberLists &mls)
+    {
+      for (const auto &mg : mgl)
+      {
+        addMembers(d,&mg->members());
+      }
+      for (const auto &ml : mls)
+      {
+        if ((ml->listType()&MemberListType_detailedLists)==0)
+        {
+          addMembers(d,ml.get());
+        }
+      }
+    }
+
+    /** Returns the XML for documentation \a doc of \a def, waiting for the
+     *  conversion if it was started but is not done yet.
+     */
+    QCString get(const Definition *def,const QCString &doc)
+    {
+      if (doc.isEmpty()) return "";
+      fill();
+      for (auto it=m_pending.begin(); it!=m_pending.end(); ++it)
+      {
+        if (it->def==def && it->doc==doc)
+        {
+          QCString result = it->result.get();
+          // the entries before this one were skipped by the writer, so drop them as well
+          m_pending.erase(m_pending.begin(),it+1);
+          fill();
+          return result;
+        }
+      }
+      return convert(def,doc);
+    }
+
+  private:
+    enum class DocType { Brief, Detailed, Inbody };
+    struct Work
+    {
+      const Definition *def;
+      DocType type;
+    };
+    struct Entry
+    {
+      const Definition *def;
+      QCString doc;
+      std::future<QCString> result;
+    };
+
+    static QCString convert(const Definition *def,const QCString &doc)
+    {
+      return getSQLDocBlock(def->getOuterScope(),def,doc,def->docFile(),def->docLine());
+    }
+
+    /** Starts the conversion of the next documentation blocks in the list,
+     *  until m_maxPending of them are waiting for the writer.
+     */
+    void fill()
+    {
+      while (m_pending.size()<m_maxPending && m_next<m_work.size())
+      {
+        const Work &work = m_work[m_next++];
+        const Definition *def = work.def;
+        QCString doc = work.type==DocType::Brief    ? def->briefDescription() :
+                       work.type==DocType::Detailed ? def->documentation()    :
+                                                      def->inbodyDocumentation();
+        if (doc.isEmpty()) continue;
+        m_pending.push_back({def,doc,m_threadPool->queue([def,doc]() { return convert(def,doc); })});
+      }
+    }
+
+    void addMembers(const Definition *d,const MemberList *ml)
+    {
+      for (const auto &md : *ml)
+      {
+        // same selection as generateSqlite3Section() and generateSqlite3ForMember()
+        if ((d->definitionType()!=Definition::TypeFile || md->getNamespaceDef()==0) &&
+            md->memberType()!=MemberType_EnumValue && !md->isHidden())
+        {
+          add(md,true);
+        }
+      }
+    }
+
+    const std::size_t m_maxPending;
+    std::vector<Work> m_work;       // documentation in the order of the writer
+    std::size_t m_next = 0;         // index of the next element of m_work to start
+    std::deque<Entry> m_pending;    // started conversions that were not read yet
+    std::unique_ptr<ThreadPool> m_threadPool;
+};
+
+static SqlDocBlockQueue *g_docBlockQueue = 0;
+
 static void getSQLDesc(SqlStmt &s,const char *col,const char *value,const Definition *def)
 {
   bindTextParameter(
     s,
     col,
+    g_docBlockQueue ?
+    g_docBlockQueue->get(def,value) :
     getSQLDocBlock(
       def->getOuterScope(),
       def,
@@ -1428,6 +1555,64 @@ static void getSQLDesc(SqlStmt &s,const char *col,const char *value,const Defini
     )
   );
 }
+
+/** Lists the documentation of everything that will be written, in the
+ *  order of generateSqlite3().
+ */
+static void queueSqlite3DocBlocks(SqlDocBlockQueue &queue)
+{
+  for (const auto &cd : *Doxygen::classLinkedMap)
+  {
+    if (cd->isReference() || cd->isHidden()) continue;
+    queue.add(cd.get());
+    queue.addMembers(cd.get(),cd->getMemberGroups(),cd->getMemberLists());
+  }
+  for (const auto &cd : *Doxygen::conceptLinkedMap)
+  {
+    if (cd->isReference() || cd->isHidden()) continue;
+    queue.add(cd.get());
+  }
+  for (const auto &nd : *Doxygen::namespaceLinkedMap)
+  {
+    if (nd->isReference() || nd->isHidden()) continue;
+    queue.add(nd.get());
+    queue.addMembers(nd.get(),nd->getMemberGroups(),nd->getMemberLists());
+  }
+  for (const auto &fn : *Doxygen::inputNameLinkedMap)
+  {
+    for (const auto &fd : *fn)
+    {
+      if (fd->isReference()) continue;
+      queue.add(fd.get());
+      queue.addMembers(fd.get(),fd->getMemberGroups(),fd->getMemberLists());
+    }
+  }
+  for (const auto &gd : *Doxygen::groupLinkedMap)
+  {
+    if (gd->isReference()) continue;
+    queue.add(gd.get());
+    queue.addMembers(gd.get(),gd->getMemberGroups(),gd->getMemberLists());
+  }
+  for (const auto &pd : *Doxygen::pageLinkedMap)
+  {
+    if (pd->isReference()) continue;
+    queue.add(pd.get());
+  }
+  for (const auto &dd : *Doxygen::dirLinkedMap)
+  {
+    if (dd->isReference()) continue;
+    queue.add(dd.get());
+  }
+  for (const auto &pd : *Doxygen::exampleLinkedMap)
+  {
+    if (pd->isReference()) continue;
+    queue.add(pd.get());
+  }
+  if (Doxygen::mainPage)
+  {
+    queue.add(Doxygen::mainPage.get());
+  }
+}
 ////////////////////////////////////////////
 
 /* (updated Sep 01 2018)
@@ -2500,6 +2685,19 @@ void generateSqlite3()
 
   recordMetadata();
 
+  // convert the documentation in the background, while writing the database
+  std::size_t numThreads = static_cast<std::size_t>(Config_getInt(NUM_PROC_THREADS));
+  if (numThreads==0)
+  {
+    numThreads = std::thread::hardware_concurrency();
+  }
+  SqlDocBlockQueue docBlockQueue(numThreads);
+  if (numThreads>1)
+  {
+    queueSqlite3DocBlocks(docBlockQueue);
+    g_docBlockQueue = &docBlockQueue;
+  }
+
   // + classes
   for (const auto &cd : *Doxygen::classLinkedMap)
   {
@@ -2566,8 +2764,11 @@ void generateSqlite3()
     generateSqlite3ForPage(Doxygen::mainPage.get(),FALSE);
   }
 
+  g_docBlockQueue = 0;
+
   // TODO: copied from initializeSchema; not certain if we should say/do more
   // if there's a failure here?
+
   if (-1==initializeViews(db))
     return;
 
@@ -0,0 +1,69 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#include <mutex>
+#include <unordered_set>
+
+#include "stringpool.h"
+
+// the pool is split in shards with their own lock, so threads that parse
+// files at the same time rarely wait for each other.
+static const size_t g_numShards = 64;
+
+namespace
+{
+
+struct Shard
+{
+  std::mutex mutex;
+  std::unordered_set<std::string> strings; // node based, so the elements do not move
+  size_t size = 0;
+};
+
+}
+
+static Shard g_shards[g_numShards];
+
+const std::string *StringPool::intern(const std::string &s)
+{
+  if (s.empty()) return 0;
+  Shard &shard = g_shards[std::hash<std::string>()(s)%g_numShards];
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto result = shard.strings.insert(s);
+  if (result.second) shard.size+=s.length();
+  return &*result.first;
+}
+
+size_t StringPool::count()
+{
+  size_t result=0;
+  for (auto &shard : g_shards)
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    result+=shard.strings.size();
+  }
+  return result;
+}
+
+size_t StringPool::size()
+{
+  size_t result=0;
+  for (auto &shard : g_shards)
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    result+=shard.size;
+  }
+  return result;
+}
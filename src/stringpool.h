@@ -0,0 +1,71 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <string>
+
+#include "qcstring.h"
+
+/** @brief Table of immutable strings that are stored only once.
+ *
+ *  Many definitions share the same file name, file extension, return type,
+ *  etc. Storing these strings in the pool means each distinct string is
+ *  kept in memory only once. Strings are never removed from the pool, so
+ *  a pointer returned by intern() remains valid until the program ends.
+ *
+ *  The functions can be called from multiple threads at the same time.
+ */
+class StringPool
+{
+  public:
+    /** Returns the pooled copy of \a s, or 0 if \a s is empty. */
+    static const std::string *intern(const std::string &s);
+
+    /** Returns the number of distinct strings in the pool */
+    static size_t count();
+
+    /** Returns the number of characters stored in the pool */
+    static size_t size();
+};
+
+/** @brief Immutable string that is stored in the StringPool.
+ *
+ *  An object is only the size of a pointer, and copying it does not copy
+ *  the characters.
+ */
+class InternedString
+{
+  public:
+    InternedString() = default;
+    InternedString(const QCString &s) : m_rep(StringPool::intern(s.str())) {}
+    InternedString &operator=(const QCString &s) { m_rep = StringPool::intern(s.str()); return *this; }
+
+    /** Returns a pointer to the characters, which stays valid until the end of the program */
+    const char *data() const     { return m_rep ? m_rep->c_str() : ""; }
+    std::string str() const      { return m_rep ? *m_rep : std::string(); }
+    bool isEmpty() const         { return m_rep==0; }
+    uint length() const          { return m_rep ? static_cast<uint>(m_rep->length()) : 0; }
+    operator QCString() const    { return m_rep ? QCString(*m_rep) : QCString(); }
+
+    bool operator==(const char *s) const { return qstrcmp(data(),s)==0; }
+    bool operator!=(const char *s) const { return qstrcmp(data(),s)!=0; }
+
+  private:
+    const std::string *m_rep = 0;
+};
+
+#endif
@@ -24,8 +24,6 @@
 #include "config.h"
 #include "defargs.h"
 
-static std::mutex g_cacheMutex;
-
 //--------------------------------------------------------------------------------------
 
 /** Helper class representing the stack of items considered while resolving
@@ -257,30 +255,22 @@ const ClassDef *SymbolResolver::Private::getResolvedClassRec(
   }
   *pk='\0';
 
-  LookupInfo *pval = 0;
+  // if not found yet, we already add a 0 to avoid the possibility of
+  // endless recursion.
+  LookupInfo cached;
+  if (Doxygen::lookupCache->findOrInsert(key.str(),cached))
   {
-    std::lock_guard<std::mutex> lock(g_cacheMutex);
-    pval=Doxygen::lookupCache->find(key.str());
-    //printf("Searching for %s result=%p\n",key.data(),pval);
-    if (pval)
-    {
-      //printf("LookupInfo %p %p '%s' %p\n",
-      //    pval->classDef, pval->typeDef, pval->templSpec.data(),
-      //    pval->resolvedType.data());
-      if (pTemplSpec)    *pTemplSpec=pval->templSpec;
-      if (pTypeDef)      *pTypeDef=pval->typeDef;
-      if (pResolvedType) *pResolvedType=pval->resolvedType;
-      //fprintf(stderr,"%d ] cachedMatch=%s\n",--level,
-      //    pval->classDef?pval->classDef->name().data():"<none>");
-      //if (pTemplSpec)
-      //  printf("templSpec=%s\n",pTemplSpec->data());
-      return pval->classDef;
-    }
-    else // not found yet; we already add a 0 to avoid the possibility of
-      // endless recursion.
-    {
-      pval = Doxygen::lookupCache->insert(key.str(),LookupInfo());
-    }
+    //printf("LookupInfo %p %p '%s' %p\n",
+    //    cached.classDef, cached.typeDef, cached.templSpec.data(),
+    //    cached.resolvedType.data());
+    if (pTemplSpec)    *pTemplSpec=cached.templSpec;
+    if (pTypeDef)      *pTypeDef=cached.typeDef;
+    if (pResolvedType) *pResolvedType=cached.resolvedType;
+    //fprintf(stderr,"%d ] cachedMatch=%s\n",--level,
+    //    cached.classDef?cached.classDef->name().data():"<none>");
+    //if (pTemplSpec)
+    //  printf("templSpec=%s\n",pTemplSpec->data());
+    return cached.classDef;
   }
 
   const ClassDef *bestMatch=0;
@@ -312,14 +302,7 @@ const ClassDef *SymbolResolver::Private::getResolvedClassRec(
   //printf("getResolvedClassRec: bestMatch=%p pval->resolvedType=%s\n",
   //    bestMatch,bestResolvedType.data());
 
-  if (pval)
-  {
-    std::lock_guard<std::mutex> lock(g_cacheMutex);
-    pval->classDef     = bestMatch;
-    pval->typeDef      = bestTypedef;
-    pval->templSpec    = bestTemplSpec;
-    pval->resolvedType = bestResolvedType;
-  }
+  Doxygen::lookupCache->insert(key.str(),LookupInfo(bestMatch,bestTypedef,bestTemplSpec,bestResolvedType));
   //fprintf(stderr,"%d ] bestMatch=%s distance=%d\n",--level,
   //    bestMatch?bestMatch->name().data():"<none>",minDistance);
   //if (pTemplSpec)
@@ -32,6 +32,7 @@
 #include "dir.h"
 #include "utf8.h"
 #include "urlstring.h"
+#include "stringpool.h"
 
 #define ENABLE_TRACING 0
 
@@ -502,6 +503,27 @@ struct TemplateKeyValue
   TemplateVariant value;
 };
 
+/** Returns the pooled copy of a property name. The structs in context.cpp
+ *  find their properties by the address of the pooled name.
+ */
+static const char *propertyId(const QCString &name)
+{
+  const std::string *pooled = StringPool::intern(name.str());
+  return pooled ? pooled->c_str() : "";
+}
+
+/** @brief One step in the path of a variable like `a.b.0`, determined when
+ *  the template is parsed.
+ */
+struct TemplatePathElement
+{
+  QCString    name;    // name of the property or the list index
+  const char *id;      // name as a pooled string, so property lookups can use its address
+  QCString    rest;    // the path starting at this element, for warnings
+  bool        isIndex; // TRUE if name is a valid list index
+  int         index;
+};
+
 /** @brief Internal class representing the implementation of a template
  *  context */
 class TemplateContextImpl : public TemplateContext
@@ -516,6 +538,7 @@ class TemplateContextImpl : public TemplateContext
     void set(const char *name,const TemplateVariant &v);
     TemplateVariant get(const QCString &name) const;
     const TemplateVariant *getRef(const QCString &name) const;
+    TemplateVariant get(const QCString &objName,const std::vector<TemplatePathElement> &path) const;
     void setOutputDirectory(const QCString &dir)
     { m_outputDir = dir; }
     void setEscapeIntf(const QCString &ext,TemplateEscapeIntf *intf)
@@ -628,7 +651,7 @@ class FilterGet
     {
       if (v.isValid() && v.type()==TemplateVariant::Struct && arg.type()==TemplateVariant::String)
       {
-        TemplateVariant result = v.toStruct()->get(arg.toString());
+        TemplateVariant result = v.toStruct()->get(propertyId(arg.toString()));
         //printf("\nok[%s]=%d\n",arg.toString().data(),result.type());
         return result;
       }
@@ -844,7 +867,8 @@ class FilterFlatten
         {
           list->append(item);
           // if s has "children" then recurse into the children
-          TemplateVariant children = s->get("children");
+          static const char *childrenId = propertyId("children");
+          TemplateVariant children = s->get(childrenId);
           if (children.isValid() && children.type()==TemplateVariant::List)
           {
             flatten(children.toList(),list);
@@ -924,7 +948,7 @@ class FilterListSort
         if (j!=-1)
         {
           QCString var = arg.mid(i+2,j-i-2);
-          TemplateVariant val=s->get(var);
+          TemplateVariant val=s->get(propertyId(var));
           //printf("found argument %s value=%s\n",var.data(),val.toString().data());
           result+=val.toString();
           p=j+2;
@@ -965,12 +989,13 @@ class FilterGroupBy
         using SortList = std::vector<ListElem>;
         SortList sortList;
         sortList.reserve(v.toList()->count());
+        const char *attribId = propertyId(args.toString());
         for (it->toFirst();(it->current(item));it->toNext())
         {
           TemplateStructIntf *s = item.toStruct();
           if (s)
           {
-            QCString sortKey = determineSortKey(s,args.toString());
+            QCString sortKey = determineSortKey(s,attribId);
             sortList.emplace_back(sortKey,item);
             //printf("sortKey=%s\n",sortKey.data());
           }
@@ -1001,9 +1026,9 @@ class FilterGroupBy
     }
 
   private:
-    static QCString determineSortKey(TemplateStructIntf *s,const QCString &attribName)
+    static QCString determineSortKey(TemplateStructIntf *s,const char *attribId)
     {
-       TemplateVariant v = s->get(attribName);
+       TemplateVariant v = s->get(attribId);
        return v.toString();
     }
 };
@@ -1104,9 +1129,9 @@ class FilterAlphaIndex
       }
       return result;
     }
-    static uint determineSortKey(TemplateStructIntf *s,const QCString &attribName)
+    static uint determineSortKey(TemplateStructIntf *s,const char *attribId)
     {
-       TemplateVariant v = s->get(attribName);
+       TemplateVariant v = s->get(attribId);
        int index = getPrefixIndex(v.toString());
        return getUnicodeForUTF8CharAt(
                  convertUTF8ToUpper(
@@ -1129,12 +1154,13 @@ class FilterAlphaIndex
         using SortList = std::vector<ListElem>;
         SortList sortList;
         sortList.reserve(v.toList()->count());
+        const char *attribId = propertyId(args.toString());
         for (it->toFirst();(it->current(item));it->toNext())
         {
           TemplateStructIntf *s = item.toStruct();
           if (s)
           {
-            uint sortKey = determineSortKey(s,args.toString());
+            uint sortKey = determineSortKey(s,attribId);
             sortList.emplace_back(sortKey,item);
             //printf("sortKey=%s\n",sortKey.data());
           }
@@ -1409,12 +1435,37 @@ class ExprAstVariable : public ExprAst
 {
   public:
     ExprAstVariable(const char *name) : m_name(name)
-    { TRACE(("ExprAstVariable(%s)\n",name)); }
+    {
+      TRACE(("ExprAstVariable(%s)\n",name));
+      // split a name like a.b.c once, instead of each time the variable is resolved
+      int i=m_name.find('.');
+      if (i==-1)
+      {
+        m_objName = m_name;
+      }
+      else
+      {
+        m_objName = m_name.left(i);
+        QCString propName = m_name.mid(i+1);
+        while (!propName.isEmpty())
+        {
+          i = propName.find('.');
+          int l = i==-1 ? propName.length() : i;
+          TemplatePathElement elem;
+          elem.name  = propName.left(l);
+          elem.id    = propertyId(elem.name);
+          elem.rest  = propName;
+          elem.index = elem.name.toInt(&elem.isIndex);
+          m_path.push_back(elem);
+          propName = i!=-1 ? propName.mid(i+1) : QCString();
+        }
+      }
+    }
     const QCString &name() const { return m_name; }
     virtual TemplateVariant resolve(TemplateContext *c)
     {
-      TemplateVariant v = c->get(m_name);
       TemplateContextImpl *ci = dynamic_cast<TemplateContextImpl*>(c);
+      TemplateVariant v = ci ? ci->get(m_objName,m_path) : c->get(m_name);
       if (!v.isValid())
       {
         if (ci) ci->warn(ci->templateName(),ci->line(),"undefined variable '%s' in expression",m_name.data());
@@ -1423,6 +1474,8 @@ class ExprAstVariable : public ExprAst
     }
   private:
     QCString m_name;
+    QCString m_objName;
+    std::vector<TemplatePathElement> m_path;
 };
 
 class ExprAstFunctionVariable : public ExprAst
@@ -2401,7 +2454,7 @@ TemplateVariant TemplateContextImpl::get(const QCString &name) const
       {
         i = propName.find(".");
         int l = i==-1 ? propName.length() : i;
-        v = v.toStruct()->get(propName.left(l));
+        v = v.toStruct()->get(propertyId(propName.left(l)));
         if (!v.isValid())
         {
           warn(m_templateName,m_line,"requesting non-existing property '%s' for object '%s'",propName.left(l).data(),objName.data());
@@ -2450,6 +2503,47 @@ TemplateVariant TemplateContextImpl::get(const QCString &name) const
   }
 }
 
+/** Same as get(name) for a name that is already split into the object name and the path */
+TemplateVariant TemplateContextImpl::get(const QCString &objNameArg,const std::vector<TemplatePathElement> &path) const
+{
+  QCString objName = objNameArg;
+  TemplateVariant v = getPrimary(objName);
+  for (size_t i=0;i<path.size();i++)
+  {
+    const TemplatePathElement &elem = path[i];
+    if (v.type()==TemplateVariant::Struct)
+    {
+      v = v.toStruct()->get(elem.id);
+      if (!v.isValid())
+      {
+        warn(m_templateName,m_line,"requesting non-existing property '%s' for object '%s'",elem.name.data(),objName.data());
+      }
+      if (i+1<path.size())
+      {
+        objName = elem.name;
+      }
+    }
+    else if (v.type()==TemplateVariant::List)
+    {
+      if (elem.isIndex)
+      {
+        v = v.toList()->at(elem.index);
+      }
+      else
+      {
+        warn(m_templateName,m_line,"list index '%s' is not valid",elem.rest.data());
+        break;
+      }
+    }
+    else
+    {
+      warn(m_templateName,m_line,"using . on an object '%s' is not an struct or list",objName.data());
+      return TemplateVariant();
+    }
+  }
+  return v;
+}
+
 const TemplateVariant *TemplateContextImpl::getRef(const QCString &name) const
 {
   for (const auto &ctx : m_contextStack)
@@ -2553,7 +2647,8 @@ void TemplateContextImpl::closeSubIndex(const QCString &indexName)
 
 static void getPathListFunc(TemplateStructIntf *entry,TemplateList *list)
 {
-  TemplateVariant parent = entry->get("parent");
+  static const char *parentId = propertyId("parent");
+  TemplateVariant parent = entry->get(parentId);
   if (parent.type()==TemplateVariant::Struct)
   {
     getPathListFunc(parent.toStruct(),list);
@@ -3163,6 +3258,10 @@ class TemplateNodeFor : public TemplateNodeCreator<TemplateNodeFor>
       else
       {
         m_vars = split(data.left(i),",");
+        for (const auto &var : m_vars)
+        {
+          m_varIds.push_back(propertyId(var));
+        }
         if (m_vars.size()==0)
         {
           parser->warn(m_templateName,line,"for needs at least one iterator variable");
@@ -3257,7 +3356,7 @@ class TemplateNodeFor : public TemplateNodeCreator<TemplateNodeFor>
             {
               for (uint i=0;i<m_vars.size();i++,vi++)
               {
-                c->set(m_vars[vi],ve.toStruct()->get(m_vars[vi]));
+                c->set(m_vars[vi],ve.toStruct()->get(m_varIds[vi]));
               }
             }
             for (;vi<m_vars.size();vi++)
@@ -3284,6 +3383,7 @@ class TemplateNodeFor : public TemplateNodeCreator<TemplateNodeFor>
     bool m_reversed = false;
     ExprAst *m_expr = 0;
     std::vector<QCString> m_vars;
+    std::vector<const char *> m_varIds; // m_vars as pooled strings
     TemplateNodeList m_loopNodes;
     TemplateNodeList m_emptyNodes;
 };
@@ -3729,7 +3829,8 @@ class TemplateNodeTree : public TemplateNodeCreator<TemplateNodeTree>
         const TemplateStructIntf *ns = node.toStruct();
         if (ns) // node is a struct
         {
-          TemplateVariant v = ns->get("children");
+          static const char *childrenId = propertyId("children");
+          TemplateVariant v = ns->get(childrenId);
           if (v.isValid()) // with a field 'children'
           {
             const TemplateListIntf *list = v.toList();
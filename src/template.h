@@ -410,7 +410,9 @@ class TemplateStructIntf
     virtual ~TemplateStructIntf() {}
 
     /** Gets the value for a field name.
-     *  @param[in] name The name of the field.
+     *  @param[in] name The name of the field. The template engine passes
+     *  pooled strings (see StringPool), which the structs in context.cpp
+     *  look up by address.
      */
     virtual TemplateVariant get(const char *name) const = 0;
 
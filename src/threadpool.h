@@ -16,10 +16,12 @@
 #ifndef THREADPOOL_H
 #define THREADPOOL_H
 
+#include <atomic>
 #include <condition_variable>
 #include <deque>
 #include <functional>
 #include <future>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <type_traits>
@@ -30,6 +32,14 @@
 /// Work can be queued by passing a function to queue(). A future will be
 /// returned that can be used to obtain the result of the function after execution.
 ///
+/// Each worker thread has its own queue of tasks. Tasks are distributed over
+/// the queues in a round robin fashion (or put in the queue of the worker itself
+/// when queued from within a task). A worker first runs the tasks from its own
+/// queue in the order in which they were queued, and when that is empty it steals
+/// tasks from the back of the queues of the other workers. So if the work is
+/// queued with the most expensive tasks first, those are also started first,
+/// and idle workers pick up the remaining small tasks.
+///
 /// Usage example:
 /// @code
 /// ThreadPool pool(10);
@@ -50,15 +60,14 @@ class ThreadPool
     /// start N threads in the thread pool.
     ThreadPool(std::size_t N=1)
     {
+      if (N==0) N=1;
+      for (std::size_t i = 0; i < N; ++i)
+      {
+        m_queues.push_back(std::make_unique<WorkQueue>());
+      }
       for (std::size_t i = 0; i < N; ++i)
       {
-        // each thread is a std::async running thread_task():
-        m_finished.push_back(
-            std::async(
-              std::launch::async,
-              [this]{ threadTask(); }
-              )
-            );
+        m_threads.emplace_back([this,i]{ threadTask(i); });
       }
     }
     /// deletes the thread pool by finishing all threads
@@ -81,71 +90,132 @@ class ThreadPool
       auto taskFunc = [ptr]() { if (ptr->valid()) (*ptr)(); };
 
       auto r=ptr->get_future(); // get the return value before we hand off the task
+
+      // tasks queued by a worker of this pool go to its own queue
+      const WorkerInfo &wi = currentWorker();
+      std::size_t index = wi.pool==this ? wi.index :
+                          m_next.fetch_add(1) % m_queues.size();
+      {
+        std::lock_guard<std::mutex> l(m_queues[index]->mutex);
+        m_queues[index]->tasks.emplace_back(taskFunc);
+      }
       {
-        std::unique_lock<std::mutex> l(m_mutex);
-        m_work.emplace_back(taskFunc);
-        m_cond.notify_one(); // wake a thread to work on the task
+        std::lock_guard<std::mutex> l(m_mutex);
+        m_pending++;
       }
+      m_cond.notify_one(); // wake a thread to work on the task
 
       return r; // return the future result of the task
     }
 
-    /// finish enques a "stop the thread" message for every thread,
+    /// finish lets the threads process all queued work,
     /// then waits for them to finish
     void finish()
     {
       {
-        std::unique_lock<std::mutex> l(m_mutex);
-        for(auto&& u : m_finished)
-        {
-          unused_variable(u);
-          m_work.push_back({}); // insert empty function object to signal abort
-        }
+        std::lock_guard<std::mutex> l(m_mutex);
+        m_stop = true;
       }
       m_cond.notify_all();
-      m_finished.clear();
+      for (auto &t : m_threads)
+      {
+        if (t.joinable()) t.join();
+      }
+      m_threads.clear();
     }
   private:
+    struct WorkQueue
+    {
+      std::mutex mutex;
+      std::deque< std::function<void()> > tasks;
+    };
 
-    // helper to silence the compiler warning about unused variables
-    template <typename ...Args>
-    void unused_variable(Args&& ...args) { (void)(sizeof...(args)); }
+    // take a task from the front of our own queue, or steal one from the
+    // back of the queue of another worker
+    bool takeTask(std::size_t index,std::function<void()> &f)
+    {
+      {
+        WorkQueue &q = *m_queues[index];
+        std::lock_guard<std::mutex> l(q.mutex);
+        if (!q.tasks.empty())
+        {
+          f = std::move(q.tasks.front());
+          q.tasks.pop_front();
+          return true;
+        }
+      }
+      for (std::size_t i=1; i<m_queues.size(); i++)
+      {
+        WorkQueue &q = *m_queues[(index+i)%m_queues.size()];
+        std::lock_guard<std::mutex> l(q.mutex);
+        if (!q.tasks.empty())
+        {
+          f = std::move(q.tasks.back());
+          q.tasks.pop_back();
+          return true;
+        }
+      }
+      return false;
+    }
 
     // the work that a worker thread does:
-    void threadTask()
+    void threadTask(std::size_t index)
     {
+      currentWorker() = WorkerInfo { this, index };
       while(true)
       {
-        // pop a task off the queue:
         std::function<void()> f;
+        if (takeTask(index,f))
+        {
+          {
+            std::lock_guard<std::mutex> l(m_mutex);
+            m_pending--;
+          }
+          // run the task
+          f();
+        }
+        else
         {
-          // usual thread-safe queue code:
+          // nothing to do; wait until more work is queued or we are asked to stop
           std::unique_lock<std::mutex> l(m_mutex);
-          if (m_work.empty())
+          if (m_pending<=0)
           {
-            m_cond.wait(l,[&]{return !m_work.empty();});
+            if (m_stop) break;
+            m_cond.wait(l,[&]{ return m_pending>0 || m_stop; });
           }
-          f = std::move(m_work.front());
-          m_work.pop_front();
         }
-        // if the function is empty, it means we are asked to abort
-        if (!f) return;
-        // run the task
-        f();
       }
+      currentWorker() = WorkerInfo();
     }
 
-    // the mutex, condition variable and deque form a single
-    // thread-safe triggered queue of tasks:
+    // one queue of tasks per worker thread
+    std::vector< std::unique_ptr<WorkQueue> > m_queues;
+
+    // the mutex and condition variable are used to let idle threads
+    // wait for work; m_pending is the number of queued tasks that have
+    // not been taken by a worker yet (it can become negative
+    // temporarily if a task is taken before it is counted).
     std::mutex m_mutex;
     std::condition_variable m_cond;
+    long m_pending = 0;
+    bool m_stop = false;
+
+    // queue that receives the next task queued from outside the pool
+    std::atomic<std::size_t> m_next { 0 };
 
-    // hold the queue of work
-    std::deque< std::function<void()> > m_work;
+    std::vector< std::thread > m_threads;
 
-    // this holds futures representing the worker threads being done:
-    std::vector< std::future<void> > m_finished;
+    // the pool and queue of the worker that runs on the calling thread (if any)
+    struct WorkerInfo
+    {
+      ThreadPool *pool = nullptr;
+      std::size_t index = 0;
+    };
+    static WorkerInfo &currentWorker()
+    {
+      static thread_local WorkerInfo info;
+      return info;
+    }
 };
 
 #endif
-
@@ -105,10 +105,14 @@ void TooltipManager::writeTooltips(CodeOutputInterface &ol)
 {
   int outputId = ol.id(); // get unique identifier per output file
   if (outputId==0) return; // not set => no HTML output
-  auto it = p->tooltips.find(outputId); // see if we have tooltips for this file
-  if (it!=p->tooltips.end())
+  TooltipData *ttd = 0;
+  {
+    std::lock_guard<std::mutex> lock(g_tooltipLock);
+    auto it = p->tooltips.find(outputId); // see if we have tooltips for this file
+    if (it!=p->tooltips.end()) ttd = it->second.get();
+  }
+  if (ttd)
   {
-    auto &ttd = it->second;
     for (const auto &kv : ttd->tooltipInfo)
     {
       if (ttd->tooltipWritten.find(kv.first)==ttd->tooltipWritten.end()) // only write tooltips once
@@ -0,0 +1,265 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "trace.h"
+#include "portable.h"
+#include "message.h"
+
+//---------------------------------------------------------------------------
+
+// interval at which the memory in use is sampled
+static const std::chrono::milliseconds g_sampleInterval(100);
+
+namespace
+{
+
+struct Event
+{
+  char        phase;    // 'X' for a span, 'C' for a counter
+  const char *category; // kind of span or name of the counter
+  std::string name;     // name of the span or series of the counter
+  std::string detail;
+  int64_t     start;    // microseconds since the start of the trace
+  int64_t     duration; // microseconds, spans only
+  double      value;    // counters only
+};
+
+struct OpenSpan
+{
+  const char *category;
+  std::string name;
+  std::string detail;
+  int64_t     start;
+};
+
+/** The events recorded by one thread. Only that thread adds events, so no
+ *  locking is needed until the trace is written.
+ */
+struct ThreadBuffer
+{
+  int tid;
+  std::string threadName;
+  std::vector<Event> events;
+  std::vector<OpenSpan> openSpans;
+};
+
+}
+
+static std::string g_fileName;
+static std::chrono::steady_clock::time_point g_startTime;
+static std::mutex g_buffersMutex;
+static std::vector< std::unique_ptr<ThreadBuffer> > g_buffers;
+static thread_local ThreadBuffer *t_buffer = 0;
+
+static std::thread g_sampler;
+static std::mutex g_samplerMutex;
+static std::condition_variable g_samplerCond;
+static bool g_samplerStop = false;
+
+bool Trace::s_enabled = false;
+
+static int64_t now()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now()-g_startTime).count();
+}
+
+static ThreadBuffer *threadBuffer(const char *threadName=0)
+{
+  if (t_buffer==0)
+  {
+    std::lock_guard<std::mutex> lock(g_buffersMutex);
+    auto buf = std::make_unique<ThreadBuffer>();
+    buf->tid = static_cast<int>(g_buffers.size())+1;
+    if (threadName)
+    {
+      buf->threadName = threadName;
+    }
+    else if (buf->tid==1)
+    {
+      buf->threadName = "main";
+    }
+    else
+    {
+      buf->threadName = "worker "+std::to_string(buf->tid);
+    }
+    t_buffer = buf.get();
+    g_buffers.push_back(std::move(buf));
+  }
+  return t_buffer;
+}
+
+static void sampleMemory()
+{
+  threadBuffer("memory sampler");
+  std::unique_lock<std::mutex> lock(g_samplerMutex);
+  do
+  {
+    Trace::counter("memory","resident MB",
+                   static_cast<double>(Portable::residentMemory())/(1024.0*1024.0));
+  }
+  while (!g_samplerCond.wait_for(lock,g_sampleInterval,[]() { return g_samplerStop; }));
+}
+
+//---------------------------------------------------------------------------
+
+void Trace::start(const QCString &fileName)
+{
+  if (s_enabled) return;
+  g_fileName  = fileName.str();
+  g_startTime = std::chrono::steady_clock::now();
+  threadBuffer(); // the thread that starts the trace is the main thread
+  s_enabled   = true;
+  g_sampler   = std::thread(sampleMemory);
+}
+
+void Trace::begin(const char *category,const QCString &name,const QCString &detail)
+{
+  if (!s_enabled) return;
+  threadBuffer()->openSpans.push_back({category,name.str(),detail.str(),now()});
+}
+
+void Trace::end(const char *category)
+{
+  if (!s_enabled) return;
+  ThreadBuffer *buf = threadBuffer();
+  if (buf->openSpans.empty() || qstrcmp(buf->openSpans.back().category,category)!=0) return;
+  OpenSpan &span = buf->openSpans.back();
+  buf->events.push_back({'X',span.category,std::move(span.name),std::move(span.detail),
+                         span.start,now()-span.start,0.0});
+  buf->openSpans.pop_back();
+}
+
+void Trace::counter(const char *name,const char *series,double value)
+{
+  if (!s_enabled) return;
+  threadBuffer()->events.push_back({'C',name,series,std::string(),now(),0,value});
+}
+
+//---------------------------------------------------------------------------
+
+static void writeString(std::ostream &t,const std::string &s)
+{
+  t << '"';
+  for (char c : s)
+  {
+    switch (c)
+    {
+      case '"':  t << "\\\""; break;
+      case '\\': t << "\\\\"; break;
+      case '\n': t << "\\n";  break;
+      case '\r': t << "\\r";  break;
+      case '\t': t << "\\t";  break;
+      default:
+        if (static_cast<unsigned char>(c)<0x20)
+        {
+          char hex[8];
+          qsnprintf(hex,sizeof(hex),"\\u%04x",c);
+          t << hex;
+        }
+        else
+        {
+          t << c;
+        }
+        break;
+    }
+  }
+  t << '"';
+}
+
+void Trace::finish()
+{
+  if (!s_enabled) return;
+  {
+    std::lock_guard<std::mutex> lock(g_samplerMutex);
+    g_samplerStop = true;
+  }
+  g_samplerCond.notify_one();
+  g_sampler.join();
+
+  // spans that are still open are closed at the end of the trace
+  for (const auto &buf : g_buffers)
+  {
+    int64_t end = now();
+    while (!buf->openSpans.empty())
+    {
+      OpenSpan &span = buf->openSpans.back();
+      buf->events.push_back({'X',span.category,std::move(span.name),std::move(span.detail),
+                             span.start,end-span.start,0.0});
+      buf->openSpans.pop_back();
+    }
+  }
+  s_enabled = false;
+
+  std::ofstream t(g_fileName,std::ofstream::out | std::ofstream::binary);
+  if (!t.is_open())
+  {
+    err("Could not open file %s for writing\n",g_fileName.c_str());
+    return;
+  }
+  t.precision(12);
+  unsigned int pid = Portable::pid();
+  size_t numEvents = 0;
+  t << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  t << "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":" << pid
+    << ",\"args\":{\"name\":\"doxygen\"}}";
+  for (const auto &buf : g_buffers)
+  {
+    t << ",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << pid << ",\"tid\":" << buf->tid
+      << ",\"args\":{\"name\":";
+    writeString(t,buf->threadName);
+    t << "}}";
+    for (const auto &e : buf->events)
+    {
+      t << ",\n{\"ph\":\"" << e.phase << "\",\"pid\":" << pid << ",\"tid\":" << buf->tid
+        << ",\"ts\":" << e.start;
+      if (e.phase=='X')
+      {
+        t << ",\"dur\":" << e.duration << ",\"cat\":";
+        writeString(t,e.category);
+        t << ",\"name\":";
+        writeString(t,e.name);
+        if (!e.detail.empty())
+        {
+          t << ",\"args\":{\"detail\":";
+          writeString(t,e.detail);
+          t << "}";
+        }
+      }
+      else // counter
+      {
+        t << ",\"name\":";
+        writeString(t,e.category);
+        t << ",\"args\":{";
+        writeString(t,e.name);
+        t << ":" << e.value << "}";
+      }
+      t << "}";
+      numEvents++;
+    }
+  }
+  t << "\n]}\n";
+  msg("Wrote %zu trace events to %s\n",numEvents,g_fileName.c_str());
+  g_buffers.clear();
+}
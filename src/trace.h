@@ -0,0 +1,78 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "qcstring.h"
+
+/** @brief Records where the time of a run is spent.
+ *
+ *  When enabled via the \c -t option, nested spans (the phases of a run, the
+ *  files parsed, the pages written, the external tools run, etc.) are
+ *  recorded per thread, together with samples of the memory in use and
+ *  the counters of the caches. At the end of the run everything is written to
+ *  a file in the trace event format, which can be viewed with Perfetto
+ *  (https://ui.perfetto.dev) or in Chrome via chrome://tracing.
+ *
+ *  The functions can be called from multiple threads at the same time.
+ */
+class Trace
+{
+  public:
+    /** Starts recording, the trace is written to \a fileName by finish() */
+    static void start(const QCString &fileName);
+
+    /** Returns TRUE if a trace is being recorded */
+    static bool isEnabled() { return s_enabled; }
+
+    /** Opens a span \a name of kind \a category on the calling thread.
+     *  The optional \a detail is shown as an argument of the span.
+     */
+    static void begin(const char *category,const QCString &name,const QCString &detail=QCString());
+
+    /** Closes the innermost span of the calling thread if it is of kind \a category */
+    static void end(const char *category);
+
+    /** Records \a value as the current value of \a series of counter \a name */
+    static void counter(const char *name,const char *series,double value);
+
+    /** Stops recording and writes the trace file */
+    static void finish();
+
+  private:
+    static bool s_enabled;
+};
+
+/** @brief Records a span for the lifetime of the object. */
+class TraceSpan
+{
+  public:
+    TraceSpan(const char *category,const QCString &name,const QCString &detail=QCString())
+      : m_category(Trace::isEnabled() ? category : 0)
+    {
+      if (m_category) Trace::begin(m_category,name,detail);
+    }
+   ~TraceSpan()
+    {
+      if (m_category) Trace::end(m_category);
+    }
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+  private:
+    const char *m_category;
+};
+
+#endif
@@ -20,6 +20,7 @@
 #include <limits.h>
 #include <string.h>
 
+#include <map>
 #include <mutex>
 #include <unordered_set>
 #include <codecvt>
@@ -28,6 +29,7 @@
 #include <cctype>
 #include <cinttypes>
 #include <sstream>
+#include <atomic>
 
 #include "md5.h"
 
@@ -51,6 +53,7 @@
 #include "searchindex.h"
 #include "doxygen.h"
 #include "textdocvisitor.h"
+#include "docrootcache.h"
 #include "latexdocvisitor.h"
 #include "portable.h"
 #include "parserintf.h"
@@ -1273,12 +1276,11 @@ QCString tempArgListToString(const ArgumentList &al,SrcLangExt lang,bool include
 
 //----------------------------------------------------------------------------
 
-/*! takes the \a buf of the given length \a len and converts CR LF (DOS)
- * or CR (MAC) line ending to LF (Unix).  Returns the length of the
- * converted content (i.e. the same as \a len (Unix, MAC) or
- * smaller (DOS).
+/*! copies \a len characters from \a src to \a dst while converting CR LF (DOS)
+ * or CR (MAC) line endings to LF (Unix). \a src and \a dst may point to
+ * the same buffer. Returns the number of characters written to \a dst.
  */
-int filterCRLF(char *buf,int len)
+static int copyFilterCRLF(const char *srcBuf,int len,char *dstBuf)
 {
   int src = 0;    // source index
   int dest = 0;   // destination index
@@ -1286,22 +1288,32 @@ int filterCRLF(char *buf,int len)
 
   while (src<len)
   {
-    c = buf[src++];            // Remember the processed character.
+    c = srcBuf[src++];         // Remember the processed character.
     if (c == '\r')             // CR to be solved (MAC, DOS)
     {
       c = '\n';                // each CR to LF
-      if (src<len && buf[src] == '\n')
+      if (src<len && srcBuf[src] == '\n')
         ++src;                 // skip LF just after CR (DOS)
     }
     else if ( c == '\0' && src<len-1) // filter out internal \0 characters, as it will confuse the parser
     {
       c = ' ';                 // turn into a space
     }
-    buf[dest++] = c;           // copy the (modified) character to dest
+    dstBuf[dest++] = c;        // copy the (modified) character to dest
   }
   return dest;                 // length of the valid part of the buf
 }
 
+/*! takes the \a buf of the given length \a len and converts CR LF (DOS)
+ * or CR (MAC) line ending to LF (Unix).  Returns the length of the
+ * converted content (i.e. the same as \a len (Unix, MAC) or
+ * smaller (DOS).
+ */
+int filterCRLF(char *buf,int len)
+{
+  return copyFilterCRLF(buf,len,buf);
+}
+
 static QCString getFilterFromList(const char *name,const StringVector &filterList,bool &found)
 {
   found=FALSE;
@@ -3299,39 +3311,30 @@ void generateFileRef(OutputDocInterface &od,const char *name,const char *text)
 /** Cache element for the file name to FileDef mapping cache. */
 struct FindFileCacheElem
 {
-  FindFileCacheElem(FileDef *fd,bool ambig) : fileDef(fd), isAmbig(ambig) {}
+  FindFileCacheElem(FileDef *fd=0,bool ambig=FALSE) : fileDef(fd), isAmbig(ambig) {}
   FileDef *fileDef;
   bool isAmbig;
 };
 
 static Cache<std::string,FindFileCacheElem> g_findFileDefCache(5000);
 
-static std::mutex g_findFileDefMutex;
-
 FileDef *findFileDef(const FileNameLinkedMap *fnMap,const char *n,bool &ambig)
 {
   ambig=FALSE;
   if (n==0) return 0;
 
-  std::lock_guard<std::mutex> lock(g_findFileDefMutex);
-
   const int maxAddrSize = 20;
   char addr[maxAddrSize];
   qsnprintf(addr,maxAddrSize,"%p:",(void*)fnMap);
   QCString key = addr;
   key+=n;
 
-  FindFileCacheElem *cachedResult = g_findFileDefCache.find(key.str());
-  //printf("key=%s cachedResult=%p\n",key.data(),cachedResult);
-  if (cachedResult)
+  FindFileCacheElem cachedResult;
+  if (g_findFileDefCache.find(key.str(),cachedResult))
   {
-    ambig = cachedResult->isAmbig;
-    //printf("cached: fileDef=%p\n",cachedResult->fileDef);
-    return cachedResult->fileDef;
-  }
-  else
-  {
-    cachedResult = g_findFileDefCache.insert(key.str(),FindFileCacheElem(0,FALSE));
+    ambig = cachedResult.isAmbig;
+    //printf("cached: fileDef=%p\n",cachedResult.fileDef);
+    return cachedResult.fileDef;
   }
 
   QCString name=Dir::cleanDirPath(n);
@@ -3357,7 +3360,8 @@ FileDef *findFileDef(const FileNameLinkedMap *fnMap,const char *n,bool &ambig)
                  fd->getPath().right(path.length()).lower()==path.lower();
       if (path.isEmpty() || isSamePath)
       {
-        cachedResult->fileDef = fd.get();
+        cachedResult.fileDef = fd.get();
+        g_findFileDefCache.insert(key.str(),cachedResult);
         return fd.get();
       }
     }
@@ -3378,8 +3382,9 @@ FileDef *findFileDef(const FileNameLinkedMap *fnMap,const char *n,bool &ambig)
       }
 
       ambig=(count>1);
-      cachedResult->isAmbig = ambig;
-      cachedResult->fileDef = lastMatch;
+      cachedResult.isAmbig = ambig;
+      cachedResult.fileDef = lastMatch;
+      g_findFileDefCache.insert(key.str(),cachedResult);
       return lastMatch;
     }
   }
@@ -3388,7 +3393,7 @@ FileDef *findFileDef(const FileNameLinkedMap *fnMap,const char *n,bool &ambig)
     //printf("not found!\n");
   }
 exit:
-  //delete cachedResult;
+  g_findFileDefCache.insert(key.str(),cachedResult);
   return 0;
 }
 
@@ -5774,13 +5779,12 @@ QCString parseCommentAsText(const Definition *scope,const MemberDef *md,
   if (doc.isEmpty()) return "";
   //printf("parseCommentAsText(%s)\n",doc.data());
   TextStream t;
-  DocNode *root = validatingParseDoc(fileName,lineNr,
-      (Definition*)scope,(MemberDef*)md,doc,FALSE,FALSE,
+  std::shared_ptr<DocRoot> root = DocRootCache::instance().parse(fileName,lineNr,
+      scope,md,doc,FALSE,FALSE,
       0,FALSE,FALSE,Config_getBool(MARKDOWN_SUPPORT));
   TextDocVisitor *visitor = new TextDocVisitor(t);
   root->accept(visitor);
   delete visitor;
-  delete root;
   QCString result = convertCharEntitiesToUTF8(t.str().c_str()).stripWhiteSpace();
   int i=0;
   int charCnt=0;
@@ -6153,11 +6157,10 @@ void stackTrace()
 #endif
 }
 
-static int transcodeCharacterBuffer(const char *fileName,BufStr &srcBuf,int size,
+//! converts \a size bytes at \a src from \a inputEncoding to \a outputEncoding and appends the result to \a dstBuf
+static void transcodeCharacterBuffer(const char *fileName,const char *src,size_t size,BufStr &dstBuf,
            const char *inputEncoding,const char *outputEncoding)
 {
-  if (inputEncoding==0 || outputEncoding==0) return size;
-  if (qstricmp(inputEncoding,outputEncoding)==0) return size;
   void *cd = portable_iconv_open(outputEncoding,inputEncoding);
   if (cd==(void *)(-1))
   {
@@ -6165,19 +6168,16 @@ static int transcodeCharacterBuffer(const char *fileName,BufStr &srcBuf,int size
         "Check the INPUT_ENCODING setting in the config file!\n",
         inputEncoding,outputEncoding,strerror(errno));
   }
-  int tmpBufSize=size*4+1;
-  BufStr tmpBuf(tmpBufSize);
+  uint start = dstBuf.curPos();
+  size_t tmpBufSize=size*4+1;
+  dstBuf.skip((uint)tmpBufSize);
   size_t iLeft=size;
   size_t oLeft=tmpBufSize;
-  char *srcPtr = srcBuf.data();
-  char *dstPtr = tmpBuf.data();
-  uint newSize=0;
+  char *srcPtr = const_cast<char*>(src);
+  char *dstPtr = dstBuf.data()+start;
   if (!portable_iconv(cd, &srcPtr, &iLeft, &dstPtr, &oLeft))
   {
-    newSize = tmpBufSize-(int)oLeft;
-    srcBuf.shrink(newSize);
-    strncpy(srcBuf.data(),tmpBuf.data(),newSize);
-    //printf("iconv: input size=%d output size=%d\n[%s]\n",size,newSize,srcBuf.data());
+    dstBuf.shrink(start+(uint)(tmpBufSize-oLeft));
   }
   else
   {
@@ -6185,35 +6185,76 @@ static int transcodeCharacterBuffer(const char *fileName,BufStr &srcBuf,int size
         fileName,inputEncoding,outputEncoding);
   }
   portable_iconv_close(cd);
-  return newSize;
+}
+
+/*! appends the \a size bytes of file contents at \a data to \a outBuf,
+ *  converted to UTF-8 and with Unix line endings. Files that are UTF-8
+ *  already are copied only once.
+ */
+static void convertInputToUtf8(const char *fileName,const char *data,size_t size,BufStr &outBuf)
+{
+  QCString encoding = Config_getString(INPUT_ENCODING);
+  if (size>=2 &&
+      ((uchar)data[0]==0xFF && (uchar)data[1]==0xFE) // Little endian BOM
+     ) // UCS-2LE encoded file
+  {
+    encoding = "UCS-2LE";
+  }
+  else if (size>=2 &&
+           ((uchar)data[0]==0xFE && (uchar)data[1]==0xFF) // big endian BOM
+         ) // UCS-2BE encoded file
+  {
+    encoding = "UCS-2BE";
+  }
+  else if (size>=3 &&
+           (uchar)data[0]==0xEF &&
+           (uchar)data[1]==0xBB &&
+           (uchar)data[2]==0xBF
+     ) // UTF-8 encoded file
+  {
+    data+=3; // skip UTF-8 BOM: no translation needed
+    size-=3;
+    encoding = "UTF-8";
+  }
+
+  uint start = outBuf.curPos();
+  int len;
+  if (qstricmp(encoding,"UTF-8")!=0) // transcode according to the encoding
+  {
+    transcodeCharacterBuffer(fileName,data,size,outBuf,encoding,"UTF-8");
+    len = outBuf.curPos()-start;
+    // and translate CR's
+    int newLen = filterCRLF(outBuf.data()+start,len);
+    if (newLen!=len) outBuf.shrink(start+newLen);
+  }
+  else // copy and translate CR's in one pass
+  {
+    len = (int)size;
+    outBuf.skip((uint)size);
+    int newLen = copyFilterCRLF(data,len,outBuf.data()+start);
+    if (newLen!=len) outBuf.shrink(start+newLen);
+  }
 }
 
 //! read a file name \a fileName and optionally filter and transcode it
 bool readInputFile(const char *fileName,BufStr &inBuf,bool filter,bool isSourceCode)
 {
   // try to open file
-  int size=0;
-
   FileInfo fi(fileName);
   if (!fi.exists()) return FALSE;
   QCString filterName = getFileFilter(fileName,isSourceCode);
   if (filterName.isEmpty() || !filter)
   {
-    std::ifstream f(fileName,std::ifstream::in | std::ifstream::binary);
-    if (!f.is_open())
+    // map the file into memory, so its contents are copied only once to inBuf
+    size_t size=0;
+    const char *data = Portable::mapFile(fileName,size);
+    if (data==0 && fi.size()>0)
     {
       err("could not open file %s\n",fileName);
       return FALSE;
     }
-    size=(int)fi.size();
-    // read the file
-    inBuf.skip(size);
-    f.read(inBuf.data(),size);
-    if (f.fail())
-    {
-      err("problems while reading file %s\n",fileName);
-      return FALSE;
-    }
+    convertInputToUtf8(fileName,data,size,inBuf);
+    Portable::unmapFile(data,size);
   }
   else
   {
@@ -6225,61 +6266,22 @@ bool readInputFile(const char *fileName,BufStr &inBuf,bool filter,bool isSourceC
       err("could not execute filter %s\n",filterName.data());
       return FALSE;
     }
+    BufStr filterBuf((uint)fi.size()+4096);
     const int bufSize=1024;
     char buf[bufSize];
     int numRead;
     while ((numRead=(int)fread(buf,1,bufSize,f))>0)
     {
       //printf(">>>>>>>>Reading %d bytes\n",numRead);
-      inBuf.addArray(buf,numRead),size+=numRead;
+      filterBuf.addArray(buf,numRead);
     }
     Portable::pclose(f);
-    inBuf.at(inBuf.curPos()) ='\0';
+    filterBuf.at(filterBuf.curPos()) ='\0';
     Debug::print(Debug::FilterOutput, 0, "Filter output\n");
-    Debug::print(Debug::FilterOutput,0,"-------------\n%s\n-------------\n",qPrint(inBuf));
-  }
-
-  int start=0;
-  if (size>=2 &&
-      ((uchar)inBuf.at(0)==0xFF && (uchar)inBuf.at(1)==0xFE) // Little endian BOM
-     ) // UCS-2LE encoded file
-  {
-    transcodeCharacterBuffer(fileName,inBuf,inBuf.curPos(),
-        "UCS-2LE","UTF-8");
-  }
-  else if (size>=2 &&
-           ((uchar)inBuf.at(0)==0xFE && (uchar)inBuf.at(1)==0xFF) // big endian BOM
-         ) // UCS-2BE encoded file
-  {
-    transcodeCharacterBuffer(fileName,inBuf,inBuf.curPos(),
-        "UCS-2BE","UTF-8");
-  }
-  else if (size>=3 &&
-           (uchar)inBuf.at(0)==0xEF &&
-           (uchar)inBuf.at(1)==0xBB &&
-           (uchar)inBuf.at(2)==0xBF
-     ) // UTF-8 encoded file
-  {
-    inBuf.dropFromStart(3); // remove UTF-8 BOM: no translation needed
-  }
-  else // transcode according to the INPUT_ENCODING setting
-  {
-    // do character transcoding if needed.
-    transcodeCharacterBuffer(fileName,inBuf,inBuf.curPos(),
-        Config_getString(INPUT_ENCODING),"UTF-8");
+    Debug::print(Debug::FilterOutput,0,"-------------\n%s\n-------------\n",qPrint(filterBuf));
+    convertInputToUtf8(fileName,filterBuf.data(),filterBuf.curPos(),inBuf);
   }
 
-  //inBuf.addChar('\n'); /* to prevent problems under Windows ? */
-
-  // and translate CR's
-  size=inBuf.curPos()-start;
-  int newSize=filterCRLF(inBuf.data()+start,size);
-  //printf("filter char at %p size=%d newSize=%d\n",dest.data()+oldPos,size,newSize);
-  if (newSize!=size) // we removed chars
-  {
-    inBuf.shrink(newSize); // resize the array
-    //printf(".......resizing from %d to %d result=[%s]\n",oldPos+size,oldPos+newSize,dest.data());
-  }
   inBuf.addChar(0);
   return TRUE;
 }
@@ -6311,46 +6313,107 @@ QCString filterTitle(const std::string &title)
 
 bool patternMatch(const FileInfo &fi,const StringVector &patList)
 {
-  bool caseSenseNames = Config_getBool(CASE_SENSE_NAMES);
-  bool found = FALSE;
+  return PatternMatcher(patList).match(fi);
+}
 
-  // For platforms where the file system is non case sensitive overrule the setting
-  if (!Portable::fileSystemIsCaseSensitive())
+struct PatternMatcher::Private
+{
+  bool matchName(const std::string &name) const
   {
-    caseSenseNames = FALSE;
+    if (literals.find(name)!=literals.end()) return true;
+    for (const auto &kv : suffixes)
+    {
+      if (name.size()>=kv.first &&
+          kv.second.find(name.substr(name.size()-kv.first))!=kv.second.end()) return true;
+    }
+    for (const auto &prefix : prefixes)
+    {
+      if (name.compare(0,prefix.size(),prefix)==0) return true;
+    }
+    for (const auto &infix : infixes)
+    {
+      if (name.find(infix)!=std::string::npos) return true;
+    }
+    for (const auto &re : regExs)
+    {
+      if (reg::match(name,*re)) return true;
+    }
+    return false;
   }
 
-  if (!patList.empty())
-  {
-    std::string fn = fi.fileName();
-    std::string fp = fi.filePath();
-    std::string afp= fi.absFilePath();
+  bool empty = true;
+  bool caseSenseNames = true;
+  std::unordered_set<std::string> literals;                          // foo.h
+  std::map<size_t,std::unordered_set<std::string> > suffixes;        // *.cpp, grouped by length
+  std::vector<std::string> prefixes;                                 // foo*
+  std::vector<std::string> infixes;                                  // *test*
+  std::vector< std::unique_ptr<reg::Ex> > regExs;                    // anything else
+};
 
-    for (auto pattern: patList)
-    {
-      if (!pattern.empty())
-      {
-        size_t i=pattern.find('=');
-        if (i!=std::string::npos) pattern=pattern.substr(0,i); // strip of the extension specific filter name
+PatternMatcher::PatternMatcher(const StringVector &patList) : p(std::make_unique<Private>())
+{
+  // For platforms where the file system is non case sensitive overrule the setting
+  p->caseSenseNames = Config_getBool(CASE_SENSE_NAMES) && Portable::fileSystemIsCaseSensitive();
 
-        if (!caseSenseNames)
-        {
-          pattern = QCString(pattern).lower().str();
-          fn      = QCString(fn).lower().str();
-          fp      = QCString(fp).lower().str();
-          afp     = QCString(afp).lower().str();
-        }
-        reg::Ex re(pattern,reg::Ex::Mode::Wildcard);
-        found = re.isValid() && (reg::match(fn,re) ||
-                                 (fn!=fp && reg::match(fp,re)) ||
-                                 (fn!=afp && fp!=afp && reg::match(afp,re)));
-        if (found) break;
-        //printf("Matching '%s' against pattern '%s' found=%d\n",
-        //    fi->fileName().data(),pattern.data(),found);
-      }
+  auto isLiteral = [](const std::string &s) { return s.find_first_of("*?[")==std::string::npos; };
+  for (auto pattern: patList)
+  {
+    size_t i=pattern.find('=');
+    if (i!=std::string::npos) pattern=pattern.substr(0,i); // strip of the extension specific filter name
+    if (pattern.empty()) continue;
+    if (!p->caseSenseNames)
+    {
+      pattern = QCString(pattern).lower().str();
+    }
+    size_t len = pattern.length();
+    if (isLiteral(pattern))
+    {
+      p->literals.insert(pattern);
+    }
+    else if (pattern[0]=='*' && isLiteral(pattern.substr(1)))
+    {
+      p->suffixes[len-1].insert(pattern.substr(1));
+    }
+    else if (len>1 && pattern[len-1]=='*' && isLiteral(pattern.substr(0,len-1)))
+    {
+      p->prefixes.push_back(pattern.substr(0,len-1));
+    }
+    else if (len>2 && pattern[0]=='*' && pattern[len-1]=='*' && isLiteral(pattern.substr(1,len-2)))
+    {
+      p->infixes.push_back(pattern.substr(1,len-2));
     }
+    else
+    {
+      auto re = std::make_unique<reg::Ex>(pattern,reg::Ex::Mode::Wildcard);
+      if (!re->isValid()) continue;
+      p->regExs.push_back(std::move(re));
+    }
+    p->empty = false;
   }
-  return found;
+}
+
+PatternMatcher::~PatternMatcher()
+{
+}
+
+bool PatternMatcher::match(const FileInfo &fi) const
+{
+  if (p->empty) return false;
+  return match(fi.fileName(),fi.filePath(),fi.absFilePath());
+}
+
+bool PatternMatcher::match(std::string fn,std::string fp,std::string afp) const
+{
+  if (p->empty) return false;
+  if (!p->caseSenseNames)
+  {
+    fn  = QCString(fn).lower().str();
+    fp  = QCString(fp).lower().str();
+    afp = QCString(afp).lower().str();
+  }
+  return p->matchName(fn) ||
+         (fn!=fp && p->matchName(fp)) ||
+         (fn!=afp && fp!=afp && p->matchName(afp));
 }
 
 QCString externalLinkTarget(const bool parent)
@@ -7457,3 +7520,11 @@ std::string join(const StringVector &sv,const std::string &delimiter)
   return result;
 }
 
+
+/// returns the name of a temporary file next to \a fileName that is unique
+/// for this process, so runs sharing a directory do not overwrite each other's files
+std::string tempFileName(const std::string &fileName)
+{
+  static std::atomic_int count { 0 };
+  return fileName+".tmp"+std::to_string(Portable::pid())+"_"+std::to_string(count++);
+}
@@ -401,6 +401,32 @@ QCString filterTitle(const std::string &title);
 
 bool patternMatch(const FileInfo &fi,const StringVector &patList);
 
+/** @brief Matches file names against a list of wildcard patterns, such as
+ *  the ones in \c FILE_PATTERNS and \c EXCLUDE_PATTERNS.
+ *
+ *  The patterns are analysed once. Patterns like `*.cpp`, `*test*`, `foo*`
+ *  or `foo.h` are checked with a simple string comparison, the other patterns
+ *  are compiled into a regular expression.
+ */
+class PatternMatcher
+{
+  public:
+    PatternMatcher(const StringVector &patList);
+   ~PatternMatcher();
+
+    /** Returns TRUE if the name or path of \a fi matches one of the patterns */
+    bool match(const FileInfo &fi) const;
+
+    /** Returns TRUE if the file name \a fn, its path \a fp, or its absolute path
+     *  \a afp matches one of the patterns.
+     */
+    bool match(std::string fn,std::string fp,std::string afp) const;
+
+  private:
+    struct Private;
+    std::unique_ptr<Private> p;
+};
+
 QCString externalLinkTarget(const bool parent = false);
 QCString externalRef(const QCString &relPath,const QCString &ref,bool href);
 int nextUtf8CharPosition(const QCString &utf8Str,uint len,uint startPos);
@@ -463,4 +489,6 @@ std::string join(const StringVector &s,const std::string &delimiter);
 bool recognizeFixedForm(const char* contents, FortranFormat format);
 FortranFormat convertFileNameFortranParserCode(QCString fn);
 
+std::string tempFileName(const std::string &fileName);
+
 #endif
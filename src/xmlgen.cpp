@@ -32,6 +32,8 @@
 #include "version.h"
 #include "xmldocvisitor.h"
 #include "docparser.h"
+#include "coderecorder.h"
+#include "docrootcache.h"
 #include "language.h"
 #include "parserintf.h"
 #include "arguments.h"
@@ -160,7 +162,7 @@ static void writeCombineScript()
 {
   QCString outputDirectory = Config_getString(XML_OUTPUT);
   QCString fileName=outputDirectory+"/combine.xslt";
-  std::ofstream t(fileName.str(),std::ofstream::out | std::ofstream::binary);
+  OutputFileStream t(fileName.str());
   if (!t.is_open())
   {
     err("Cannot open file %s for writing!\n",fileName.data());
@@ -416,7 +418,7 @@ static void writeXMLDocBlock(TextStream &t,
   QCString stext = text.stripWhiteSpace();
   if (stext.isEmpty()) return;
   // convert the documentation string into an abstract syntax tree
-  DocNode *root = validatingParseDoc(fileName,lineNr,scope,md,text,FALSE,FALSE,
+  std::shared_ptr<DocRoot> root = DocRootCache::instance().parse(fileName,lineNr,scope,md,text,FALSE,FALSE,
                                      0,FALSE,FALSE,Config_getBool(MARKDOWN_SUPPORT));
   // create a code generator
   XMLCodeGenerator *xmlCodeGen = new XMLCodeGenerator(t);
@@ -427,7 +429,6 @@ static void writeXMLDocBlock(TextStream &t,
   // clean up
   delete visitor;
   delete xmlCodeGen;
-  delete root;
 
 }
 
@@ -438,19 +439,24 @@ void writeXMLCodeBlock(TextStream &t,FileDef *fd)
   intf->resetCodeParserState();
   XMLCodeGenerator *xmlGen = new XMLCodeGenerator(t);
   xmlGen->startCodeFragment("DoxyCode");
-  intf->parseCode(*xmlGen,    // codeOutIntf
-                0,           // scopeName
-                fileToString(fd->absFilePath(),Config_getBool(FILTER_SOURCE_FILES)),
-                langExt,     // lang
-                FALSE,       // isExampleBlock
-                0,           // exampleName
-                fd,          // fileDef
-                -1,          // startLine
-                -1,          // endLine
-                FALSE,       // inlineFragment
-                0,           // memberDef
-                TRUE         // showLineNumbers
-                );
+  QCString text = fileToString(fd->absFilePath(),Config_getBool(FILTER_SOURCE_FILES));
+  // reuse the output of the code parser recorded while writing the sources if possible
+  if (!CodeRecordingCache::instance().replay(fd,text,*xmlGen))
+  {
+    intf->parseCode(*xmlGen,    // codeOutIntf
+                  0,           // scopeName
+                  text,        // input
+                  langExt,     // lang
+                  FALSE,       // isExampleBlock
+                  0,           // exampleName
+                  fd,          // fileDef
+                  -1,          // startLine
+                  -1,          // endLine
+                  FALSE,       // inlineFragment
+                  0,           // memberDef
+                  TRUE         // showLineNumbers
+                  );
+  }
   xmlGen->endCodeFragment("DoxyCode");
   xmlGen->finish();
   delete xmlGen;
@@ -1255,7 +1261,7 @@ static void generateXMLForClass(const ClassDef *cd,TextStream &ti)
 
   QCString outputDirectory = Config_getString(XML_OUTPUT);
   QCString fileName=outputDirectory+"/"+ classOutputFileBase(cd)+".xml";
-  std::ofstream f(fileName.str(),std::ofstream::out | std::ofstream::binary);
+  OutputFileStream f(fileName.str());
   if (!f.is_open())
   {
     err("Cannot open file %s for writing!\n",fileName.data());
@@ -1419,7 +1425,7 @@ static void generateXMLForConcept(const ConceptDef *cd,TextStream &ti)
 
   QCString outputDirectory = Config_getString(XML_OUTPUT);
   QCString fileName=outputDirectory+"/"+cd->getOutputFileBase()+".xml";
-  std::ofstream f(fileName.str(),std::ofstream::out | std::ofstream::binary);
+  OutputFileStream f(fileName.str());
   if (!f.is_open())
   {
     err("Cannot open file %s for writing!\n",fileName.data());
@@ -1472,7 +1478,7 @@ static void generateXMLForNamespace(const NamespaceDef *nd,TextStream &ti)
 
   QCString outputDirectory = Config_getString(XML_OUTPUT);
   QCString fileName=outputDirectory+"/"+nd->getOutputFileBase()+".xml";
-  std::ofstream f(fileName.str(),std::ofstream::out | std::ofstream::binary);
+  OutputFileStream f(fileName.str());
   if (!f.is_open())
   {
     err("Cannot open file %s for writing!\n",fileName.data());
@@ -1547,7 +1553,7 @@ static void generateXMLForFile(FileDef *fd,TextStream &ti)
 
   QCString outputDirectory = Config_getString(XML_OUTPUT);
   QCString fileName=outputDirectory+"/"+fd->getOutputFileBase()+".xml";
-  std::ofstream f(fileName.str(),std::ofstream::out | std::ofstream::binary);
+  OutputFileStream f(fileName.str());
   if (!f.is_open())
   {
     err("Cannot open file %s for writing!\n",fileName.data());
@@ -1658,7 +1664,7 @@ static void generateXMLForGroup(const GroupDef *gd,TextStream &ti)
 
   QCString outputDirectory = Config_getString(XML_OUTPUT);
   QCString fileName=outputDirectory+"/"+gd->getOutputFileBase()+".xml";
-  std::ofstream f(fileName.str(),std::ofstream::out | std::ofstream::binary);
+  OutputFileStream f(fileName.str());
   if (!f.is_open())
   {
     err("Cannot open file %s for writing!\n",fileName.data());
@@ -1713,7 +1719,7 @@ static void generateXMLForDir(DirDef *dd,TextStream &ti)
 
   QCString outputDirectory = Config_getString(XML_OUTPUT);
   QCString fileName=outputDirectory+"/"+dd->getOutputFileBase()+".xml";
-  std::ofstream f(fileName.str(),std::ofstream::out | std::ofstream::binary);
+  OutputFileStream f(fileName.str());
   if (!f.is_open())
   {
     err("Cannot open file %s for writing!\n",fileName.data());
@@ -1766,7 +1772,7 @@ static void generateXMLForPage(PageDef *pd,TextStream &ti,bool isExample)
 
   QCString outputDirectory = Config_getString(XML_OUTPUT);
   QCString fileName=outputDirectory+"/"+pageName+".xml";
-  std::ofstream f(fileName.str(),std::ofstream::out | std::ofstream::binary);
+  OutputFileStream f(fileName.str());
   if (!f.is_open())
   {
     err("Cannot open file %s for writing!\n",fileName.data());
@@ -1898,7 +1904,7 @@ void generateXML()
   ResourceMgr::instance().copyResource("index.xsd",outputDirectory);
 
   QCString fileName=outputDirectory+"/compound.xsd";
-  std::ofstream f(fileName.str(),std::ofstream::out | std::ofstream::binary);
+  OutputFileStream f(fileName.str());
   if (!f.is_open())
   {
     err("Cannot open file %s for writing!\n",fileName.data());
@@ -1936,7 +1942,7 @@ void generateXML()
   f.close();
 
   fileName=outputDirectory+"/index.xml";
-  f.open(fileName.str(),std::ofstream::out | std::ofstream::binary);
+  f.open(fileName.str());
   if (!f.is_open())
   {
     err("Cannot open file %s for writing!\n",fileName.data());
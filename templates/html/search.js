@@ -346,7 +346,13 @@ function SearchBox(name, resultsPath, inFrame, label, extension)
     var hasResultsPage;
 
     var idx = indexSectionsWithContent[this.searchIndex].indexOf(idxChar);
-    if (idx!=-1)
+    if (idx!=-1 && typeof indexSectionsSharded!='undefined') // one page per index loading the matching shards
+    {
+       resultsPage = this.resultsPath + '/' + indexSectionNames[this.searchIndex] + '_shards' + this.extension;
+       resultsPageWithSearch = resultsPage+'?'+escape(searchValue);
+       hasResultsPage = true;
+    }
+    else if (idx!=-1)
     {
        var hexCode=idx.toString(16);
        resultsPage = this.resultsPath + '/' + indexSectionNames[this.searchIndex] + '_' + hexCode + this.extension;
@@ -486,12 +492,9 @@ function SearchResults(name)
       }
     }
 
-    // Searches for the passed string.  If there is no parameter,
-    // it takes it from the URL query.
-    //
-    // Always returns true, since other documents may try to call it
-    // and that may or may not be possible.
-    this.Search = function(search)
+    // Returns the passed string, or the URL query if there is no parameter,
+    // in the form used for the ids of the results.
+    this.SearchId = function(search)
     {
       if (!search) // get search word from URL
       {
@@ -503,7 +506,17 @@ function SearchResults(name)
       search = search.replace(/^ +/, ""); // strip leading spaces
       search = search.replace(/ +$/, ""); // strip trailing spaces
       search = search.toLowerCase();
-      search = convertToId(search);
+      return convertToId(search);
+    }
+
+    // Searches for the passed string.  If there is no parameter,
+    // it takes it from the URL query.
+    //
+    // Always returns true, since other documents may try to call it
+    // and that may or may not be possible.
+    this.Search = function(search)
+    {
+      search = this.SearchId(search);
 
       var resultRows = document.getElementsByTagName("div");
       var matches = 0;
@@ -543,6 +556,107 @@ function SearchResults(name)
       return true;
     }
 
+    // The number of results shown before loading more shards waits for the user.
+    this.shardPageSize = 500;
+    this.maxShardResults = this.shardPageSize;
+
+    // Searches for the string in the URL query in a sharded index. Only the
+    // shards whose key is a prefix of the search string, or starts with it,
+    // can contain matches. These are loaded one after the other via
+    // searchShard(), which adds the matching terms to the results.
+    this.SearchShards = function(shardKeys,baseName)
+    {
+      var search = this.SearchId();
+      this.shardBaseName = baseName;
+      this.shardSearch = search;
+      this.shardQueue = [];
+      this.lastMatchCount = 0;
+      this.lastTerm = null;
+      for (var i=0; i<shardKeys.length; i++)
+      {
+        var key = shardKeys[i];
+        if (key.substr(0,search.length)==search || search.substr(0,key.length)==key)
+        {
+          this.shardQueue.push(i);
+        }
+      }
+      shardResults = this;
+      this.LoadNextShard();
+      return true;
+    }
+
+    this.LoadNextShard = function()
+    {
+      var more = document.getElementById('SRMore');
+      if (more) more.parentNode.removeChild(more);
+      if (this.shardQueue.length==0) // all shards loaded
+      {
+        document.getElementById("Loading").style.display='none';
+        document.getElementById("Searching").style.display='none';
+        document.getElementById("NoMatches").style.display=this.lastMatchCount==0 ? 'block' : 'none';
+      }
+      else if (this.lastMatchCount>=this.maxShardResults) // let the user ask for more
+      {
+        document.getElementById("Loading").style.display='none';
+        document.getElementById("Searching").style.display='none';
+        this.maxShardResults = this.lastMatchCount + this.shardPageSize;
+        var srMore = document.createElement('div');
+        srMore.setAttribute('id','SRMore');
+        setClassAttr(srMore,'SREntry');
+        var srLink = document.createElement('a');
+        setClassAttr(srLink,'SRScope');
+        srLink.setAttribute('href','javascript:searchResults.LoadNextShard()');
+        srLink.innerHTML = '&#8230;';
+        srMore.appendChild(srLink);
+        document.getElementById("SRResults").appendChild(srMore);
+      }
+      else
+      {
+        var script = document.createElement('script');
+        script.type = 'text/javascript';
+        script.src = this.shardBaseName+'_s'+this.shardQueue.shift().toString(16)+'.js';
+        script.onerror = function() { shardResults.LoadNextShard(); }
+        document.getElementsByTagName('head')[0].appendChild(script);
+      }
+    }
+
+    // Adds the terms of a shard that match the search string to the results
+    this.AddShard = function(files,scopes,terms)
+    {
+      var results = document.getElementById("SRResults");
+      var search = this.shardSearch;
+      for (var t=0; t<terms.length; t++)
+      {
+        var term = terms[t];
+        if (term[0].substr(0,search.length)==search)
+        {
+          var links = [];
+          for (var l=2; l<term.length; l+=4)
+          {
+            var url = files[term[l]];
+            if (term[l+1]) url += '#'+term[l+1];
+            links.push([url,term[l+2],scopes[term[l+3]]]);
+          }
+          var e;
+          var last = this.lastTerm;
+          if (last && last.id==term[0] && last.name==term[1]) // the term continues from the previous shard
+          {
+            results.removeChild(last.result);
+            links = last.links.concat(links);
+            e = last.e;
+          }
+          else
+          {
+            e = this.lastMatchCount++;
+          }
+          var srResult = createResult(results,e,term[0]+'_'+e,term[1],links);
+          srResult.style.display = 'block';
+          this.lastTerm = { id: term[0], name: term[1], links: links, result: srResult, e: e };
+        }
+      }
+      this.LoadNextShard();
+    }
+
     // return the first item with index index or higher that is visible
     this.NavNext = function(index)
     {
@@ -744,61 +858,77 @@ function setClassAttr(elem,attr)
   elem.setAttribute('className',attr);
 }
 
+// Adds result e with the given id, name and links to results.
+// Each link is an array with the url, 1 for target="_parent", and the scope.
+function createResult(results,e,id,name,links)
+{
+  var srResult = document.createElement('div');
+  srResult.setAttribute('id','SR_'+id);
+  setClassAttr(srResult,'SRResult');
+  var srEntry = document.createElement('div');
+  setClassAttr(srEntry,'SREntry');
+  var srLink = document.createElement('a');
+  srLink.setAttribute('id','Item'+e);
+  setKeyActions(srLink,'return searchResults.Nav(event,'+e+')');
+  setClassAttr(srLink,'SRSymbol');
+  srLink.innerHTML = name;
+  srEntry.appendChild(srLink);
+  if (links.length==1) // single result
+  {
+    srLink.setAttribute('href',links[0][0]);
+    if (links[0][1])
+    {
+     srLink.setAttribute('target','_parent');
+    }
+    var srScope = document.createElement('span');
+    setClassAttr(srScope,'SRScope');
+    srScope.innerHTML = links[0][2];
+    srEntry.appendChild(srScope);
+  }
+  else // multiple results
+  {
+    srLink.setAttribute('href','javascript:searchResults.Toggle("SR_'+id+'")');
+    var srChildren = document.createElement('div');
+    setClassAttr(srChildren,'SRChildren');
+    for (var c=0; c<links.length; c++)
+    {
+      var srChild = document.createElement('a');
+      srChild.setAttribute('id','Item'+e+'_c'+c);
+      setKeyActions(srChild,'return searchResults.NavChild(event,'+e+','+c+')');
+      setClassAttr(srChild,'SRScope');
+      srChild.setAttribute('href',links[c][0]);
+      if (links[c][1])
+      {
+       srChild.setAttribute('target','_parent');
+      }
+      srChild.innerHTML = links[c][2];
+      srChildren.appendChild(srChild);
+    }
+    srEntry.appendChild(srChildren);
+  }
+  srResult.appendChild(srEntry);
+  results.appendChild(srResult);
+  return srResult;
+}
+
 function createResults()
 {
   var results = document.getElementById("SRResults");
   for (var e=0; e<searchData.length; e++)
   {
-    var id = searchData[e][0];
-    var srResult = document.createElement('div');
-    srResult.setAttribute('id','SR_'+id);
-    setClassAttr(srResult,'SRResult');
-    var srEntry = document.createElement('div');
-    setClassAttr(srEntry,'SREntry');
-    var srLink = document.createElement('a');
-    srLink.setAttribute('id','Item'+e);
-    setKeyActions(srLink,'return searchResults.Nav(event,'+e+')');
-    setClassAttr(srLink,'SRSymbol');
-    srLink.innerHTML = searchData[e][1][0];
-    srEntry.appendChild(srLink);
-    if (searchData[e][1].length==2) // single result
-    {
-      srLink.setAttribute('href',searchData[e][1][1][0]);
-      if (searchData[e][1][1][1])
-      {
-       srLink.setAttribute('target','_parent');
-      }
-      var srScope = document.createElement('span');
-      setClassAttr(srScope,'SRScope');
-      srScope.innerHTML = searchData[e][1][1][2];
-      srEntry.appendChild(srScope);
-    }
-    else // multiple results
-    {
-      srLink.setAttribute('href','javascript:searchResults.Toggle("SR_'+id+'")');
-      var srChildren = document.createElement('div');
-      setClassAttr(srChildren,'SRChildren');
-      for (var c=0; c<searchData[e][1].length-1; c++)
-      {
-        var srChild = document.createElement('a');
-        srChild.setAttribute('id','Item'+e+'_c'+c);
-        setKeyActions(srChild,'return searchResults.NavChild(event,'+e+','+c+')');
-        setClassAttr(srChild,'SRScope');
-        srChild.setAttribute('href',searchData[e][1][c+1][0]);
-        if (searchData[e][1][c+1][1])
-        {
-         srChild.setAttribute('target','_parent');
-        }
-        srChild.innerHTML = searchData[e][1][c+1][2];
-        srChildren.appendChild(srChild);
-      }
-      srEntry.appendChild(srChildren);
-    }
-    srResult.appendChild(srEntry);
-    results.appendChild(srResult);
+    createResult(results,e,searchData[e][0],searchData[e][1][0],searchData[e][1].slice(1));
   }
 }
 
+// The results object that receives the shards of a sharded index.
+var shardResults = null;
+
+// Called by the file of a shard once it is loaded.
+function searchShard(files,scopes,terms)
+{
+  if (shardResults) shardResults.AddShard(files,scopes,terms);
+}
+
 function init_search()
 {
   var results = document.getElementById("MSearchSelectWindow");
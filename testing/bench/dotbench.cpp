@@ -0,0 +1,219 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+/** @file
+ *  Compares rendering graphs by starting the dot executable per graph with
+ *  rendering them through the Graphviz libraries, as DotRunner does when doxygen
+ *  is built with use_libgvc. The graphs are generated to look like class graphs
+ *  and rendered to a png image and a client side image map. The modes are:
+ *  - process:   every graph is rendered by a dot process (the default build)
+ *  - libgvc:    every graph is rendered in-process, one at a time
+ *  - mixed:     a thread renders in-process if the libraries are free and
+ *               starts a dot process otherwise (DotRunner::renderInProcess())
+ *  Each mode is run with one thread and with the given number of threads,
+ *  and all outputs must have been written.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include <gvc.h>
+
+static std::mutex g_gvcMutex;
+static GVC_t     *g_gvc = 0;
+
+static std::string g_dotExe = "dot";
+static std::string g_outDir = "dotbench_output";
+
+enum class Mode { Process, Libgvc, Mixed };
+
+static const char *modeName(Mode mode)
+{
+  switch (mode)
+  {
+    case Mode::Process: return "process";
+    case Mode::Libgvc:  return "libgvc";
+    case Mode::Mixed:   return "mixed";
+  }
+  return "";
+}
+
+// writes a graph like the inheritance and collaboration graphs doxygen generates
+static std::string writeGraph(int index)
+{
+  std::string base = g_outDir+"/graph"+std::to_string(index);
+  std::ofstream t(base+".dot",std::ofstream::out | std::ofstream::binary);
+  t << "digraph \"Class" << index << "\"\n{\n";
+  t << " bgcolor=\"transparent\";\n";
+  t << " edge [fontname=\"Helvetica\",fontsize=\"10\",labelfontname=\"Helvetica\",labelfontsize=\"10\"];\n";
+  t << " node [fontname=\"Helvetica\",fontsize=\"10\",shape=record];\n";
+  int numNodes = 4+index%20;
+  for (int n=0;n<numNodes;n++)
+  {
+    t << " Node" << n << " [label=\"Class" << index << "_" << n << "\\n|+ member" << n
+      << "()\\l\",height=0.2,width=0.4,color=\"black\",fillcolor=\"white\",style=\"filled\","
+      << "URL=\"class" << index << "_" << n << ".html\"];\n";
+  }
+  for (int n=1;n<numNodes;n++)
+  {
+    t << " Node" << (n-1)/2 << " -> Node" << n << " [dir=\"back\",color=\"midnightblue\",style=\"solid\"];\n";
+    if (n%5==0)
+    {
+      t << " Node" << n << " -> Node" << n/3 << " [dir=\"back\",color=\"darkorchid3\",style=\"dashed\",label=\" m_ref" << n << "\"];\n";
+    }
+  }
+  t << "}\n";
+  return base;
+}
+
+static bool renderProcess(const std::string &base)
+{
+  std::string cmd = "\""+g_dotExe+"\" \""+base+".dot\" -Tpng -o \""+base+".png\" -Tcmapx -o \""+base+".map\"";
+  return std::system(cmd.c_str())==0;
+}
+
+static bool renderLibgvc(const std::string &base)
+{
+  if (g_gvc==0)
+  {
+    g_gvc = gvContext();
+    if (g_gvc==0) return false;
+  }
+  FILE *f = fopen((base+".dot").c_str(),"r");
+  if (f==0) return false;
+  Agraph_t *g = agread(f,0);
+  fclose(f);
+  if (g==0) return false;
+  bool ok = gvLayout(g_gvc,g,"dot")==0 &&
+            gvRenderFilename(g_gvc,g,"png",(base+".png").c_str())==0 &&
+            gvRenderFilename(g_gvc,g,"cmapx",(base+".map").c_str())==0;
+  gvFreeLayout(g_gvc,g);
+  agclose(g);
+  return ok;
+}
+
+static bool render(Mode mode,const std::string &base,std::atomic<int> &inProcess)
+{
+  switch (mode)
+  {
+    case Mode::Process:
+      return renderProcess(base);
+    case Mode::Libgvc:
+      {
+        std::lock_guard<std::mutex> lock(g_gvcMutex);
+        inProcess++;
+        return renderLibgvc(base);
+      }
+    case Mode::Mixed:
+      {
+        std::unique_lock<std::mutex> lock(g_gvcMutex,std::try_to_lock);
+        if (lock.owns_lock())
+        {
+          inProcess++;
+          return renderLibgvc(base);
+        }
+      }
+      return renderProcess(base);
+  }
+  return false;
+}
+
+static bool outputsWritten(const std::vector<std::string> &bases)
+{
+  for (const auto &base : bases)
+  {
+    for (const char *ext : { ".png", ".map" })
+    {
+      struct stat st;
+      if (stat((base+ext).c_str(),&st)!=0 || st.st_size==0) return false;
+    }
+  }
+  return true;
+}
+
+static bool run(Mode mode,const std::vector<std::string> &bases,size_t numThreads)
+{
+  for (const auto &base : bases)
+  {
+    remove((base+".png").c_str());
+    remove((base+".map").c_str());
+  }
+  std::atomic<size_t> next(0);
+  std::atomic<int> failed(0);
+  std::atomic<int> inProcess(0);
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (size_t i=0;i<numThreads;i++)
+  {
+    threads.emplace_back([&]()
+    {
+      size_t j;
+      while ((j=next++)<bases.size())
+      {
+        if (!render(mode,bases[j],inProcess)) failed++;
+      }
+    });
+  }
+  for (auto &t : threads) t.join();
+  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now()-start).count();
+  printf("%-8s %3zu threads: %7lld ms, %5d of %zu graphs in-process\n",
+         modeName(mode),numThreads,static_cast<long long>(ms),inProcess.load(),bases.size());
+  if (failed>0 || !outputsWritten(bases))
+  {
+    printf("Error: %d graphs could not be rendered in mode %s\n",failed.load(),modeName(mode));
+    return false;
+  }
+  return true;
+}
+
+int main(int argc,char **argv)
+{
+  int numGraphs = argc>1 ? atoi(argv[1]) : 200;
+  size_t numThreads = argc>2 ? static_cast<size_t>(atoi(argv[2])) : std::thread::hardware_concurrency();
+  if (argc>3) g_dotExe = argv[3];
+  if (numGraphs<=0 || numThreads==0)
+  {
+    printf("usage: %s [numGraphs [numThreads [dot executable]]]\n",argv[0]);
+    return 1;
+  }
+
+  mkdir(g_outDir.c_str(),0755);
+  std::vector<std::string> bases;
+  for (int i=0;i<numGraphs;i++)
+  {
+    bases.push_back(writeGraph(i));
+  }
+
+  bool ok = true;
+  for (size_t threads : { static_cast<size_t>(1), numThreads })
+  {
+    for (Mode mode : { Mode::Process, Mode::Libgvc, Mode::Mixed })
+    {
+      ok = run(mode,bases,threads) && ok;
+    }
+    if (numThreads==1) break;
+  }
+  if (g_gvc) gvFreeContext(g_gvc);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+/** @file
+ *  Compares PatternMatcher against the way FILE_PATTERNS were matched before,
+ *  i.e. one wildcard regular expression compiled per pattern for each file.
+ *  Both are run over a synthetic list of paths and must give the same result.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "config.h"
+#include "containers.h"
+#include "qcstring.h"
+#include "regex.h"
+#include "util.h"
+
+struct Path
+{
+  std::string fn;
+  std::string fp;
+  std::string afp;
+};
+
+// FILE_PATTERNS default list plus some typical EXCLUDE_PATTERNS, 40 in total
+static const StringVector g_patterns =
+{
+  "*.c", "*.cc", "*.cxx", "*.cpp", "*.c++", "*.java", "*.ii", "*.ixx", "*.ipp", "*.i++",
+  "*.inl", "*.idl", "*.ddl", "*.odl", "*.h", "*.hh", "*.hxx", "*.hpp", "*.h++", "*.cs",
+  "*.d", "*.php", "*.inc", "*.m", "*.markdown", "*.md", "*.mm", "*.dox", "*.py", "*.f90",
+  "*.vhd=VHDL", "Makefile", "moc_*", "*_p.h", "*/test/*", "*internal*", "*/.git/*",
+  "[Tt]est*.c", "*.tar.?z", "*~"
+};
+
+static std::vector<Path> makePaths(size_t count)
+{
+  static const char *dirs[] = { "src", "include", "lib/core", "lib/Net", "test", "tools/gen", "doc", ".git/objects" };
+  static const char *bases[] = { "main", "Parser", "moc_window", "util_p", "TestCase", "internal_api", "Makefile", "README" };
+  static const char *exts[] = { ".cpp", ".H", ".txt", ".py", ".c", ".tar.gz", ".json", "", ".md~", ".xml" };
+  std::vector<Path> paths;
+  paths.reserve(count);
+  for (size_t i=0;i<count;i++)
+  {
+    std::string dir  = std::string("/home/user/project/module")+std::to_string(i%37)+"/"+dirs[i%8];
+    std::string name = std::string(bases[(i/8)%8])+std::to_string(i%13)+exts[(i/3)%10];
+    if (bases[(i/8)%8][0]=='M' && i%2==0) name="Makefile";
+    paths.push_back({ name, dir+"/"+name, dir+"/"+name });
+  }
+  return paths;
+}
+
+// the way patternMatch() worked before PatternMatcher existed
+static bool oldPatternMatch(std::string fn,std::string fp,std::string afp,const StringVector &patList,bool caseSenseNames)
+{
+  for (auto pattern: patList)
+  {
+    if (!pattern.empty())
+    {
+      size_t i=pattern.find('=');
+      if (i!=std::string::npos) pattern=pattern.substr(0,i); // strip of the extension specific filter name
+
+      if (!caseSenseNames)
+      {
+        pattern = QCString(pattern).lower().str();
+        fn      = QCString(fn).lower().str();
+        fp      = QCString(fp).lower().str();
+        afp     = QCString(afp).lower().str();
+      }
+      reg::Ex re(pattern,reg::Ex::Mode::Wildcard);
+      if (re.isValid() && (reg::match(fn,re) ||
+                           (fn!=fp && reg::match(fp,re)) ||
+                           (fn!=afp && fp!=afp && reg::match(afp,re)))) return true;
+    }
+  }
+  return false;
+}
+
+static double elapsed(std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now()-start).count();
+}
+
+static bool runBench(const std::vector<Path> &paths,bool caseSenseNames)
+{
+  Config_updateBool(CASE_SENSE_NAMES,caseSenseNames);
+
+  std::vector<char> oldResult(paths.size());
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i=0;i<paths.size();i++)
+  {
+    oldResult[i] = oldPatternMatch(paths[i].fn,paths[i].fp,paths[i].afp,g_patterns,caseSenseNames);
+  }
+  double oldTime = elapsed(start);
+
+  std::vector<char> newResult(paths.size());
+  start = std::chrono::steady_clock::now();
+  PatternMatcher matcher(g_patterns);
+  for (size_t i=0;i<paths.size();i++)
+  {
+    newResult[i] = matcher.match(paths[i].fn,paths[i].fp,paths[i].afp);
+  }
+  double newTime = elapsed(start);
+
+  size_t matches=0, diffs=0;
+  for (size_t i=0;i<paths.size();i++)
+  {
+    if (newResult[i]) matches++;
+    if (oldResult[i]!=newResult[i])
+    {
+      if (diffs<10) fprintf(stderr,"mismatch for %s: old=%d new=%d\n",
+                            paths[i].afp.c_str(),oldResult[i],newResult[i]);
+      diffs++;
+    }
+  }
+  printf("%zu paths, %zu patterns, CASE_SENSE_NAMES=%s: %zu matches, old %.1f ms, new %.1f ms (%.1fx)\n",
+         paths.size(),g_patterns.size(),caseSenseNames?"YES":"NO",matches,
+         oldTime,newTime,newTime>0 ? oldTime/newTime : 0.0);
+  return diffs==0;
+}
+
+int main(int argc,char **argv)
+{
+  size_t count = argc>1 ? static_cast<size_t>(atol(argv[1])) : 100000;
+  Config::init();
+  std::vector<Path> paths = makePaths(count);
+  bool ok = runBench(paths,true);
+  ok = runBench(paths,false) && ok;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,174 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+/** @file
+ *  Compares reg::Ex with and without skipping the positions at which no match
+ *  can start. The variant without is src/regex.cpp compiled with
+ *  REGEX_NO_PREFILTER=1 and its namespace renamed to reg_noprefilter.
+ *  Both must find the same matches.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "regex.h"
+
+#undef FREGEX_H
+#define reg reg_noprefilter
+#include "regex.h"
+#undef reg
+
+struct Pattern
+{
+  const char *pattern;
+  bool wildcard;
+};
+
+// expressions as used in the doxygen sources and some file patterns
+static const std::vector<Pattern> g_patterns =
+{
+  { R"(\a\w*)",                    false },
+  { R"(@\d+)",                     false },
+  { R"([\w:@]*@\d+)",              false },
+  { R"(%[a-z_A-Z]+)",              false },
+  { R"(##[0-9A-Fa-f][0-9A-Fa-f])", false },
+  { R"(&\a\w*;)",                  false },
+  { R"([\\@](\a\w*))",             false },
+  { R"(\s*=\s*)",                  false },
+  { R"(\([^)]*[*^][^)]*\))",       false },
+  { R"([_]x)",                     false },
+  { R"([.])",                      false },
+  { "*.cpp",                       true  },
+  { "*/test/*",                    true  },
+  { "moc_*",                       true  },
+  { "[Tt]est*.c",                  true  },
+};
+
+struct Expected
+{
+  const char *pattern;
+  bool wildcard;
+  const char *str;
+  bool search;
+  bool match;
+};
+
+// single character classes used to never match, see analyse() in regex.cpp
+static const std::vector<Expected> g_expected =
+{
+  { "[_]x",    false, "a_x",     true,  false },
+  { "[_]x",    false, "_x",      true,  true  },
+  { "[.]",     false, "a.b",     true,  false },
+  { "[.]",     false, ".",       true,  true  },
+  { "[a-a]",   false, "bab",     true,  false },
+  { "[a-a]b",  false, "ab",      true,  true  },
+  { "[^a]",    false, "aab",     true,  false },
+  { "*[_]x.h", true,  "foo_x.h", true,  true  },
+  { "[.]*",    true,  ".git",    true,  true  },
+};
+
+static std::vector<std::string> makeLines(size_t count)
+{
+  static const char *lines[] =
+  {
+    "  int foo_%zu = bar(@%zu, x); // see %%Title and &amp; too",
+    "/** \\brief Returns the value of item_x%zu ##%zuF */",
+    "void Class%zu::method(int (*fn)(int), char ^blk) { return; }",
+    "src/module%zu/test/moc_window%zu.cpp",
+    "Test%zu.c = value . @%zu ::ns::name",
+    "    some plain text without special characters %zu %zu",
+  };
+  std::vector<std::string> result;
+  result.reserve(count);
+  char buf[256];
+  for (size_t i=0;i<count;i++)
+  {
+    snprintf(buf,sizeof(buf),lines[i%6],i%97,i%13);
+    result.push_back(buf);
+  }
+  return result;
+}
+
+// returns a checksum of all matches found, so both variants can be compared
+template<class Ex,class Match,class SearchFunc,class MatchFunc>
+static size_t run(const Pattern &pat,const std::vector<std::string> &lines,
+                  SearchFunc search,MatchFunc match,double &time)
+{
+  auto start = std::chrono::steady_clock::now();
+  Ex re(pat.pattern,pat.wildcard ? Ex::Mode::Wildcard : Ex::Mode::RegEx);
+  size_t sum=0;
+  for (const auto &line : lines)
+  {
+    Match m;
+    size_t pos=0;
+    while (pos<line.length() && search(line,m,re,pos))
+    {
+      sum+=m.position()*31+m.length()+1;
+      pos=m.position()+(m.length()>0 ? m.length() : 1);
+    }
+    if (match(line,re)) sum+=7;
+  }
+  time += std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now()-start).count();
+  return sum;
+}
+
+int main(int argc,char **argv)
+{
+  size_t count = argc>1 ? static_cast<size_t>(atol(argv[1])) : 100000;
+  bool ok = true;
+
+  for (const auto &e : g_expected)
+  {
+    reg::Ex re(e.pattern,e.wildcard ? reg::Ex::Mode::Wildcard : reg::Ex::Mode::RegEx);
+    bool s = reg::search(e.str,re);
+    bool m = reg::match(e.str,re);
+    if (s!=e.search || m!=e.match)
+    {
+      fprintf(stderr,"pattern '%s' on '%s': search=%d match=%d, expected search=%d match=%d\n",
+              e.pattern,e.str,s,m,e.search,e.match);
+      ok = false;
+    }
+  }
+
+  std::vector<std::string> lines = makeLines(count);
+  double oldTotal=0, newTotal=0;
+  for (const auto &pat : g_patterns)
+  {
+    double oldTime=0, newTime=0;
+    size_t oldSum = run<reg_noprefilter::Ex,reg_noprefilter::Match>(pat,lines,
+        [](const std::string &s,reg_noprefilter::Match &m,const reg_noprefilter::Ex &re,size_t pos)
+        { return reg_noprefilter::search(s,m,re,pos); },
+        [](const std::string &s,const reg_noprefilter::Ex &re)
+        { return reg_noprefilter::match(s,re); },
+        oldTime);
+    size_t newSum = run<reg::Ex,reg::Match>(pat,lines,
+        [](const std::string &s,reg::Match &m,const reg::Ex &re,size_t pos)
+        { return reg::search(s,m,re,pos); },
+        [](const std::string &s,const reg::Ex &re)
+        { return reg::match(s,re); },
+        newTime);
+    printf("%-28s old %8.1f ms  new %8.1f ms%s\n",pat.pattern,oldTime,newTime,
+           oldSum!=newSum ? "  MISMATCH" : "");
+    if (oldSum!=newSum) ok = false;
+    oldTotal+=oldTime;
+    newTotal+=newTime;
+  }
+  printf("%zu lines, total: old %.1f ms, new %.1f ms (%.1fx)\n",
+         lines.size(),oldTotal,newTotal,newTotal>0 ? oldTotal/newTotal : 0.0);
+  return ok ? 0 : 1;
+}
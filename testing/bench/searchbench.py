@@ -0,0 +1,221 @@
+#!/usr/bin/python
+#
+# Compares the size of the client side search index and the time to load the
+# results of a search between the per letter format and the sharded format
+# (SEARCHENGINE_SHARDED=YES). Doxygen is run twice on a generated project.
+# For a number of search strings the files a browser loads before it can show
+# the first results are determined the way search.js does it. If node is found
+# these files are also evaluated to time them and to check that both formats
+# give the same matches.
+
+from __future__ import print_function
+import argparse, collections, glob, json, os, random, re, shutil, subprocess, sys, time
+
+WORDS = ['buffer','cache','channel','config','context','device','event','file',
+         'handle','index','item','key','layer','link','list','lock','map','node',
+         'object','option','page','path','queue','range','record','region','scope',
+         'socket','state','stream','string','table','task','thread','token','value',
+         'vector','view','widget','window']
+PREFIXES = ['get','set','is','has','create','remove','update','find']
+QUERIES = ['g','get','getbuffer','getbufferlock','s','setwindow','w','widget','x']
+
+# the number of matches search.js shows before it waits for the user to load more
+SHARD_PAGE_SIZE = 500
+
+def write_project(project_dir,num_classes):
+	rnd = random.Random(2021)
+	for n in range(num_classes):
+		name = rnd.choice(WORDS).capitalize()+rnd.choice(WORDS).capitalize()+str(n)
+		with open('%s/%s.h' % (project_dir,name.lower()),'w') as f:
+			print('/** @brief The %s class */' % name, file=f)
+			print('class %s' % name, file=f)
+			print('{', file=f)
+			print('  public:', file=f)
+			for word in rnd.sample(WORDS,8):
+				for prefix in rnd.sample(PREFIXES,3):
+					member = prefix+word.capitalize()+rnd.choice(WORDS).capitalize()
+					print('    /** Calls %s on %s */' % (prefix,word), file=f)
+					print('    int %s();' % member, file=f)
+			print('};', file=f)
+
+def run_doxygen(args,project_dir,out_dir,sharded):
+	os.makedirs(out_dir)
+	with open(out_dir+'/Doxyfile','w') as f:
+		print('QUIET=YES', file=f)
+		print('WARNINGS=NO', file=f)
+		print('INPUT=%s' % project_dir, file=f)
+		print('OUTPUT_DIRECTORY=%s' % out_dir, file=f)
+		print('GENERATE_HTML=YES', file=f)
+		print('GENERATE_LATEX=NO', file=f)
+		print('HAVE_DOT=NO', file=f)
+		print('SEARCHENGINE=YES', file=f)
+		print('SERVER_BASED_SEARCH=NO', file=f)
+		print('SEARCHENGINE_SHARDED=%s' % ('YES' if sharded else 'NO'), file=f)
+	start = time.time()
+	with open(out_dir+'/doxygen.log','w') as out:
+		if subprocess.call([args.doxygen,out_dir+'/Doxyfile'],stdout=out,stderr=out)!=0:
+			print('Error: failed to run %s on %s/Doxyfile' % (args.doxygen,out_dir))
+			sys.exit(1)
+	return time.time()-start
+
+def dir_size(search_dir):
+	files = glob.glob(search_dir+'/*')
+	sizes = [os.path.getsize(f) for f in files]
+	return len(files), sum(sizes), max(sizes)
+
+# returns the first letters per index, as listed in searchdata.js
+def index_letters(search_dir):
+	with open(search_dir+'/searchdata.js') as f:
+		data = f.read()
+	m = re.search(r'var indexSectionsWithContent =\s*(\{.*?\});', data, re.S)
+	return json.loads(re.sub(r'(\d+):', r'"\1":', m.group(1)))['0']
+
+# returns the data files the per letter results page of 'all' loads for query
+def letter_files(search_dir,query):
+	idx = index_letters(search_dir).find(query[0])
+	if idx==-1:
+		return None, []
+	return '%s/all_%x.html' % (search_dir,idx), ['%s/all_%x.js' % (search_dir,idx)]
+
+# returns the shard files the sharded results page of 'all' loads for query,
+# in the order SearchShards() in search.js loads them
+def shard_files(search_dir,query):
+	page = search_dir+'/all_shards.html'
+	with open(page) as f:
+		keys = json.loads(re.search(r'var searchShards = (\[.*?\]);', f.read()).group(1))
+	return page, ['%s/all_s%x.js' % (search_dir,i) for i,key in enumerate(keys)
+	              if key.startswith(query) or query.startswith(key)]
+
+# evaluates the data files like a browser would for query and returns the
+# best time it took, the matching terms and the number of files evaluated
+NODE_SCRIPT = r'''
+var fs = require('fs'), vm = require('vm');
+var req = JSON.parse(process.argv[1]);
+function run()
+{
+  var names = [], loaded = 0, last = null;
+  var ctx = { searchShard: function(files,scopes,terms)
+              {
+                for (var t=0; t<terms.length; t++)
+                {
+                  if (terms[t][0].substr(0,req.query.length)==req.query)
+                  {
+                    // like search.js, a term continued from the previous shard is one match
+                    var key = terms[t][0]+'\n'+terms[t][1];
+                    if (key!=last) names.push(terms[t][1]);
+                    last = key;
+                  }
+                }
+              } };
+  vm.createContext(ctx);
+  for (var i=0; i<req.files.length; i++)
+  {
+    if (req.sharded && names.length>=req.pageSize) break; // search.js waits for the user here
+    vm.runInContext(fs.readFileSync(req.files[i],'utf8'),ctx);
+    loaded++;
+  }
+  if (!req.sharded && ctx.searchData)
+  {
+    var data = vm.runInContext('searchData',ctx);
+    for (var i=0; i<data.length; i++)
+    {
+      var id = data[i][0].replace(/_[0-9]+$/,'');
+      if (id.substr(0,req.query.length)==req.query) names.push(data[i][1][0]);
+    }
+  }
+  return {names: names, loaded: loaded};
+}
+var best = -1, result;
+for (var r=0; r<req.repeat; r++)
+{
+  var start = process.hrtime();
+  result = run();
+  var d = process.hrtime(start);
+  var ms = d[0]*1000+d[1]/1e6;
+  if (best<0 || ms<best) best = ms;
+}
+result.ms = best;
+console.log(JSON.stringify(result));
+'''
+
+def node_eval(node,files,query,sharded,repeat):
+	req = json.dumps({'files':files,'query':query,'sharded':sharded,'pageSize':SHARD_PAGE_SIZE,'repeat':repeat})
+	return json.loads(subprocess.check_output([node,'-e',NODE_SCRIPT,req]).decode('utf-8'))
+
+def find_node():
+	for name in ['node','nodejs']:
+		for d in os.environ.get('PATH','').split(os.pathsep):
+			if os.path.isfile(os.path.join(d,name)):
+				return os.path.join(d,name)
+	return None
+
+def main():
+	parser = argparse.ArgumentParser(description='compare the per letter and sharded search index')
+	parser.add_argument('--doxygen',nargs='?',default='doxygen',help=
+		'path/name of the doxygen executable')
+	parser.add_argument('--outputdir',nargs='?',default='.',help=
+		'output directory to write the doxygen output to')
+	parser.add_argument('--classes',type=int,default=2000,help=
+		'number of classes of the generated project')
+	parser.add_argument('--repeat',type=int,default=5,help=
+		'number of times the files of a search are evaluated, the best time is shown')
+	parser.add_argument('--keep',action='store_true',help=
+		'do not remove the generated project and output')
+	args = parser.parse_args()
+
+	bench_out = os.path.abspath(args.outputdir)+'/bench_output_search'
+	project_dir = bench_out+'/project'
+	shutil.rmtree(bench_out,ignore_errors=True)
+	os.makedirs(project_dir)
+	write_project(project_dir,args.classes)
+
+	letter_dir = bench_out+'/letter'
+	shard_dir = bench_out+'/sharded'
+	letter_time = run_doxygen(args,project_dir,letter_dir,False)
+	shard_time = run_doxygen(args,project_dir,shard_dir,True)
+	letter_search = letter_dir+'/html/search'
+	shard_search = shard_dir+'/html/search'
+
+	print('%d classes, doxygen took %.1fs (per letter) and %.1fs (sharded)' % (args.classes,letter_time,shard_time))
+	print('%-10s %8s %12s %12s' % ('format','files','total bytes','largest'))
+	print('%-10s %8d %12d %12d' % (('per letter',)+dir_size(letter_search)))
+	print('%-10s %8d %12d %12d' % (('sharded',)+dir_size(shard_search)))
+
+	node = find_node()
+	if not node:
+		print('node not found, only the sizes of the loaded files are shown')
+	print('%-16s %12s %12s %10s %10s %8s' % ('search','letter bytes','shard bytes','letter ms','shard ms','matches'))
+	failures = []
+	for query in QUERIES:
+		letter_page, letter_data = letter_files(letter_search,query)
+		shard_page, shard_data = shard_files(shard_search,query)
+		letter_bytes = sum(os.path.getsize(f) for f in letter_data+([letter_page] if letter_page else []))
+		if node:
+			r1 = node_eval(node,letter_data,query,False,args.repeat)
+			r2 = node_eval(node,shard_data,query,True,args.repeat)
+			# only the shards loaded before the first results are shown count
+			shard_bytes = sum(os.path.getsize(f) for f in shard_data[:r2['loaded']]+[shard_page])
+			letter_names = collections.Counter(r1['names'])
+			shard_names = collections.Counter(r2['names'])
+			if r2['loaded']==len(shard_data):
+				same = letter_names==shard_names
+			else: # the other matches are in the shards not loaded yet
+				same = not (shard_names-letter_names)
+			if not same:
+				failures.append('%s: %d matches per letter, %d sharded' % (query,len(r1['names']),len(r2['names'])))
+			print('%-16s %12d %12d %10.2f %10.2f %8d' % (query,letter_bytes,shard_bytes,r1['ms'],r2['ms'],len(r1['names'])))
+		else:
+			shard_bytes = sum(os.path.getsize(f) for f in shard_data+[shard_page])
+			print('%-16s %12d %12d %10s %10s %8s' % (query,letter_bytes,shard_bytes,'-','-','-'))
+
+	if failures:
+		print('Error: the sharded index gives other matches than the per letter index')
+		for msg in failures:
+			print(msg)
+		return 1
+	if not args.keep:
+		shutil.rmtree(bench_out,ignore_errors=True)
+	return 0
+
+if __name__ == '__main__':
+	sys.exit(main())
@@ -0,0 +1,208 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+/** @file
+ *  Compares the heap used to store the string fields of definitions and members
+ *  as QCString and as InternedString (see stringpool.h). The values are taken
+ *  from the function declarations found in the headers and sources of the given
+ *  directories and their direct subdirectories: the name, the scope qualified
+ *  name, the file name and extension, the return type and the argument list.
+ *  Each field is measured in a process of its own, so it starts with an empty
+ *  pool. The fields that DefinitionImpl and MemberDefImpl keep in the pool
+ *  must not use more memory as InternedString than as QCString, and all
+ *  InternedStrings must read back their original value.
+ */
+
+#include <malloc.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <regex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "dir.h"
+#include "fileinfo.h"
+#include "stringpool.h"
+
+struct Field
+{
+  const char *name;
+  bool pooled; // kept in the StringPool by DefinitionImpl or MemberDefImpl
+};
+
+static const Field g_fields[] =
+{
+  { "name",         false },
+  { "localName",    false },
+  { "symbolName",   false },
+  { "defFileName",  true  },
+  { "defFileExt",   true  },
+  { "ref",          true  },
+  { "type",         true  },
+  { "args",         false },
+  { "exception",    true  },
+  { "declFileName", true  },
+};
+static const size_t g_numFields = sizeof(g_fields)/sizeof(g_fields[0]);
+
+using Record = std::vector<std::string>;
+
+static size_t heapInUse()
+{
+  struct mallinfo2 mi = mallinfo2();
+  return mi.uordblks+mi.hblkhd;
+}
+
+static std::string collapseSpaces(const std::string &s)
+{
+  std::string result;
+  bool space=false;
+  for (char c : s)
+  {
+    if (c==' ' || c=='\t' || c=='\n' || c=='\r')
+    {
+      space=!result.empty();
+    }
+    else
+    {
+      if (space) result+=' ';
+      result+=c;
+      space=false;
+    }
+  }
+  return result;
+}
+
+// adds a record for every line of file that looks like a function declaration
+static void scanFile(const std::string &fileName,const std::string &baseName,
+                     const std::string &ext,std::vector<Record> &records)
+{
+  static const std::regex decl(
+      R"(^\s*(?:(?:virtual|static|inline|explicit|extern)\s+)*((?:const\s+)?[A-Za-z_][\w:<>,\s]*?[\s*&]+)([A-Za-z_]\w*)\s*\(([^;{)]*)\))");
+  static const std::unordered_set<std::string> keywords = { "return", "else", "if", "new", "delete" };
+  std::ifstream f(fileName);
+  std::string line;
+  while (std::getline(f,line))
+  {
+    if (line.length()>300 || line.find('(')==std::string::npos) continue;
+    std::smatch m;
+    if (!std::regex_search(line,m,decl)) continue;
+    std::string type = collapseSpaces(m[1].str());
+    size_t sp = type.rfind(' ');
+    if (keywords.find(sp==std::string::npos ? type : type.substr(sp+1))!=keywords.end()) continue;
+    std::string name = m[2].str();
+    records.push_back({ name, name, baseName+"::"+name, fileName, ext, "",
+                        type, "("+collapseSpaces(m[3].str())+")", "", fileName });
+  }
+}
+
+static void scanDir(const std::string &dirName,int depth,std::vector<Record> &records)
+{
+  Dir dir(dirName);
+  for (const auto &entry : dir.iterator())
+  {
+    FileInfo fi(entry.path());
+    if (fi.isDir())
+    {
+      if (depth>0) scanDir(fi.absFilePath(),depth-1,records);
+    }
+    else if (fi.isFile())
+    {
+      std::string ext = fi.extension(false);
+      if (ext=="h" || ext=="cpp" || ext=="c")
+      {
+        scanFile(fi.absFilePath(),fi.baseName(),ext,records);
+      }
+    }
+  }
+}
+
+// measures one field, returns false if the pool did not give back the original strings
+static bool measure(const std::vector<Record> &records,size_t field,size_t &qcBytes,size_t &isBytes)
+{
+  size_t before = heapInUse();
+  std::vector<QCString> qcs;
+  qcs.reserve(records.size());
+  for (const auto &r : records) qcs.push_back(QCString(r[field]));
+  qcBytes = heapInUse()-before;
+
+  before = heapInUse();
+  std::vector<InternedString> iss;
+  iss.reserve(records.size());
+  for (const auto &r : records) iss.push_back(InternedString(QCString(r[field])));
+  isBytes = heapInUse()-before;
+
+  for (size_t i=0;i<records.size();i++)
+  {
+    if (iss[i].str()!=records[i][field]) return false;
+  }
+  return true;
+}
+
+int main(int argc,char **argv)
+{
+  if (argc<2)
+  {
+    printf("usage: %s directory...\n",argv[0]);
+    return 1;
+  }
+  std::vector<Record> records;
+  for (int i=1;i<argc;i++)
+  {
+    scanDir(argv[i],1,records);
+  }
+  if (records.empty())
+  {
+    printf("Error: no declarations found\n");
+    return 1;
+  }
+  printf("%zu declarations\n",records.size());
+  printf("%-13s %9s %12s %15s\n","field","distinct","QCString","InternedString");
+  fflush(stdout);
+
+  bool ok = true;
+  for (size_t field=0;field<g_numFields;field++)
+  {
+    pid_t pid = fork();
+    if (pid==0)
+    {
+      std::unordered_set<std::string> distinct;
+      for (const auto &r : records) distinct.insert(r[field]);
+      size_t qcBytes=0, isBytes=0;
+      bool same = measure(records,field,qcBytes,isBytes);
+      bool smaller = !g_fields[field].pooled || isBytes<=qcBytes;
+      printf("%-13s %9zu %9.2f MB %12.2f MB  (%+.0f%%)%s%s%s\n",
+             g_fields[field].name,distinct.size(),
+             static_cast<double>(qcBytes)/(1024*1024),static_cast<double>(isBytes)/(1024*1024),
+             qcBytes>0 ? 100.0*(static_cast<double>(isBytes)-static_cast<double>(qcBytes))/static_cast<double>(qcBytes) : 0.0,
+             g_fields[field].pooled ? "  pooled" : "",
+             same ? "" : "  MISMATCH",
+             smaller ? "" : "  LARGER");
+      fflush(stdout);
+      _exit(same && smaller ? 0 : 1);
+    }
+    int status=0;
+    if (pid<0 || waitpid(pid,&status,0)!=pid || !WIFEXITED(status) || WEXITSTATUS(status)!=0)
+    {
+      ok = false;
+    }
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2021 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+/** @file
+ *  Compares rendering a template when the structs find their properties by
+ *  comparing the characters of the name, as PropertyMapper in context.cpp did
+ *  before, with finding them by the address of the pooled name that the
+ *  template engine passes. The template lists members like the HTML templates
+ *  do: it uses paths like `m.scope.name`, an if tag, a for loop that unpacks
+ *  the fields of each member and the listsort filter. Both lookups must
+ *  render the same output.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+
+#include <sys/stat.h>
+
+#include "stringpool.h"
+#include "template.h"
+#include "textstream.h"
+
+static std::string g_outDir = "templatebench_output";
+
+static const char *g_template =
+  "{% for m in members %}"
+  "{{ m.scope.name }}::{{ m.name }}{{ m.args }} returns {{ m.type }}"
+  "{% if m.isStatic %} [static]{% endif %}: {{ m.brief }}\n"
+  "{% endfor %}"
+  "{% for name,type,args in members %}{{ type }} {{ name }}{{ args }};\n{% endfor %}"
+  "{% for m in members|listsort:'{{type}} {{name}}' %}{{ m.name }}\n{% endfor %}";
+
+enum Property { Name, Type, Args, IsStatic, Brief, Scope, NumProperties };
+static const char *g_propertyNames[NumProperties] = { "name", "type", "args", "isStatic", "brief", "scope" };
+
+/** @brief Maps property names to their index, by characters and by pooled address */
+class PropertyIndex
+{
+  public:
+    PropertyIndex()
+    {
+      for (int i=0;i<NumProperties;i++)
+      {
+        m_byName.insert(std::make_pair(g_propertyNames[i],i));
+        m_byId.insert(std::make_pair(StringPool::intern(g_propertyNames[i])->c_str(),i));
+      }
+    }
+    int find(const char *name,bool pooled) const
+    {
+      if (pooled)
+      {
+        auto it = m_byId.find(name);
+        return it!=m_byId.end() ? it->second : -1;
+      }
+      auto it = m_byName.find(name);
+      return it!=m_byName.end() ? it->second : -1;
+    }
+
+  private:
+    std::unordered_map<std::string,int> m_byName;
+    std::unordered_map<const char *,int> m_byId;
+};
+
+static bool g_pooled = false;
+
+static const PropertyIndex &propertyIndex()
+{
+  static PropertyIndex index;
+  return index;
+}
+
+/** @brief A member or a scope as seen by the template */
+class BenchStruct : public TemplateStructIntf
+{
+  public:
+    static BenchStruct *alloc() { return new BenchStruct; }
+    void set(Property p,const TemplateVariant &v) { m_values[p] = v; }
+
+    // TemplateStructIntf methods
+    virtual TemplateVariant get(const char *name) const
+    {
+      int i = propertyIndex().find(name,g_pooled);
+      return i!=-1 ? m_values[i] : TemplateVariant();
+    }
+    virtual int addRef() { return ++m_refCount; }
+    virtual int release()
+    {
+      int count = --m_refCount;
+      if (count<=0) delete this;
+      return count;
+    }
+
+  private:
+    BenchStruct() {}
+    TemplateVariant m_values[NumProperties];
+    int m_refCount = 0;
+};
+
+static TemplateList *makeMembers(int numMembers)
+{
+  static const char *types[] = { "int", "void", "const QCString &", "bool", "size_t" };
+  TemplateList *list = TemplateList::alloc();
+  for (int i=0;i<numMembers;i++)
+  {
+    BenchStruct *scope = BenchStruct::alloc();
+    scope->set(Name,QCString("Class")+QCString().setNum(i/20));
+    BenchStruct *member = BenchStruct::alloc();
+    member->set(Name,QCString("member")+QCString().setNum((i*7919)%numMembers));
+    member->set(Type,types[i%5]);
+    member->set(Args,i%3==0 ? "()" : "(int index,const char *name)");
+    member->set(IsStatic,TemplateVariant(i%4==0));
+    member->set(Brief,QCString("Brief description of member ")+QCString().setNum(i));
+    member->set(Scope,scope);
+    list->append(member);
+  }
+  return list;
+}
+
+static std::string render(Template *tpl,TemplateContext *ctx,int numRenders,bool pooled)
+{
+  g_pooled = pooled;
+  std::string result;
+  auto start = std::chrono::steady_clock::now();
+  for (int i=0;i<numRenders;i++)
+  {
+    TextStream t;
+    tpl->render(t,ctx);
+    result = t.str();
+  }
+  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now()-start).count();
+  printf("%-20s %6lld ms for %d renders of %zu bytes\n",
+         pooled ? "pooled address:" : "name characters:",static_cast<long long>(ms),numRenders,result.length());
+  return result;
+}
+
+int main(int argc,char **argv)
+{
+  int numMembers = argc>1 ? atoi(argv[1]) : 2000;
+  int numRenders = argc>2 ? atoi(argv[2]) : 20;
+  if (numMembers<=0 || numRenders<=0)
+  {
+    printf("usage: %s [numMembers [numRenders]]\n",argv[0]);
+    return 1;
+  }
+
+  mkdir(g_outDir.c_str(),0755);
+  {
+    std::ofstream f(g_outDir+"/members.tpl",std::ofstream::out | std::ofstream::binary);
+    f << g_template;
+  }
+
+  TemplateEngine engine;
+  engine.setTemplateDir(g_outDir.c_str());
+  Template *tpl = engine.loadByName("members.tpl",1);
+  if (tpl==0)
+  {
+    printf("Error: could not load %s/members.tpl\n",g_outDir.c_str());
+    return 1;
+  }
+  TemplateContext *ctx = engine.createContext();
+  ctx->set("members",makeMembers(numMembers));
+
+  std::string byName = render(tpl,ctx,numRenders,false);
+  std::string byId   = render(tpl,ctx,numRenders,true);
+
+  engine.destroyContext(ctx);
+  engine.unload(tpl);
+
+  if (byName.find("Class0::member0() returns int [static]: Brief description of member 0\n")!=0)
+  {
+    printf("Error: unexpected output\n%.200s\n",byName.c_str());
+    return 1;
+  }
+  if (byName!=byId)
+  {
+    printf("Error: the output differs between the two lookups\n");
+    return 1;
+  }
+  return 0;
+}
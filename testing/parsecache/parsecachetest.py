@@ -0,0 +1,92 @@
+#!/usr/bin/python
+#
+# Runs doxygen with a PARSE_CACHE_DIR a number of times and checks which input
+# files are parsed again: none when nothing changed, the file including a
+# header that was edited, and the file including a header that did not exist
+# before.
+
+from __future__ import print_function
+import argparse, os, re, shutil, subprocess, sys
+
+INPUT_FILES = {
+	'a.h': '#include "b.h"\n/** A class using B */\nclass A { B b; };\n',
+	'c.h': '#include "missing.h"\n/** A class that may use Missing */\nclass C {};\n',
+	'd.h': '/** A class without includes */\nclass D {};\n',
+}
+
+def write_file(name,contents):
+	with open(name,'w') as f:
+		f.write(contents)
+
+def write_input(test_out):
+	os.makedirs(test_out+'/src')
+	os.makedirs(test_out+'/inc')
+	for name, contents in INPUT_FILES.items():
+		write_file(test_out+'/src/'+name,contents)
+	write_file(test_out+'/inc/b.h','/** B */\nclass B {};\n')
+	with open(test_out+'/Doxyfile','w') as f:
+		print('QUIET=NO', file=f)
+		print('INPUT=%s/src' % test_out, file=f)
+		print('INCLUDE_PATH=%s/inc' % test_out, file=f)
+		print('OUTPUT_DIRECTORY=%s/out' % test_out, file=f)
+		print('PARSE_CACHE_DIR=%s/cache' % test_out, file=f)
+		print('GENERATE_HTML=NO', file=f)
+		print('GENERATE_LATEX=NO', file=f)
+		print('GENERATE_XML=YES', file=f)
+
+# runs doxygen and returns the names of the input files that were parsed
+def run_doxygen(args,test_out):
+	with open(test_out+'/doxygen.log','w') as out:
+		if subprocess.call([args.doxygen,test_out+'/Doxyfile'],stdout=out,stderr=out)!=0:
+			print('Error: failed to run %s on %s/Doxyfile' % (args.doxygen,test_out))
+			sys.exit(1)
+	parsed = []
+	restored = []
+	with open(test_out+'/doxygen.log') as f:
+		for line in f:
+			m = re.match(r'(Preprocessing|Restoring) (.*?)(?: from parse cache)?\.\.\.$', line.rstrip())
+			if m:
+				(parsed if m.group(1)=='Preprocessing' else restored).append(os.path.basename(m.group(2)))
+	if sorted(parsed+restored)!=sorted(INPUT_FILES):
+		print('Error: expected each of %s to be parsed or restored, got %s and %s' %
+		      (sorted(INPUT_FILES),parsed,restored))
+		sys.exit(1)
+	return sorted(parsed)
+
+def main():
+	parser = argparse.ArgumentParser(description='run the parse cache test')
+	parser.add_argument('--doxygen',nargs='?',default='doxygen',help=
+		'path/name of the doxygen executable')
+	parser.add_argument('--outputdir',nargs='?',default='.',help=
+		'output directory to write the doxygen output to')
+	args = parser.parse_args()
+
+	test_out = os.path.abspath(args.outputdir)+'/test_output_parsecache'
+	shutil.rmtree(test_out,ignore_errors=True)
+	write_input(test_out)
+
+	failures = []
+	def check(step,expected):
+		parsed = run_doxygen(args,test_out)
+		if parsed!=expected:
+			failures.append('%s: expected %s to be parsed, got %s' % (step,expected,parsed))
+
+	check('first run',sorted(INPUT_FILES))
+	check('unchanged input',[])
+	write_file(test_out+'/inc/b.h','/** B, edited */\nclass B { int x; };\n')
+	check('edited include file',['a.h'])
+	write_file(test_out+'/inc/missing.h','/** Missing */\nclass Missing {};\n')
+	check('include file that appeared',['c.h'])
+	check('unchanged input after the changes',[])
+
+	if failures:
+		print('not ok - parse cache')
+		for msg in failures:
+			print(msg)
+		return 1
+	print('ok - parse cache')
+	shutil.rmtree(test_out,ignore_errors=True)
+	return 0
+
+if __name__ == '__main__':
+	sys.exit(main())
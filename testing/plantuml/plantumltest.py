@@ -0,0 +1,98 @@
+#!/usr/bin/python
+#
+# Runs doxygen with the java stub in this directory in place of PlantUML, and
+# checks which diagrams are rendered: all of them on the first run, none on a
+# second run of the same input, and only the deleted image after one of the
+# images has been removed.
+
+from __future__ import print_function
+import argparse, glob, os, shutil, subprocess, sys
+
+def write_config(args,test_out,stub_dir):
+	with open(test_out+'/Doxyfile','w') as f:
+		print('QUIET=YES', file=f)
+		print('INPUT=%s/plantuml.dox' % args.inputdir, file=f)
+		print('OUTPUT_DIRECTORY=%s' % test_out, file=f)
+		print('GENERATE_HTML=YES', file=f)
+		print('GENERATE_LATEX=NO', file=f)
+		print('GENERATE_XML=NO', file=f)
+		print('DOT_IMAGE_FORMAT=png', file=f)
+		print('PLANTUML_JAR_PATH=%s' % stub_dir, file=f)
+
+def make_stub(args,stub_dir):
+	os.mkdir(stub_dir)
+	# doxygen checks that the jar file exists, the stub does not read it
+	open(stub_dir+'/plantuml.jar','w').close()
+	with open(args.inputdir+'/java') as f:
+		lines = f.readlines()
+	lines[0] = '#!%s\n' % sys.executable
+	with open(stub_dir+'/java','w') as f:
+		f.writelines(lines)
+	os.chmod(stub_dir+'/java',0o755)
+
+# runs doxygen and returns the names of the diagrams that were rendered
+def run_doxygen(args,test_out,stub_dir):
+	log = test_out+'/rendered.log'
+	open(log,'w').close()
+	env = dict(os.environ)
+	env['PATH'] = stub_dir+os.pathsep+env.get('PATH','')
+	env['PLANTUML_STUB_LOG'] = log
+	with open(test_out+'/doxygen.log','w') as out:
+		if subprocess.call([args.doxygen,test_out+'/Doxyfile'],env=env,stdout=out,stderr=out)!=0:
+			print('Error: failed to run %s on %s/Doxyfile' % (args.doxygen,test_out))
+			sys.exit(1)
+	with open(log) as f:
+		return sorted(line.strip() for line in f if line.strip())
+
+def images(test_out):
+	return sorted(os.path.basename(f) for f in glob.glob(test_out+'/html/inline_umlgraph_*.png'))
+
+def main():
+	parser = argparse.ArgumentParser(description='run the PlantUML test')
+	parser.add_argument('--doxygen',nargs='?',default='doxygen',help=
+		'path/name of the doxygen executable')
+	parser.add_argument('--inputdir',nargs='?',default=os.path.dirname(os.path.abspath(__file__)),help=
+		'directory containing this test')
+	parser.add_argument('--outputdir',nargs='?',default='.',help=
+		'output directory to write the doxygen output to')
+	args = parser.parse_args()
+	args.inputdir = os.path.abspath(args.inputdir)
+
+	if sys.platform == 'win32':
+		print('ok - PlantUML test skipped, the java stub needs a POSIX shell')
+		return 0
+
+	test_out = os.path.abspath(args.outputdir)+'/test_output_plantuml'
+	stub_dir = test_out+'/stub'
+	shutil.rmtree(test_out,ignore_errors=True)
+	os.makedirs(test_out)
+	make_stub(args,stub_dir)
+	write_config(args,test_out,stub_dir)
+
+	failures = []
+	rendered = run_doxygen(args,test_out,stub_dir)
+	if len(rendered)!=3 or rendered!=images(test_out):
+		failures.append('first run: expected 3 rendered images, got %s, files %s' % (rendered,images(test_out)))
+
+	rendered = run_doxygen(args,test_out,stub_dir)
+	if rendered:
+		failures.append('second run: expected all images from the cache, but rendered %s' % rendered)
+
+	removed = images(test_out)[1:2]
+	for name in removed:
+		os.remove(test_out+'/html/'+name)
+	rendered = run_doxygen(args,test_out,stub_dir)
+	if not removed or rendered!=removed or len(images(test_out))!=3:
+		failures.append('third run: expected only %s to be rendered again, got %s' % (removed,rendered))
+
+	if failures:
+		print('not ok - PlantUML images are cached between runs')
+		for msg in failures:
+			print(msg)
+		return 1
+	print('ok - PlantUML images are cached between runs')
+	shutil.rmtree(test_out,ignore_errors=True)
+	return 0
+
+if __name__ == '__main__':
+	sys.exit(main())
@@ -129,43 +129,40 @@ class Tester:
 					config.setdefault(key, []).append(value)
 		return config
 
-	def prepare_test(self):
-		# prepare test environment
-		shutil.rmtree(self.test_out,ignore_errors=True)
-		os.mkdir(self.test_out)
-		shutil.copy(self.args.inputdir+'/Doxyfile',self.test_out)
-		with xopen(self.test_out+'/Doxyfile','a') as f:
+	def write_config(self,test_out,num_threads=None):
+		shutil.copy(self.args.inputdir+'/Doxyfile',test_out)
+		with xopen(test_out+'/Doxyfile','a') as f:
 			print('INPUT=%s/%s' % (self.args.inputdir,self.test), file=f)
 			print('STRIP_FROM_PATH=%s' % self.args.inputdir, file=f)
 			print('EXAMPLE_PATH=%s' % self.args.inputdir, file=f)
-			print('WARN_LOGFILE=%s/warnings.log' % self.test_out, file=f)
+			print('WARN_LOGFILE=%s/warnings.log' % test_out, file=f)
 			if 'config' in self.config:
 				for option in self.config['config']:
 					print(option, file=f)
-			if (self.args.xml or self.args.xmlxsd):
+			if (self.args.xml or self.args.xmlxsd or self.args.threads):
 				print('GENERATE_XML=YES', file=f)
-				print('XML_OUTPUT=%s/out' % self.test_out, file=f)
+				print('XML_OUTPUT=%s/out' % test_out, file=f)
 			else:
 				print('GENERATE_XML=NO', file=f)
-			if (self.args.rtf):
+			if (self.args.rtf or self.args.threads):
 				print('GENERATE_RTF=YES', file=f)
-				print('RTF_OUTPUT=%s/rtf' % self.test_out, file=f)
+				print('RTF_OUTPUT=%s/rtf' % test_out, file=f)
 			else:
 				print('GENERATE_RTF=NO', file=f)
-			if (self.args.docbook):
+			if (self.args.docbook or self.args.threads):
 				print('GENERATE_DOCBOOK=YES', file=f)
-				print('DOCBOOK_OUTPUT=%s/docbook' % self.test_out, file=f)
+				print('DOCBOOK_OUTPUT=%s/docbook' % test_out, file=f)
 			else:
 				print('GENERATE_DOCBOOK=NO', file=f)
-			if (self.args.xhtml):
+			if (self.args.xhtml or self.args.threads):
 				print('GENERATE_HTML=YES', file=f)
 			# HTML_OUTPUT can also have been set locally
-			print('HTML_OUTPUT=%s/html' % self.test_out, file=f)
+			print('HTML_OUTPUT=%s/html' % test_out, file=f)
 			print('HTML_FILE_EXTENSION=.xhtml', file=f)
-			if (self.args.pdf):
+			if (self.args.pdf or self.args.threads):
 				print('GENERATE_LATEX=YES', file=f)
 				print('LATEX_BATCHMODE=YES', file=f)
-				print('LATEX_OUTPUT=%s/latex' % self.test_out, file=f)
+				print('LATEX_OUTPUT=%s/latex' % test_out, file=f)
 			if self.args.subdirs:
 				print('CREATE_SUBDIRS=YES', file=f)
 			if (self.args.clang):
@@ -176,12 +173,10 @@ class Tester:
 						print("Not a doxygen configuration item, missing '=' sign: '%s'."%cfg)
 						sys.exit(1)
 					print(cfg[0], file=f)
+			if num_threads:
+				print('NUM_PROC_THREADS=%d' % num_threads, file=f)
 
-		if 'check' not in self.config or not self.config['check']:
-			print('Test doesn\'t specify any files to check')
-			sys.exit(1)
-
-		# run doxygen
+	def run_doxygen(self,test_out):
 		if (sys.platform == 'win32'):
 			redir=' > nul: 2>&1'
 		else:
@@ -190,10 +185,61 @@ class Tester:
 		if (self.args.noredir):
 			redir=''
 
-		if os.system('%s %s/Doxyfile %s' % (self.args.doxygen,self.test_out,redir))!=0:
-			print('Error: failed to run %s on %s/Doxyfile' % (self.args.doxygen,self.test_out))
+		if self.args.threads:
+			# the date written in the output should be the same for both runs
+			os.environ['SOURCE_DATE_EPOCH'] = os.getenv('SOURCE_DATE_EPOCH','1000000000')
+
+		if os.system('%s %s/Doxyfile %s' % (self.args.doxygen,test_out,redir))!=0:
+			print('Error: failed to run %s on %s/Doxyfile' % (self.args.doxygen,test_out))
+			sys.exit(1)
+
+	def prepare_test(self):
+		# prepare test environment
+		shutil.rmtree(self.test_out,ignore_errors=True)
+		os.mkdir(self.test_out)
+		self.write_config(self.test_out,1 if self.args.threads else None)
+
+		if 'check' not in self.config or not self.config['check']:
+			print('Test doesn\'t specify any files to check')
 			sys.exit(1)
 
+		# run doxygen
+		self.run_doxygen(self.test_out)
+
+		# run doxygen again using multiple threads, to compare the output with the single threaded run
+		if self.args.threads:
+			threads_out = self.test_out+'/threads'
+			os.mkdir(threads_out)
+			self.write_config(threads_out,self.args.threads)
+			self.run_doxygen(threads_out)
+
+	# compare all files written by the single threaded run with those of the multi-threaded run
+	def compare_threads(self):
+		msg = ()
+		threads_out = self.test_out+'/threads'
+		for subdir in ('out','html','latex','rtf','docbook'):
+			single_dir = '%s/%s' % (self.test_out,subdir)
+			multi_dir  = '%s/%s' % (threads_out,subdir)
+			for root, dirs, files in os.walk(single_dir):
+				for name in sorted(files):
+					single_file = os.path.join(root,name)
+					multi_file  = os.path.join(multi_dir,os.path.relpath(single_file,single_dir))
+					if not os.path.isfile(multi_file):
+						msg += ('%s not generated with %d threads' % (multi_file,self.args.threads),)
+						continue
+					with open(single_file,'rb') as f1, open(multi_file,'rb') as f2:
+						if f1.read()==f2.read():
+							continue
+					diff = xpopen('diff -u %s %s' % (single_file,multi_file))
+					msg += ('Difference between output with 1 and with %d threads:\n%s' % (self.args.threads,diff),)
+			for root, dirs, files in os.walk(multi_dir):
+				for name in files:
+					multi_file  = os.path.join(root,name)
+					single_file = os.path.join(single_dir,os.path.relpath(multi_file,multi_dir))
+					if not os.path.isfile(single_file):
+						msg += ('%s only generated with %d threads' % (multi_file,self.args.threads),)
+		return msg
+
 	# update the reference data for this test
 	def update_test(self,testmgr):
 		print('Updating reference for %s' % self.test_name)
@@ -238,7 +284,12 @@ class Tester:
 		failed_docbook=False
 		failed_rtf=False
 		failed_xmlxsd=False
+		failed_threads=False
 		msg = ()
+		# compare with the multi-threaded run before the output directories are cleaned up
+		if (self.args.threads):
+			msg += self.compare_threads()
+			failed_threads = len(msg)!=0
 		# look for files to check against the reference
 		if self.args.xml or self.args.xmlxsd:
 			failed_xml=False
@@ -434,7 +485,7 @@ class Tester:
 		if failed_warn:
 			msg += (warnings,)
 
-		if failed_warn or failed_xml or failed_html or failed_latex or failed_docbook or failed_rtf or failed_xmlxsd:
+		if failed_warn or failed_xml or failed_html or failed_latex or failed_docbook or failed_rtf or failed_xmlxsd or failed_threads:
 			testmgr.ok(False,self.test_name,msg)
 			return False
 
@@ -567,6 +618,9 @@ def main():
 	parser.add_argument('--cfg',nargs='+',dest='cfgs',action='append',help=
 		'run test with extra doxygen configuration settings '
 		'(the option may be specified multiple times')
+	parser.add_argument('--threads',nargs='?',default=0,const=4,type=int,help=
+		'run each test also with NUM_PROC_THREADS set to the given number (4 by default) '
+		'and check that all output formats are identical to those of a single threaded run')
 
 	test_flags = split_and_keep(os.getenv('TEST_FLAGS', default=''), '--')
 
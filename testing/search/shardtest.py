@@ -0,0 +1,157 @@
+#!/usr/bin/python
+#
+# Runs doxygen with SEARCHENGINE_SHARDED=YES on a header with more functions
+# starting with the same prefix than fit in one shard, and with one function
+# that has more overloads than fit in one shard. It checks the search
+# directory: a _shards results page per index listing the shard keys, one
+# shard file per key holding only terms starting with that key, and no files
+# of the per letter format.
+
+from __future__ import print_function
+import argparse, glob, json, os, re, shutil, subprocess, sys
+
+# the maximum number of terms and bytes of a shard, see g_maxShardTerms and
+# g_maxShardBytes in src/searchindex.cpp
+MAX_SHARD_TERMS = 500
+MAX_SHARD_BYTES = 64*1024
+NUM_FUNCTIONS = 1200
+NUM_OVERLOADS = 2000
+
+def write_input(test_out):
+	with open(test_out+'/shards.h','w') as f:
+		print('/** @file */', file=f)
+		print('/** A class */', file=f)
+		print('class Shards {};', file=f)
+		for i in range(NUM_FUNCTIONS):
+			print('/** Returns value %d */' % i, file=f)
+			print('int getValue%04d();' % i, file=f)
+		print('/** An argument type */', file=f)
+		print('template<int N> struct Arg {};', file=f)
+		for i in range(NUM_OVERLOADS):
+			print('/** Overload %d */' % i, file=f)
+			print('void overloaded(const Arg<%d> &arg);' % i, file=f)
+
+def write_config(test_out):
+	with open(test_out+'/Doxyfile','w') as f:
+		print('QUIET=YES', file=f)
+		print('INPUT=%s/shards.h' % test_out, file=f)
+		print('OUTPUT_DIRECTORY=%s' % test_out, file=f)
+		print('GENERATE_HTML=YES', file=f)
+		print('GENERATE_LATEX=NO', file=f)
+		print('GENERATE_XML=NO', file=f)
+		print('HAVE_DOT=NO', file=f)
+		print('SEARCHENGINE=YES', file=f)
+		print('SERVER_BASED_SEARCH=NO', file=f)
+		print('SEARCHENGINE_SHARDED=YES', file=f)
+
+# returns the shard keys listed by a _shards results page
+def read_keys(page):
+	with open(page) as f:
+		m = re.search(r'var searchShards = (\[.*?\]);', f.read())
+	return json.loads(m.group(1)) if m else None
+
+# returns the terms of a shard file: searchShard(files,scopes,terms);
+# a term whose links continue in the next shard is returned in both shards
+def read_terms(shard):
+	with open(shard) as f:
+		data = f.read()
+	if not data.startswith('searchShard(') or not data.rstrip().endswith(');'):
+		return None
+	files, scopes, terms = json.loads('['+data[len('searchShard('):data.rstrip().rfind(');')]+']')
+	for term in terms:
+		for l in range(2,len(term),4):
+			if term[l]>=len(files) or term[l+3]>=len(scopes):
+				return None
+	return terms
+
+def check_index(search_dir,name,failures):
+	keys = read_keys(search_dir+'/'+name+'_shards.html')
+	if keys is None:
+		failures.append('%s_shards.html is missing or does not list the shard keys' % name)
+		return []
+	if keys!=sorted(keys):
+		failures.append('%s: the shard keys are not sorted: %s' % (name,keys))
+	shard_files = glob.glob(search_dir+'/'+name+'_s*.js')
+	if len(shard_files)!=len(keys):
+		failures.append('%s: %d shard keys but %d shard files' % (name,len(keys),len(shard_files)))
+	all_terms = []
+	links = {}
+	for i,key in enumerate(keys):
+		shard = '%s/%s_s%x.js' % (search_dir,name,i)
+		terms = read_terms(shard) if os.path.exists(shard) else None
+		if not terms:
+			failures.append('%s is missing, empty or not a searchShard() call' % shard)
+			continue
+		wrong = [t[0] for t in terms if not t[0].startswith(key)]
+		if wrong:
+			failures.append('%s: terms %s do not start with the key "%s"' % (shard,wrong[:3],key))
+		if len(terms)>MAX_SHARD_TERMS and len(set(t[0] for t in terms))>1:
+			failures.append('%s: %d terms, more than the maximum of %d' % (shard,len(terms),MAX_SHARD_TERMS))
+		size = os.path.getsize(shard)
+		if size>MAX_SHARD_BYTES and sum((len(t)-2)//4 for t in terms)>1:
+			failures.append('%s: %d bytes, more than the maximum of %d' % (shard,size,MAX_SHARD_BYTES))
+		for t in terms:
+			# a term continued from the previous shard is counted once
+			if not all_terms or all_terms[-1]!=(t[0],t[1]):
+				all_terms.append((t[0],t[1]))
+			links[(t[0],t[1])] = links.get((t[0],t[1]),0)+(len(t)-2)//4
+	ids = [t[0] for t in all_terms]
+	if ids!=sorted(ids) or len(all_terms)!=len(links):
+		failures.append('%s: the terms are not sorted over the shards' % name)
+	return ids, links
+
+def main():
+	parser = argparse.ArgumentParser(description='run the sharded search index test')
+	parser.add_argument('--doxygen',nargs='?',default='doxygen',help=
+		'path/name of the doxygen executable')
+	parser.add_argument('--outputdir',nargs='?',default='.',help=
+		'output directory to write the doxygen output to')
+	args = parser.parse_args()
+
+	test_out = os.path.abspath(args.outputdir)+'/test_output_search'
+	shutil.rmtree(test_out,ignore_errors=True)
+	os.makedirs(test_out)
+	write_input(test_out)
+	write_config(test_out)
+	with open(test_out+'/doxygen.log','w') as out:
+		if subprocess.call([args.doxygen,test_out+'/Doxyfile'],stdout=out,stderr=out)!=0:
+			print('Error: failed to run %s on %s/Doxyfile' % (args.doxygen,test_out))
+			return 1
+
+	failures = []
+	search_dir = test_out+'/html/search'
+	with open(search_dir+'/searchdata.js') as f:
+		if 'var indexSectionsSharded = true;' not in f.read():
+			failures.append('searchdata.js does not mark the index as sharded')
+	letter_files = glob.glob(search_dir+'/all_[0-9a-f].js')+glob.glob(search_dir+'/all_[0-9a-f].html')
+	if letter_files:
+		failures.append('files of the per letter format were written: %s' % letter_files)
+
+	terms, links = check_index(search_dir,'all',failures)
+	terms = set(terms)
+	missing = ['getvalue%04d' % i for i in range(NUM_FUNCTIONS) if 'getvalue%04d' % i not in terms]
+	if missing or 'shards' not in terms:
+		failures.append('all: terms missing from the shards: %s' % (missing[:3] or ['shards']))
+	if len(read_keys(search_dir+'/all_shards.html') or [])<3:
+		failures.append('all: expected the functions to be split over several shards')
+	functions, links = check_index(search_dir,'functions',failures)
+	if len(functions)!=NUM_FUNCTIONS+1:
+		failures.append('functions: expected %d terms, got %d' % (NUM_FUNCTIONS+1,len(functions)))
+	if links.get(('overloaded','overloaded'),0)!=NUM_OVERLOADS:
+		failures.append('functions: expected %d links for overloaded, got %d' % (NUM_OVERLOADS,links.get(('overloaded','overloaded'),0)))
+	overloaded_keys = [k for k in read_keys(search_dir+'/functions_shards.html') or [] if 'overloaded'.startswith(k)]
+	if len(overloaded_keys)<2:
+		failures.append('functions: expected the overloads to be split over several shards')
+	check_index(search_dir,'classes',failures)
+
+	if failures:
+		print('not ok - sharded search index')
+		for msg in failures:
+			print(msg)
+		return 1
+	print('ok - sharded search index')
+	shutil.rmtree(test_out,ignore_errors=True)
+	return 0
+
+if __name__ == '__main__':
+	sys.exit(main())